@@ -0,0 +1,9 @@
+# Follow, the model of the old MyMainOld.cpp: head motion becomes cursor motion, steps below the threshold are dropped.
+# The threshold is per pose, so it suits tracker-rate streams (about 90 Hz).
+# Load with --profile profiles/follow.profile; see StrategySettings.h for the keys.
+
+[strategy]
+mode = follow
+sens = 15				# counts per degree
+ysensmult = 0.25
+threshold = 10			# counts, per axis
@@ -0,0 +1,8 @@
+# Hold, the model of the old 3P.cpp: the cursor follows the head only while Left Alt is held and returns on release.
+# Load with --profile profiles/hold.profile; see StrategySettings.h for the keys.
+
+[strategy]
+mode = hold
+sens = 15				# counts per degree
+ysensmult = 0.25
+pitch = off				# 3P.cpp only turned horizontally
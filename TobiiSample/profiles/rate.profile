@@ -0,0 +1,11 @@
+# Rate control, the model of the old MyMain.cpp: the head angle beyond a radial deadzone sets the cursor speed.
+# Load with --profile profiles/rate.profile; see StrategySettings.h for the keys.
+
+[strategy]
+mode = rate
+speed.yaw = 200			# counts per second per degree beyond the deadzone
+speed.pitch = 50
+deadzone = 20			# degrees, of the combined yaw/pitch angle
+maxspeed = 10000		# counts per second per axis
+step = 1				# milliseconds; integrated on the pose timestamps, not the loop's clock
+catchup = 100			# at most this many milliseconds of a gap between poses are made up
@@ -0,0 +1,27 @@
+# Squad, 3200x2000 resolution, 1000 DPI mouse. Same mapping as the constants in SquadTuning.h.
+# Load with --profile profiles/squad.profile; see ResponseCurve.h for the format.
+
+[yaw]
+shape = linear
+deadzone = 7.5
+limit = 29.1667		# 650 counts / gain + deadzone
+gain = 30
+
+# Other shapes for the same range:
+#   shape = scurve
+#   steepness = 1.6
+#
+#   shape = exponential
+#   gain = 10
+#   rate = 0.15
+#
+#   shape = points
+#   gain = 1
+#   points = 0:0, 5:60, 12:300, 21.6667:650
+
+# Pitch is off like ENABLE_PITCH 0. To turn it on:
+# [pitch]
+# shape = linear
+# deadzone = 7.5
+# limit = 20.8333		# 100 counts / gain + deadzone
+# gain = 7.5
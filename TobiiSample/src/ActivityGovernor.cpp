@@ -0,0 +1,163 @@
+#include "ActivityGovernor.h"
+#include <cmath>
+
+#ifdef _WIN32
+#include "windows.h"
+#else
+#include <ctime>
+#endif
+
+using namespace TobiiGameIntegration;
+
+int64_t ProcessCpuMicroSeconds()
+{
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+	{
+		return 0;
+	}
+	const auto toMicroSeconds = [](const FILETIME& time)
+	{
+		return static_cast<int64_t>((static_cast<uint64_t>(time.dwHighDateTime) << 32 | time.dwLowDateTime) / 10);
+	};
+	return toMicroSeconds(kernel) + toMicroSeconds(user);
+#else
+	timespec time;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+	return static_cast<int64_t>(time.tv_sec) * 1'000'000 + time.tv_nsec / 1000;
+#endif
+}
+
+const char* GetActivityStageName(ActivityStage stage)
+{
+	switch (stage)
+	{
+	case ActivityStage::Active:
+		return "active";
+	case ActivityStage::Still:
+		return "still";
+	default:
+		return "absent";
+	}
+}
+
+ActivityGovernor::ActivityGovernor(const ActivitySettings& settings)
+	: m_settings{ settings }
+{ }
+
+void ActivityGovernor::ConfigureStreams(IStreamsProvider* streamsProvider) const
+{
+	for (int stream = 0; stream < static_cast<int>(StreamType::Count); stream++)
+	{
+		if (static_cast<StreamType>(stream) != StreamType::Presence)
+		{
+			streamsProvider->SetAutoUnsubscribe(static_cast<StreamType>(stream), m_settings.UnsubscribeSeconds);
+		}
+	}
+}
+
+double ActivityGovernor::GetRateHz() const
+{
+	switch (m_stage)
+	{
+	case ActivityStage::Active:
+		return m_settings.ActiveRateHz;
+	case ActivityStage::Still:
+		return m_settings.StillRateHz;
+	default:
+		return m_settings.AbsentRateHz;
+	}
+}
+
+void ActivityGovernor::Enter(ActivityStage stage, int64_t nowMicroSeconds)
+{
+	const int64_t cpu = ProcessCpuMicroSeconds();
+	if (m_stageStart >= 0)
+	{
+		ActivityStageStats& stats = m_stats[static_cast<int>(m_stage)];
+		stats.MicroSeconds += nowMicroSeconds - m_stageStart;
+		stats.CpuMicroSeconds += cpu - m_stageCpuStart;
+	}
+	m_stage = stage;
+	m_stageStart = nowMicroSeconds;
+	m_stageCpuStart = cpu;
+	m_stats[static_cast<int>(stage)].Entered++;
+}
+
+bool ActivityGovernor::Advance(int64_t nowMicroSeconds, bool isPresent, const HeadPose* latestHeadPose, bool outputHeld)
+{
+	if (m_stageStart < 0)
+	{
+		Enter(ActivityStage::Active, nowMicroSeconds);
+		m_lastMotion = nowMicroSeconds;
+		m_lastPresent = nowMicroSeconds;
+	}
+	m_stats[static_cast<int>(m_stage)].WakeUps++;
+
+	if (isPresent)
+	{
+		m_lastPresent = nowMicroSeconds;
+	}
+	if (latestHeadPose != nullptr &&
+		(std::abs(latestHeadPose->Rotation.YawDegrees - m_referenceYaw) > m_settings.StillDegrees ||
+		std::abs(latestHeadPose->Rotation.PitchDegrees - m_referencePitch) > m_settings.StillDegrees))
+	{
+		m_referenceYaw = latestHeadPose->Rotation.YawDegrees;
+		m_referencePitch = latestHeadPose->Rotation.PitchDegrees;
+		m_lastMotion = nowMicroSeconds;
+	}
+
+	ActivityStage stage;
+	if (!isPresent && nowMicroSeconds - m_lastPresent >= static_cast<int64_t>(m_settings.AbsentSeconds * 1e6))
+	{
+		stage = ActivityStage::Absent;
+	}
+	else if (outputHeld || nowMicroSeconds - m_lastMotion >= static_cast<int64_t>(m_settings.StillSeconds * 1e6))
+	{
+		stage = ActivityStage::Still;
+		// Back from Absent the head hasn't "moved" yet, but there is no pose to compare against either
+		if (m_stage == ActivityStage::Absent && isPresent && !outputHeld)
+		{
+			stage = ActivityStage::Active;
+			m_lastMotion = nowMicroSeconds;
+		}
+	}
+	else
+	{
+		stage = ActivityStage::Active;
+	}
+
+	if (stage == m_stage)
+	{
+		return false;
+	}
+	Enter(stage, nowMicroSeconds);
+	return true;
+}
+
+void ActivityGovernor::Finish(int64_t nowMicroSeconds)
+{
+	if (m_stageStart >= 0)
+	{
+		Enter(m_stage, nowMicroSeconds);
+		m_stats[static_cast<int>(m_stage)].Entered--;
+	}
+}
+
+void ActivityGovernor::Print(std::ostream& out) const
+{
+	out << "Polling stages:" << std::endl;
+	for (int i = 0; i < static_cast<int>(ActivityStage::Count); i++)
+	{
+		const ActivityStageStats& stats = m_stats[i];
+		const double seconds = stats.MicroSeconds / 1e6;
+		out << "  " << GetActivityStageName(static_cast<ActivityStage>(i)) << ": entered " << stats.Entered << "x, " << seconds << " s, " <<
+			stats.WakeUps << " wake-ups, CPU " << stats.CpuMicroSeconds / 1000 << " ms";
+		if (seconds > 0.0)
+		{
+			out << " (" << 100.0 * stats.CpuMicroSeconds / stats.MicroSeconds << "% of a core, " << stats.WakeUps / seconds << " wake-ups/s)";
+		}
+		out << std::endl;
+	}
+}
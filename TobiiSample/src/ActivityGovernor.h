@@ -0,0 +1,80 @@
+#pragma once
+
+#include "TobiiPlatform.h"
+#include <cstdint>
+#include <ostream>
+
+// Polling rate stages, from busiest to idlest.
+enum class ActivityStage
+{
+	Active,		// head moving: full rate
+	Still,		// present but the head hasn't moved for a while, or output is held back
+	Absent,		// nobody in front of the tracker: head poses aren't even read
+	Count
+};
+
+struct ActivitySettings
+{
+	double ActiveRateHz = 1000.0;
+	double StillRateHz = 100.0;
+	double AbsentRateHz = 10.0;
+
+	float StillSeconds = 5.0f;		// no motion for this long -> Still
+	float StillDegrees = 0.5f;		// yaw or pitch change that counts as motion
+	float AbsentSeconds = 1.0f;		// presence lost for this long -> Absent
+	// Streams that aren't read for this long are unsubscribed by the API and resubscribed when read again.
+	// Head is only left unread while Absent.
+	float UnsubscribeSeconds = 2.0f;
+};
+
+struct ActivityStageStats
+{
+	int64_t MicroSeconds = 0;		// wall time spent in the stage
+	int64_t CpuMicroSeconds = 0;	// process CPU time (all threads) spent meanwhile
+	uint64_t WakeUps = 0;			// ticks of the governed loop
+	uint64_t Entered = 0;
+};
+
+// Lowers the tracker polling rate in stages when presence drops or the head stops moving, and goes back
+// to the full rate on the first tick that sees presence or motion again. Used by the thread that owns
+// the API, once per tick after Update().
+class ActivityGovernor
+{
+public:
+	explicit ActivityGovernor(const ActivitySettings& settings);
+
+	// Sets auto-unsubscribe on every stream except Presence, which the governor keeps polling.
+	void ConfigureStreams(TobiiGameIntegration::IStreamsProvider* streamsProvider) const;
+
+	// latestHeadPose: the newest pose read this tick, nullptr if none.
+	// outputHeld: mouse output is blocked anyway (menu, pause), so full rate buys nothing.
+	// Returns true when the stage, and so GetRateHz(), changed.
+	bool Advance(int64_t nowMicroSeconds, bool isPresent, const TobiiGameIntegration::HeadPose* latestHeadPose, bool outputHeld);
+
+	ActivityStage GetStage() const { return m_stage; }
+	double GetRateHz() const;
+	bool ShouldReadHeadPoses() const { return m_stage != ActivityStage::Absent; }
+	const ActivityStageStats& GetStageStats(ActivityStage stage) const { return m_stats[static_cast<int>(stage)]; }
+
+	// Closes the running stage's accounting; call before reading the stats.
+	void Finish(int64_t nowMicroSeconds);
+	void Print(std::ostream& out) const;
+
+private:
+	void Enter(ActivityStage stage, int64_t nowMicroSeconds);
+
+	ActivitySettings m_settings;
+	ActivityStage m_stage = ActivityStage::Active;
+	ActivityStageStats m_stats[static_cast<int>(ActivityStage::Count)];
+	int64_t m_stageStart = -1;
+	int64_t m_stageCpuStart = 0;
+	int64_t m_lastMotion = -1;
+	int64_t m_lastPresent = -1;
+	float m_referenceYaw = 0.0f;
+	float m_referencePitch = 0.0f;
+};
+
+const char* GetActivityStageName(ActivityStage stage);
+
+// CPU time used by the whole process so far.
+int64_t ProcessCpuMicroSeconds();
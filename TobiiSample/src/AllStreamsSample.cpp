@@ -1,4 +1,6 @@
 #include "tobii_gameintegration.h"
+#include "ApiBackend.h"
+#include "PacedScheduler.h"
 #include <iostream>
 #include "windows.h"
 #include <thread>
@@ -9,11 +11,16 @@ HWND GetConsoleHwnd(void); // See SampleHelpFunctions.cpp
 
 void AllStreamsSample()
 {
-    ITobiiGameIntegrationApi* api = GetApi("Test Application");
+    ITobiiGameIntegrationApi* api = GetBackendApi("Test Application");
+    if (api == nullptr)
+    {
+        return;
+    }
     IStreamsProvider* streamsProvider = api->GetStreamsProvider();
 
     api->GetTrackerController()->TrackWindow(GetConsoleHwnd());
 
+    PacedScheduler frameRate{ 60.0 };
     while(!GetAsyncKeyState(VK_ESCAPE))
     {
         api->Update();
@@ -34,7 +41,7 @@ void AllStreamsSample()
         bool userIsPresent = streamsProvider->IsPresent();
         std::cout << "User Presence: " << userIsPresent << std::endl;
 
-        Sleep(1000 / 60);
+        frameRate.WaitForNextTick();
     }
 
     api->Shutdown();
@@ -0,0 +1,279 @@
+// Offline analytics over recorded sessions (SessionAnalytics.h): tracker noise at rest, deadzone and clamp
+// occupancy, and what the mapping emits, per session and summed into one report. Sessions are spread
+// over all cores, one session per thread at a time, biggest files first.
+// Build it instead of MyNewMain.cpp, e.g. on Linux:
+//   g++ -std=c++20 -O2 -fpermissive -Ivendor/tobii/include src/AnalyticsMain.cpp src/SessionAnalytics.cpp src/SessionArchive.cpp
+//       src/MappingEngine.cpp src/RateIntegrator.cpp src/StrategySettings.cpp src/HeadMouseMapping.cpp src/MappingKernel.cpp
+//       src/ResponseCurve.cpp src/HeadPoseFilter.cpp src/OfflineApi.cpp src/SessionRecording.cpp src/SyntheticApi.cpp -o analytics
+// Usage: analytics <session file | archive | directory | synthetic:<settings>>... [options]
+// A directory stands for the .thr and .tha files in it. Synthetic streams need fast= and duration=.
+// --profile and --strategy pick the mapping like in ReplayMain, --filter smooths the poses before it (the
+// noise figures are always on the raw poses). --rest <degrees>@<seconds> sets what counts as the head at rest.
+// --threads <n> limits the worker threads, all cores by default.
+#include "Clock.h"
+#include "SessionAnalytics.h"
+#include "SquadTuning.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TobiiGameIntegration;
+
+struct SessionResult
+{
+	std::string Source;
+	uintmax_t FileBytes = 0;
+	bool IsLoaded = false;
+	std::string Error;
+	SessionAnalysis Analysis;
+};
+
+static double Percent(double part, double whole)
+{
+	return whole > 0.0 ? 100.0 * part / whole : 0.0;
+}
+
+static double PerMinute(double count, double seconds)
+{
+	return seconds > 0.0 ? count * 60.0 / seconds : 0.0;
+}
+
+static void AddSource(const std::string& source, std::vector<SessionResult>& results)
+{
+	std::error_code error;
+	if (source.rfind("synthetic", 0) != 0 && std::filesystem::is_directory(source, error))
+	{
+		std::vector<std::string> paths;
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator{ source, error })
+		{
+			const std::string extension = entry.path().extension().string();
+			if (entry.is_regular_file(error) && (extension == ".thr" || extension == ".tha"))
+			{
+				paths.push_back(entry.path().string());
+			}
+		}
+		std::sort(paths.begin(), paths.end());
+		for (const std::string& path : paths)
+		{
+			AddSource(path, results);
+		}
+		return;
+	}
+	SessionResult result;
+	result.Source = source;
+	const uintmax_t bytes = std::filesystem::file_size(source, error);
+	result.FileBytes = error ? 0 : bytes;
+	results.push_back(std::move(result));
+}
+
+static bool ParseRest(const std::string& spec, AnalyticsSettings& settings)
+{
+	float degrees = 0.0f, seconds = 0.0f;
+	if (std::sscanf(spec.c_str(), "%f@%f", &degrees, &seconds) != 2 || degrees <= 0.0f || seconds <= 0.0f)
+	{
+		return false;
+	}
+	settings.RestRangeDegrees = degrees;
+	settings.RestWindowSeconds = seconds;
+	return true;
+}
+
+// "<1 Hz", "1-2 Hz", ..., "20+ Hz"
+static std::string GetBandName(int band)
+{
+	const auto edge = [](int index) { return std::to_string(static_cast<int>(k_noiseBandEdgesHz[index])); };
+	if (band == 0)
+	{
+		return "<" + edge(0) + " Hz";
+	}
+	return band == k_noiseBandCount - 1 ? edge(band - 1) + "+ Hz" : edge(band - 1) + "-" + edge(band) + " Hz";
+}
+
+static void PrintSummary(const SessionAnalysis& analysis, const MappingSettings& mappingSettings)
+{
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << analysis.HeadPoses << " head poses over " << analysis.Seconds / 60.0 << " min, at rest " <<
+		Percent(analysis.RestSeconds, analysis.Seconds) << "% of the time" << std::endl;
+
+	std::cout << std::endl << "Noise at rest (deg, mm)       std dev  band RMS";
+	for (int band = 0; band < k_noiseBandCount; band++)
+	{
+		std::cout << std::setw(12) << GetBandName(band);
+	}
+	std::cout << std::endl << std::setprecision(4);
+	for (int axis = 0; axis < k_analyticsAxisCount; axis++)
+	{
+		std::cout << "  " << std::left << std::setw(24) << GetAnalyticsAxisName(axis) << std::right << std::setw(10) << analysis.GetRestStdDev(axis) << "  ";
+		for (int band = 0; band < k_noiseBandCount; band++)
+		{
+			std::cout << std::setw(12) << analysis.GetBandRms(axis, band);
+		}
+		std::cout << std::endl;
+	}
+	std::cout << "  (" << analysis.RestHeadPoses << " poses at rest, " << analysis.SpectrumSegments << " spectrum segments)" << std::endl;
+
+	std::cout << std::endl << std::setprecision(1);
+	std::cout << "Inside the yaw deadzone (" << mappingSettings.DeadYawIRL << "): " << Percent(analysis.DeadYawSeconds, analysis.Seconds) << "%, pitch (" <<
+		mappingSettings.DeadPitchIRL << "): " << Percent(analysis.DeadPitchSeconds, analysis.Seconds) << "%, both: " <<
+		Percent(analysis.DeadBothSeconds, analysis.Seconds) << "%" << std::endl;
+	std::cout << "Against the yaw clamp (" << mappingSettings.MaxYawIRL << "): " << Percent(analysis.SaturatedYawSeconds, analysis.Seconds) << "%, pitch (" <<
+		mappingSettings.MaxPitchIRL << "): " << Percent(analysis.SaturatedPitchSeconds, analysis.Seconds) << "%" << std::endl;
+
+	std::cout << "Mouse events: " << analysis.MouseEvents << " (" << PerMinute(static_cast<double>(analysis.MouseEvents), analysis.Seconds) <<
+		"/min), counts: " << analysis.Counts << std::endl;
+	std::cout << "  at rest: " << analysis.RestMouseEvents << " events (" << Percent(static_cast<double>(analysis.RestMouseEvents), static_cast<double>(analysis.MouseEvents)) <<
+		"%, " << PerMinute(static_cast<double>(analysis.RestMouseEvents), analysis.RestSeconds) << " per minute at rest), " << analysis.RestCounts << " counts" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: " << argv[0] << " <session file | archive | directory | synthetic:<settings>>... [--profile <file>] [--strategy <mode>] [--filter <chain>] [--rest <degrees>@<seconds>] [--threads <n>]" << std::endl;
+		return 1;
+	}
+	std::vector<SessionResult> results;
+	AnalyticsSettings settings;
+	StrategySettings strategy;
+	std::string strategyMode;
+	std::unique_ptr<ResponseCurves> curves;
+	HeadPoseFilter filter;
+	unsigned threadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg{ argv[i] };
+		if (arg == "--profile" && i + 1 < argc)
+		{
+			ResponseProfile profile;
+			std::string error;
+			if (!LoadResponseProfile(argv[++i], profile, error))
+			{
+				std::cout << error << std::endl;
+				return 1;
+			}
+			if (profile.HasCurves)
+			{
+				curves = std::make_unique<ResponseCurves>(profile);
+			}
+			strategy = profile.Strategy;
+		}
+		else if (arg == "--strategy" && i + 1 < argc)
+		{
+			strategyMode = argv[++i];
+		}
+		else if (arg == "--filter" && i + 1 < argc)
+		{
+			std::string error;
+			if (!ParseFilterChain(argv[++i], filter, error))
+			{
+				std::cout << error << std::endl;
+				return 1;
+			}
+		}
+		else if (arg == "--rest" && i + 1 < argc && !ParseRest(argv[++i], settings))
+		{
+			std::cout << "Invalid --rest " << argv[i] << std::endl;
+			return 1;
+		}
+		else if (arg == "--threads" && i + 1 < argc)
+		{
+			threadCount = static_cast<unsigned>((std::max)(std::atoi(argv[++i]), 1));
+		}
+		else if (arg.rfind("--", 0) != 0)
+		{
+			AddSource(arg, results);
+		}
+	}
+	if (!strategyMode.empty() && !ParseStrategyEntry("mode", strategyMode, strategy))
+	{
+		std::cout << "Unknown strategy " << strategyMode << std::endl;
+		return 1;
+	}
+	if (results.empty())
+	{
+		std::cout << "No sessions to analyze" << std::endl;
+		return 1;
+	}
+
+	// Same scales as every offline backend reports, the SDK defaults
+	ExtendedViewSettings extendedViewSettings;
+	MappingSettings mappingSettings = SquadMappingSettings();
+	mappingSettings.HeadPoseYawScale = extendedViewSettings.HeadTracking.YawRightDegrees.SensitivityScaling;
+	mappingSettings.HeadPosePitchScale = extendedViewSettings.HeadTracking.PitchUpDegrees.SensitivityScaling;
+
+	// Biggest first, so a long session doesn't start last and leave the other threads idle at the end
+	std::vector<size_t> order(results.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return results[a].FileBytes > results[b].FileBytes; });
+
+	threadCount = static_cast<unsigned>((std::min)(static_cast<size_t>(threadCount), results.size()));
+	std::atomic<size_t> next{ 0 };
+	const int64_t start = NowNanoSeconds();
+	std::vector<std::thread> workers;
+	for (unsigned t = 0; t < threadCount; t++)
+	{
+		workers.emplace_back([&]()
+		{
+			std::vector<HeadPose> headPoses;
+			for (size_t index = next.fetch_add(1); index < order.size(); index = next.fetch_add(1))
+			{
+				SessionResult& result = results[order[index]];
+				const int64_t begin = NowNanoSeconds();
+				result.IsLoaded = LoadSessionHeadPoses(result.Source, headPoses, result.Error);
+				if (result.IsLoaded)
+				{
+					result.Analysis = AnalyzeHeadPoses(headPoses, settings, strategy, mappingSettings, curves.get(), filter);
+				}
+				result.Analysis.AnalysisSeconds = (NowNanoSeconds() - begin) / 1e9;
+			}
+		});
+	}
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	const double wallSeconds = (NowNanoSeconds() - start) / 1e9;
+
+	SessionAnalysis total;
+	int analyzed = 0;
+	std::cout << "session                              min  rest %  yaw sd  pitch sd  dead yaw %  clamp yaw %  events/min  at rest %" << std::endl;
+	for (const SessionResult& result : results)
+	{
+		std::string name = result.Source;
+		if (name.size() > 34)
+		{
+			name = "..." + name.substr(name.size() - 31);
+		}
+		std::cout << std::left << std::setw(34) << name << std::right;
+		if (!result.IsLoaded)
+		{
+			std::cout << " " << result.Error << std::endl;
+			continue;
+		}
+		const SessionAnalysis& analysis = result.Analysis;
+		std::cout << std::fixed << std::setprecision(1) << std::setw(6) << analysis.Seconds / 60.0 << std::setw(8) << Percent(analysis.RestSeconds, analysis.Seconds) <<
+			std::setprecision(3) << std::setw(8) << analysis.GetRestStdDev(0) << std::setw(10) << analysis.GetRestStdDev(1) << std::setprecision(1) <<
+			std::setw(12) << Percent(analysis.DeadYawSeconds, analysis.Seconds) << std::setw(13) << Percent(analysis.SaturatedYawSeconds, analysis.Seconds) <<
+			std::setw(12) << PerMinute(static_cast<double>(analysis.MouseEvents), analysis.Seconds) <<
+			std::setw(11) << Percent(static_cast<double>(analysis.RestMouseEvents), static_cast<double>(analysis.MouseEvents)) << std::endl;
+		total.Add(analysis);
+		analyzed++;
+	}
+
+	std::cout << std::endl << "All " << analyzed << " sessions, " << GetStrategyName(strategy.Kind) << " mapping" << (filter.IsEnabled() ? ", filtered" : "") <<
+		(curves != nullptr ? ", profile curves" : "") << std::endl;
+	PrintSummary(total, mappingSettings);
+	std::cout << std::endl << std::setprecision(2) << "Analyzed in " << wallSeconds << " s on " << threadCount << " threads, " << total.AnalysisSeconds << " s summed over the sessions" << std::endl;
+	return analyzed == static_cast<int>(results.size()) ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+#include "ApiBackend.h"
+#include "OpenTrackApi.h"
+#include "SessionRecording.h"
+#include "SyntheticApi.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace TobiiGameIntegration;
+
+static bool StartsWith(const std::string& text, const char* prefix, std::string& rest)
+{
+	const std::string prefixString{ prefix };
+	if (text.compare(0, prefixString.size(), prefixString) != 0)
+	{
+		return false;
+	}
+	rest = text.substr(prefixString.size());
+	return true;
+}
+
+static ITobiiGameIntegrationApi* CreateReplayApi(const std::string& path, ReplayTiming timing)
+{
+	ReplayApi* api = new ReplayApi(path.c_str(), timing);
+	if (!api->IsInitialized())
+	{
+		std::cerr << "Can't open session recording " << path << std::endl;
+		api->Shutdown();
+		return nullptr;
+	}
+	return api;
+}
+
+ITobiiGameIntegrationApi* GetBackendApi(const char* fullGameName, const char* backendSpec)
+{
+	const std::string spec{ backendSpec != nullptr ? backendSpec : "" };
+	std::string argument;
+
+	if (spec.empty() || spec == "tobii")
+	{
+#ifdef _WIN32
+		return GetApi(fullGameName);
+#else
+		std::cerr << "The Tobii backend is only available on Windows" << std::endl;
+		return nullptr;
+#endif
+	}
+	if (StartsWith(spec, "replay:", argument))
+	{
+		return CreateReplayApi(argument, ReplayTiming::Original);
+	}
+	if (StartsWith(spec, "replay-fast:", argument))
+	{
+		return CreateReplayApi(argument, ReplayTiming::AsFastAsPossible);
+	}
+
+	if (spec == "synthetic" || StartsWith(spec, "synthetic:", argument))
+	{
+		SyntheticSettings settings;
+		std::string error;
+		if (!ParseSyntheticSettings(argument, settings, error))
+		{
+			std::cerr << error << std::endl;
+			return nullptr;
+		}
+		return new SyntheticApi(settings);
+	}
+
+	if (spec == "opentrack" || StartsWith(spec, "opentrack:", argument))
+	{
+		OpenTrackSettings settings;
+		std::string error;
+		if (!ParseOpenTrackSettings(argument, settings, error))
+		{
+			std::cerr << error << std::endl;
+			return nullptr;
+		}
+		OpenTrackApi* api = new OpenTrackApi(settings);
+		if (!api->Open(error))
+		{
+			std::cerr << "Can't listen for OpenTrack packets on " << settings.Address << ":" << settings.Port << ": " << error << std::endl;
+			api->Shutdown();
+			return nullptr;
+		}
+		return api;
+	}
+
+	std::cerr << "Unknown backend " << spec << std::endl;
+	return nullptr;
+}
+
+ITobiiGameIntegrationApi* GetBackendApi(const char* fullGameName)
+{
+	std::string spec;
+#ifdef _WIN32
+	char* value = nullptr;
+	size_t length = 0;
+	if (_dupenv_s(&value, &length, "TOBII_BACKEND") == 0 && value != nullptr)
+	{
+		spec = value;
+		free(value);
+	}
+#else
+	if (const char* value = std::getenv("TOBII_BACKEND"))
+	{
+		spec = value;
+	}
+#endif
+	return GetBackendApi(fullGameName, spec.c_str());
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "TobiiPlatform.h"
+
+// Creates the tracker backend named by a spec string:
+//   "" or "tobii"          the real tracker through GetApi() (Windows only)
+//   "replay:<file>"        a recorded session at its original timing
+//   "replay-fast:<file>"   a recorded session, one recorded frame per Update()
+//   "synthetic[:<settings>]" generated motion, see ParseSyntheticSettings() in SyntheticApi.h
+//   "opentrack[:<settings>]" OpenTrack UDP packets, see ParseOpenTrackSettings() in OpenTrackApi.h
+// Returns nullptr (and prints why) when the backend cannot be created.
+TobiiGameIntegration::ITobiiGameIntegrationApi* GetBackendApi(const char* fullGameName, const char* backendSpec);
+
+// Same as above with the spec taken from the TOBII_BACKEND environment variable.
+TobiiGameIntegration::ITobiiGameIntegrationApi* GetBackendApi(const char* fullGameName);
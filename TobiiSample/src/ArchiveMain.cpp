@@ -0,0 +1,350 @@
+// Session archive tool (SessionArchive.h): packs recordings into archives and checks them, reads time ranges,
+// turns an archive back into a session recording for replay, and benchmarks decoding.
+// Build it instead of MyNewMain.cpp, e.g. on Linux (add -DSESSION_ARCHIVE_ZLIB=1 ... -lz for deflated blocks):
+//   g++ -std=c++20 -O2 -fpermissive -Ivendor/tobii/include src/ArchiveMain.cpp src/SessionArchive.cpp src/ApiBackend.cpp
+//       src/OfflineApi.cpp src/SessionRecording.cpp src/SyntheticApi.cpp src/OpenTrackApi.cpp src/OpenTrackUdp.cpp -o archive
+// Usage: archive pack <session file> | synthetic:<settings> <archive> [--block <samples>] [--deflate on|off]
+//        archive info <archive>
+//        archive read <archive> <from s> <to s>       seconds from the first head pose
+//        archive unpack <archive> <session file> [<from s> <to s>]
+//        archive bench <archive>
+#include "ApiBackend.h"
+#include "Clock.h"
+#include "OfflineApi.h"
+#include "SessionArchive.h"
+#include "SessionRecording.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace TobiiGameIntegration;
+
+static constexpr int k_benchRepeats = 5;
+
+static void PrintUsage(const char* program)
+{
+	std::cout << "Usage: " << program << " pack <session file> | synthetic:<settings> <archive> [--block <samples>] [--deflate on|off]" << std::endl;
+	std::cout << "       " << program << " info <archive>" << std::endl;
+	std::cout << "       " << program << " read <archive> <from s> <to s>" << std::endl;
+	std::cout << "       " << program << " unpack <archive> <session file> [<from s> <to s>]" << std::endl;
+	std::cout << "       " << program << " bench <archive>" << std::endl;
+}
+
+static bool OpenArchive(const char* path, SessionArchiveReader& reader)
+{
+	std::string error;
+	if (!reader.Open(path, error))
+	{
+		std::cout << error << std::endl;
+		return false;
+	}
+	if (!reader.HasIndex())
+	{
+		std::cout << path << " has no index (not closed), found " << reader.GetBlocks().size() << " blocks by scanning" << std::endl;
+	}
+	return true;
+}
+
+static int64_t GetFirstHeadPoseMicroSeconds(const SessionArchiveReader& reader)
+{
+	int64_t first = INT64_MAX;
+	for (const ArchiveBlockInfo& block : reader.GetBlocks())
+	{
+		if (block.Stream == ArchiveStream::HeadPoses)
+		{
+			first = (std::min)(first, block.FirstMicroSeconds);
+		}
+	}
+	return first == INT64_MAX ? 0 : first;
+}
+
+static int Pack(const std::string& source, const char* path, const ArchiveSettings& settings)
+{
+	const bool synthetic = source.rfind("synthetic", 0) == 0;
+	OfflineApi* api = dynamic_cast<OfflineApi*>(GetBackendApi("Session archive", (synthetic ? source : "replay-fast:" + source).c_str()));
+	if (api == nullptr)
+	{
+		return 1;
+	}
+	SessionArchiveWriter writer;
+	std::string error;
+	if (!writer.Open(path, settings, error))
+	{
+		std::cout << error << std::endl;
+		return 1;
+	}
+
+	// Kept to check what comes back
+	std::vector<HeadPose> headPoses;
+	std::vector<GazePoint> gazePoints;
+	const int64_t start = NowNanoSeconds();
+	while (!api->IsFinished())
+	{
+		api->Update();
+		const HeadPose* poses = nullptr;
+		const int poseCount = api->GetStreamsProvider()->GetHeadPoses(poses);
+		writer.AddHeadPoses(poses, poseCount);
+		headPoses.insert(headPoses.end(), poses, poses + poseCount);
+		const GazePoint* points = nullptr;
+		const int pointCount = api->GetStreamsProvider()->GetGazePoints(points);
+		writer.AddGazePoints(points, pointCount);
+		gazePoints.insert(gazePoints.end(), points, points + pointCount);
+	}
+	api->Shutdown();
+	if (!writer.Close())
+	{
+		std::cout << "Can't write " << path << std::endl;
+		return 1;
+	}
+	const double seconds = (NowNanoSeconds() - start) / 1e9;
+	std::cout << headPoses.size() << " head poses and " << gazePoints.size() << " gaze points in " << seconds << " s" << std::endl;
+	std::cout << "Session recording size: " << writer.GetRawBytes() << " bytes, archive: " << writer.GetArchiveBytes() << " bytes (" <<
+		static_cast<double>(writer.GetRawBytes()) / (std::max)(writer.GetArchiveBytes(), uint64_t{ 1 }) << "x smaller)" << std::endl;
+
+	SessionArchiveReader reader;
+	if (!OpenArchive(path, reader))
+	{
+		return 1;
+	}
+	std::vector<HeadPose> decodedPoses;
+	std::vector<GazePoint> decodedPoints;
+	if (!reader.ReadHeadPoses(INT64_MIN, INT64_MAX, decodedPoses, error) || !reader.ReadGazePoints(INT64_MIN, INT64_MAX, decodedPoints, error))
+	{
+		std::cout << error << std::endl;
+		return 1;
+	}
+	if (decodedPoses.size() != headPoses.size() || decodedPoints.size() != gazePoints.size())
+	{
+		std::cout << "Read back " << decodedPoses.size() << " head poses and " << decodedPoints.size() << " gaze points" << std::endl;
+		return 1;
+	}
+	double maxAngleError = 0.0, maxPositionError = 0.0, maxGazeError = 0.0;
+	uint64_t timeStampErrors = 0;
+	for (size_t i = 0; i < headPoses.size(); i++)
+	{
+		const HeadPose& a = headPoses[i];
+		const HeadPose& b = decodedPoses[i];
+		timeStampErrors += a.TimeStampMicroSeconds != b.TimeStampMicroSeconds;
+		maxAngleError = (std::max<double>)({ maxAngleError, std::fabs(a.Rotation.YawDegrees - b.Rotation.YawDegrees),
+			std::fabs(a.Rotation.PitchDegrees - b.Rotation.PitchDegrees), std::fabs(a.Rotation.RollDegrees - b.Rotation.RollDegrees) });
+		maxPositionError = (std::max<double>)({ maxPositionError, std::fabs(a.Position.X - b.Position.X), std::fabs(a.Position.Y - b.Position.Y),
+			std::fabs(a.Position.Z - b.Position.Z) });
+	}
+	for (size_t i = 0; i < gazePoints.size(); i++)
+	{
+		timeStampErrors += gazePoints[i].TimeStampMicroSeconds != decodedPoints[i].TimeStampMicroSeconds;
+		maxGazeError = (std::max<double>)({ maxGazeError, std::fabs(gazePoints[i].X - decodedPoints[i].X), std::fabs(gazePoints[i].Y - decodedPoints[i].Y) });
+	}
+	std::cout << "Read back: " << timeStampErrors << " timestamps differ, max error " << maxAngleError << " degrees, " << maxPositionError <<
+		" mm, " << maxGazeError << " gaze" << std::endl;
+	return timeStampErrors == 0 ? 0 : 1;
+}
+
+static int Info(const char* path)
+{
+	SessionArchiveReader reader;
+	if (!OpenArchive(path, reader))
+	{
+		return 1;
+	}
+	const ArchiveSettings& settings = reader.GetSettings();
+	uint64_t samples[2] = {}, blocks[2] = {}, storedBytes[2] = {}, columnBytes[2] = {}, deflated = 0;
+	int64_t first = INT64_MAX, last = INT64_MIN;
+	for (const ArchiveBlockInfo& block : reader.GetBlocks())
+	{
+		const int stream = static_cast<int>(block.Stream);
+		samples[stream] += block.SampleCount;
+		blocks[stream]++;
+		storedBytes[stream] += block.StoredBytes;
+		columnBytes[stream] += block.ColumnBytes;
+		deflated += block.Codec == ArchiveCodec::DeflatedColumns;
+		first = (std::min)(first, block.FirstMicroSeconds);
+		last = (std::max)(last, block.LastMicroSeconds);
+	}
+	std::cout << path << ": " << reader.GetFileBytes() << " bytes, " << reader.GetBlocks().size() << " blocks (" << deflated << " deflated)";
+	if (first <= last)
+	{
+		std::cout << " over " << (last - first) / 1e6 << " s";
+	}
+	std::cout << std::endl;
+	std::cout << "Quanta: " << settings.AngleQuantumDegrees << " degrees, " << settings.PositionQuantumMM << " mm, " << settings.GazeQuantum << " gaze" << std::endl;
+	const char* names[2] = { "Head poses", "Gaze points" };
+	for (int stream = 0; stream < 2; stream++)
+	{
+		std::cout << names[stream] << ": " << samples[stream] << " in " << blocks[stream] << " blocks, " << storedBytes[stream] << " bytes stored, " <<
+			columnBytes[stream] << " in columns";
+		if (samples[stream] > 0)
+		{
+			std::cout << " (" << static_cast<double>(storedBytes[stream]) / samples[stream] << " bytes/sample)";
+		}
+		std::cout << std::endl;
+	}
+	return 0;
+}
+
+static int Read(const char* path, double fromSeconds, double toSeconds)
+{
+	SessionArchiveReader reader;
+	if (!OpenArchive(path, reader))
+	{
+		return 1;
+	}
+	const int64_t origin = GetFirstHeadPoseMicroSeconds(reader);
+	const int64_t from = origin + static_cast<int64_t>(fromSeconds * 1e6);
+	const int64_t to = origin + static_cast<int64_t>(toSeconds * 1e6);
+	std::vector<const ArchiveBlockInfo*> blocks;
+	reader.FindBlocks(ArchiveStream::HeadPoses, from, to, blocks);
+	const size_t headPoseBlocks = blocks.size();
+	reader.FindBlocks(ArchiveStream::GazePoints, from, to, blocks);
+
+	std::vector<HeadPose> headPoses;
+	std::vector<GazePoint> gazePoints;
+	std::string error;
+	const int64_t start = NowNanoSeconds();
+	if (!reader.ReadHeadPoses(from, to, headPoses, error) || !reader.ReadGazePoints(from, to, gazePoints, error))
+	{
+		std::cout << error << std::endl;
+		return 1;
+	}
+	const double microSeconds = (NowNanoSeconds() - start) / 1e3;
+	std::cout << headPoses.size() << " head poses and " << gazePoints.size() << " gaze points from " << headPoseBlocks << " + " << blocks.size() <<
+		" of " << reader.GetBlocks().size() << " blocks in " << microSeconds << " us" << std::endl;
+	if (!headPoses.empty())
+	{
+		const HeadPose& headPose = headPoses.front();
+		std::cout << "First head pose at " << (headPose.TimeStampMicroSeconds - origin) / 1e6 << " s: yaw " << headPose.Rotation.YawDegrees <<
+			", pitch " << headPose.Rotation.PitchDegrees << ", roll " << headPose.Rotation.RollDegrees << std::endl;
+	}
+	return 0;
+}
+
+// One recorded frame per head pose, with the gaze points up to it, so replay: runs it at the original pace.
+static int Unpack(const char* path, const char* sessionPath, double fromSeconds, double toSeconds)
+{
+	SessionArchiveReader reader;
+	if (!OpenArchive(path, reader))
+	{
+		return 1;
+	}
+	const int64_t origin = GetFirstHeadPoseMicroSeconds(reader);
+	const int64_t from = fromSeconds > 0.0 ? origin + static_cast<int64_t>(fromSeconds * 1e6) : INT64_MIN;
+	const int64_t to = toSeconds > 0.0 ? origin + static_cast<int64_t>(toSeconds * 1e6) : INT64_MAX;
+	std::vector<HeadPose> headPoses;
+	std::vector<GazePoint> gazePoints;
+	std::string error;
+	if (!reader.ReadHeadPoses(from, to, headPoses, error) || !reader.ReadGazePoints(from, to, gazePoints, error))
+	{
+		std::cout << error << std::endl;
+		return 1;
+	}
+	SessionRecorder recorder;
+	if (!recorder.Open(sessionPath))
+	{
+		std::cout << "Can't create " << sessionPath << std::endl;
+		return 1;
+	}
+	RecordedFrame frame;
+	frame.IsPresent = true;
+	size_t nextGazePoint = 0;
+	for (const HeadPose& headPose : headPoses)
+	{
+		frame.UpdateMicroSeconds = headPose.TimeStampMicroSeconds - headPoses.front().TimeStampMicroSeconds;
+		frame.ExtendedView = headPose;
+		frame.HeadPoses.assign(1, headPose);
+		frame.GazePoints.clear();
+		while (nextGazePoint < gazePoints.size() && gazePoints[nextGazePoint].TimeStampMicroSeconds <= headPose.TimeStampMicroSeconds)
+		{
+			frame.GazePoints.push_back(gazePoints[nextGazePoint++]);
+		}
+		recorder.WriteFrame(frame);
+	}
+	recorder.Close();
+	std::cout << recorder.GetFramesWritten() << " frames written to " << sessionPath << std::endl;
+	return 0;
+}
+
+static int Bench(const char* path)
+{
+	SessionArchiveReader reader;
+	if (!OpenArchive(path, reader))
+	{
+		return 1;
+	}
+	std::vector<HeadPose> headPoses;
+	std::vector<GazePoint> gazePoints;
+	std::string error;
+	uint64_t decodedBytes = 0, storedBytes = 0, samples = 0;
+	int64_t bestNanoSeconds = INT64_MAX;
+	for (int repeat = 0; repeat < k_benchRepeats; repeat++)
+	{
+		decodedBytes = storedBytes = samples = 0;
+		const int64_t start = NowNanoSeconds();
+		for (const ArchiveBlockInfo& block : reader.GetBlocks())
+		{
+			const bool decoded = block.Stream == ArchiveStream::HeadPoses ? reader.DecodeHeadPoses(block, headPoses, error) :
+				reader.DecodeGazePoints(block, gazePoints, error);
+			if (!decoded)
+			{
+				std::cout << error << std::endl;
+				return 1;
+			}
+			decodedBytes += block.SampleCount * (block.Stream == ArchiveStream::HeadPoses ? sizeof(HeadPose) : sizeof(GazePoint));
+			storedBytes += block.StoredBytes;
+			samples += block.SampleCount;
+		}
+		bestNanoSeconds = (std::min)(bestNanoSeconds, NowNanoSeconds() - start);
+	}
+	const double seconds = (std::max)(bestNanoSeconds, int64_t{ 1 }) / 1e9;
+	std::cout << samples << " samples decoded in " << seconds * 1e3 << " ms, best of " << k_benchRepeats << ": " <<
+		decodedBytes / seconds / 1e9 << " GB/s of samples, " << storedBytes / seconds / 1e9 << " GB/s of archive, " <<
+		samples / seconds / 1e6 << " M samples/s" << std::endl;
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+	const std::string command{ argv[1] };
+	if (command == "pack" && argc >= 4)
+	{
+		ArchiveSettings settings;
+		for (int i = 4; i + 1 < argc; i++)
+		{
+			const std::string arg{ argv[i] };
+			if (arg == "--block")
+			{
+				settings.SamplesPerBlock = std::atoi(argv[++i]);
+			}
+			else if (arg == "--deflate")
+			{
+				settings.Deflate = std::string{ argv[++i] } != "off";
+			}
+		}
+		return Pack(argv[2], argv[3], settings);
+	}
+	if (command == "info")
+	{
+		return Info(argv[2]);
+	}
+	if (command == "read" && argc >= 5)
+	{
+		return Read(argv[2], std::atof(argv[3]), std::atof(argv[4]));
+	}
+	if (command == "unpack" && argc >= 4)
+	{
+		return Unpack(argv[2], argv[3], argc >= 6 ? std::atof(argv[4]) : 0.0, argc >= 6 ? std::atof(argv[5]) : 0.0);
+	}
+	if (command == "bench")
+	{
+		return Bench(argv[2]);
+	}
+	PrintUsage(argv[0]);
+	return 1;
+}
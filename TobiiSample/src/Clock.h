@@ -0,0 +1,16 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Monotonic clock shared by the offline backends and the measurement code.
+inline int64_t NowMicroSeconds()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Same clock, for timing work that takes less than a microsecond.
+inline int64_t NowNanoSeconds()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -1,4 +1,6 @@
 #include "tobii_gameintegration.h"
+#include "ApiBackend.h"
+#include "PacedScheduler.h"
 #include <iostream>
 #include <iomanip>
 #include "windows.h"
@@ -10,7 +12,11 @@ HWND GetConsoleHwnd(void); // See SampleHelpFunctions.cpp
 
 void ExtendedViewSample()
 {
-    ITobiiGameIntegrationApi* api = GetApi("Extended View Sample");
+    ITobiiGameIntegrationApi* api = GetBackendApi("Extended View Sample");
+    if (api == nullptr)
+    {
+        return;
+    }
     IExtendedView* extendedView = api->GetFeatures()->GetExtendedView();
 
     // Turn on head tracking position
@@ -23,6 +29,7 @@ void ExtendedViewSample()
 
     std::cout << "Right Control: reset head pose, Left Control: hold to pause extended view." << std::endl << std::endl;
 
+    PacedScheduler frameRate{ 60.0 };
     while(!GetAsyncKeyState(VK_ESCAPE))
     {
         api->Update();
@@ -45,7 +52,7 @@ void ExtendedViewSample()
         std::cout << "Extended View Rot(deg) [Y: " << trans.Rotation.YawDegrees << ",P: " << trans.Rotation.PitchDegrees << ",R: " << trans.Rotation.RollDegrees << "] " <<
             "Pos(mm) [X: " << trans.Position.X << ",Y: " << trans.Position.Y << ",Z: " << trans.Position.Z << "]          \r";
 
-        Sleep(1000 / 60);
+        frameRate.WaitForNextTick();
     }
 
     api->Shutdown();
@@ -0,0 +1,187 @@
+#include "ExtendedViewSettingsRegistry.h"
+#include <algorithm>
+#include <iterator>
+
+using namespace TobiiGameIntegration;
+
+struct SettingField
+{
+	const char* Name;
+	ExtendedViewSettingType Type;
+	Setting<float>& (*Float)(ExtendedViewSettings&);	// set for Float fields
+	Setting<bool>& (*Bool)(ExtendedViewSettings&);		// set for Bool fields
+};
+
+#define EXTENDED_VIEW_FLOAT_FIELD(Id, path) \
+	{ #path, ExtendedViewSettingType::Float, [](ExtendedViewSettings& s) -> Setting<float>& { return s.path; }, nullptr },
+#define EXTENDED_VIEW_BOOL_FIELD(Id, path) \
+	{ #path, ExtendedViewSettingType::Bool, nullptr, [](ExtendedViewSettings& s) -> Setting<bool>& { return s.path; } },
+static constexpr SettingField k_fields[] =
+{
+	EXTENDED_VIEW_SETTINGS(EXTENDED_VIEW_FLOAT_FIELD, EXTENDED_VIEW_BOOL_FIELD)
+};
+#undef EXTENDED_VIEW_FLOAT_FIELD
+#undef EXTENDED_VIEW_BOOL_FIELD
+
+static_assert(std::size(k_fields) == k_extendedViewSettingCount, "one field per ExtendedViewSettingId");
+
+static const SettingField& GetField(ExtendedViewSettingId id)
+{
+	return k_fields[static_cast<int>(id)];
+}
+
+// The accessors only read through the reference here
+static const Setting<float>& GetFloatSetting(const ExtendedViewSettings& settings, ExtendedViewSettingId id)
+{
+	return GetField(id).Float(const_cast<ExtendedViewSettings&>(settings));
+}
+
+static const Setting<bool>& GetBoolSetting(const ExtendedViewSettings& settings, ExtendedViewSettingId id)
+{
+	return GetField(id).Bool(const_cast<ExtendedViewSettings&>(settings));
+}
+
+static bool IsFieldEqual(const ExtendedViewSettings& a, const ExtendedViewSettings& b, ExtendedViewSettingId id)
+{
+	return GetField(id).Type == ExtendedViewSettingType::Float
+		? GetFloatSetting(a, id) == GetFloatSetting(b, id)
+		: GetBoolSetting(a, id) == GetBoolSetting(b, id);
+}
+
+static void CopyField(const ExtendedViewSettings& from, ExtendedViewSettings& to, ExtendedViewSettingId id)
+{
+	const SettingField& field = GetField(id);
+	if (field.Type == ExtendedViewSettingType::Float)
+	{
+		field.Float(to) = GetFloatSetting(from, id);
+	}
+	else
+	{
+		field.Bool(to) = GetBoolSetting(from, id);
+	}
+}
+
+static const ExtendedViewSettings& GetDefaultSettings()
+{
+	static const ExtendedViewSettings defaults;
+	return defaults;
+}
+
+const char* GetSettingName(ExtendedViewSettingId id)
+{
+	return GetField(id).Name;
+}
+
+ExtendedViewSettingType GetSettingType(ExtendedViewSettingId id)
+{
+	return GetField(id).Type;
+}
+
+float GetSettingMin(ExtendedViewSettingId id)
+{
+	return GetField(id).Type == ExtendedViewSettingType::Float
+		? GetFloatSetting(GetDefaultSettings(), id).Metadata.MinMaxRange.Min
+		: (GetBoolSetting(GetDefaultSettings(), id).Metadata.MinMaxRange.Min ? 1.0f : 0.0f);
+}
+
+float GetSettingMax(ExtendedViewSettingId id)
+{
+	return GetField(id).Type == ExtendedViewSettingType::Float
+		? GetFloatSetting(GetDefaultSettings(), id).Metadata.MinMaxRange.Max
+		: (GetBoolSetting(GetDefaultSettings(), id).Metadata.MinMaxRange.Max ? 1.0f : 0.0f);
+}
+
+bool ExtendedViewSettingsRegistry::Fetch(IExtendedView& extendedView)
+{
+	if (!m_isStale)
+	{
+		return false;
+	}
+	ExtendedViewSettings fetched;
+	extendedView.GetSettings(fetched);
+	for (int i = 0; i < k_extendedViewSettingCount; i++)
+	{
+		if (m_dirty.test(i))
+		{
+			CopyField(m_settings, fetched, static_cast<ExtendedViewSettingId>(i));
+		}
+	}
+	m_settings = fetched;
+	m_isStale = false;
+	return true;
+}
+
+bool ExtendedViewSettingsRegistry::Flush(IExtendedView& extendedView)
+{
+	if (m_dirty.none())
+	{
+		return false;
+	}
+	m_dirty.reset();
+	if (!extendedView.UpdateSettings(m_settings))
+	{
+		m_isStale = true;
+	}
+	return true;
+}
+
+float ExtendedViewSettingsRegistry::GetFloat(ExtendedViewSettingId id) const
+{
+	return GetField(id).Type == ExtendedViewSettingType::Float ? GetFloatSetting(m_settings, id).Value : 0.0f;
+}
+
+bool ExtendedViewSettingsRegistry::GetBool(ExtendedViewSettingId id) const
+{
+	return GetField(id).Type == ExtendedViewSettingType::Bool ? GetBoolSetting(m_settings, id).Value : false;
+}
+
+float ExtendedViewSettingsRegistry::GetValue(ExtendedViewSettingId id) const
+{
+	return GetField(id).Type == ExtendedViewSettingType::Float ? GetFloat(id) : (GetBool(id) ? 1.0f : 0.0f);
+}
+
+bool ExtendedViewSettingsRegistry::SetFloat(ExtendedViewSettingId id, float value)
+{
+	const SettingField& field = GetField(id);
+	if (field.Type != ExtendedViewSettingType::Float)
+	{
+		return false;
+	}
+	Setting<float>& setting = field.Float(m_settings);
+	value = std::clamp(value, setting.Metadata.MinMaxRange.Min, setting.Metadata.MinMaxRange.Max);
+	if (setting.Value != value)
+	{
+		setting.Value = value;
+		m_dirty.set(static_cast<size_t>(id));
+	}
+	return true;
+}
+
+bool ExtendedViewSettingsRegistry::SetBool(ExtendedViewSettingId id, bool value)
+{
+	const SettingField& field = GetField(id);
+	if (field.Type != ExtendedViewSettingType::Bool)
+	{
+		return false;
+	}
+	Setting<bool>& setting = field.Bool(m_settings);
+	if (setting.Value != value)
+	{
+		setting.Value = value;
+		m_dirty.set(static_cast<size_t>(id));
+	}
+	return true;
+}
+
+void ExtendedViewSettingsRegistry::Modify(const std::function<void(ExtendedViewSettings&)>& change)
+{
+	const ExtendedViewSettings before = m_settings;
+	change(m_settings);
+	for (int i = 0; i < k_extendedViewSettingCount; i++)
+	{
+		if (!IsFieldEqual(before, m_settings, static_cast<ExtendedViewSettingId>(i)))
+		{
+			m_dirty.set(i);
+		}
+	}
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "tobii_gameintegration.h"
+#include <bitset>
+#include <cstdint>
+#include <functional>
+
+// Every Setting<T> of ExtendedViewSettings, one line each: FLOAT(Id, path) / BOOL(Id, path), with path
+// relative to ExtendedViewSettings. Expanded into the ExtendedViewSettingId enum here and into the
+// field descriptor table in ExtendedViewSettingsRegistry.cpp.
+#define EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, Id, path) \
+	FLOAT(Id##Limit, path.Limit) \
+	FLOAT(Id##SensitivityScaling, path.SensitivityScaling) \
+	FLOAT(Id##SCurveStrengthNorm, path.SCurveStrengthNorm) \
+	FLOAT(Id##SCurveMidPointNorm, path.SCurveMidPointNorm) \
+	FLOAT(Id##DeadZoneNorm, path.DeadZoneNorm)
+
+#define EXTENDED_VIEW_SETTINGS(FLOAT, BOOL) \
+	BOOL(HeadTrackingEnabled, HeadTracking.Enabled) \
+	BOOL(HeadTrackingAutoReset, HeadTracking.AutoReset) \
+	FLOAT(HeadTrackingRotationResponsiveness, HeadTracking.RotationResponsiveness) \
+	BOOL(HeadTrackingRotationRollEnabled, HeadTracking.RotationRollEnabled) \
+	BOOL(HeadTrackingPositionEnabled, HeadTracking.PositionEnabled) \
+	BOOL(HeadTrackingRelativeHeadPositionEnabled, HeadTracking.RelativeHeadPositionEnabled) \
+	BOOL(HeadTrackingRotateAxisSettingsWithHead, HeadTracking.RotateAxisSettingsWithHead) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingYawRightDegrees, HeadTracking.YawRightDegrees) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingYawLeftDegrees, HeadTracking.YawLeftDegrees) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingPitchUpDegrees, HeadTracking.PitchUpDegrees) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingPitchDownDegrees, HeadTracking.PitchDownDegrees) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingRollRightDegrees, HeadTracking.RollRightDegrees) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingRollLeftDegrees, HeadTracking.RollLeftDegrees) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingXRightMm, HeadTracking.XRightMm) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingXLeftMm, HeadTracking.XLeftMm) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingYUpMm, HeadTracking.YUpMm) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingYDownMm, HeadTracking.YDownMm) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingZBackMm, HeadTracking.ZBackMm) \
+	EXTENDED_VIEW_AXIS_SETTINGS(FLOAT, HeadTrackingZForwardMm, HeadTracking.ZForwardMm) \
+	BOOL(CameraBoostEnabled, CameraBoost.Enabled) \
+	FLOAT(CameraBoostGazeDeadZone, CameraBoost.GazeDeadZone) \
+	FLOAT(CameraBoostBoost, CameraBoost.Boost) \
+	BOOL(GazeHeadMixEnabled, GazeHeadMix.Enabled) \
+	FLOAT(GazeHeadMixGazeResponsiveness, GazeHeadMix.GazeResponsiveness) \
+	FLOAT(GazeHeadMixGazeYawLimitDegrees, GazeHeadMix.GazeYawLimitDegrees) \
+	FLOAT(GazeHeadMixGazePitchUpLimitDegrees, GazeHeadMix.GazePitchUpLimitDegrees) \
+	FLOAT(GazeHeadMixGazePitchDownLimitDegrees, GazeHeadMix.GazePitchDownLimitDegrees)
+
+#define EXTENDED_VIEW_SETTING_ID(Id, path) Id,
+enum class ExtendedViewSettingId : uint8_t
+{
+	EXTENDED_VIEW_SETTINGS(EXTENDED_VIEW_SETTING_ID, EXTENDED_VIEW_SETTING_ID)
+	Count
+};
+#undef EXTENDED_VIEW_SETTING_ID
+
+static constexpr int k_extendedViewSettingCount = static_cast<int>(ExtendedViewSettingId::Count);
+
+enum class ExtendedViewSettingType
+{
+	Float,
+	Bool
+};
+
+const char* GetSettingName(ExtendedViewSettingId id);	// "HeadTracking.PitchUpDegrees.Limit"
+ExtendedViewSettingType GetSettingType(ExtendedViewSettingId id);
+// Metadata.MinMaxRange, bools as 0 and 1
+float GetSettingMin(ExtendedViewSettingId id);
+float GetSettingMax(ExtendedViewSettingId id);
+
+// The game's copy of the Extended View settings. IExtendedView::GetSettings() and UpdateSettings() copy
+// the whole struct across the API each call, so instead of a round trip per frame: edits land here and
+// mark their field dirty, Flush() sends them in one UpdateSettings() per frame and only when a field
+// actually changed, and the SDK is only read again after Invalidate().
+class ExtendedViewSettingsRegistry
+{
+public:
+	// Marks the local copy stale, the next Fetch() reads it from the SDK. Call it once at start and
+	// whenever something other than this registry may have changed the settings.
+	void Invalidate() { m_isStale = true; }
+
+	// GetSettings() if invalidated, otherwise nothing. Fields edited since the last Flush() keep their
+	// local value. Returns true if it read from the SDK.
+	bool Fetch(TobiiGameIntegration::IExtendedView& extendedView);
+
+	// UpdateSettings() once if any field is dirty, then clears the dirty set. Returns true if it sent.
+	// If the SDK rejects the settings the registry invalidates itself so the next Fetch() shows what
+	// is actually in effect.
+	bool Flush(TobiiGameIntegration::IExtendedView& extendedView);
+
+	float GetFloat(ExtendedViewSettingId id) const;
+	bool GetBool(ExtendedViewSettingId id) const;
+	float GetValue(ExtendedViewSettingId id) const;	// either type, bools as 0 and 1
+
+	// Clamped to the setting's range. Returns false for a field of the other type; an unchanged value
+	// is accepted but doesn't dirty the field.
+	bool SetFloat(ExtendedViewSettingId id, float value);
+	bool SetBool(ExtendedViewSettingId id, bool value);
+
+	// For the SDK help functions that set several fields at once, e.g.
+	// Modify([&](ExtendedViewSettings& s) { HeadTrackingHelpFunctions::SetCenterStabilization(s.HeadTracking, 0.5f); });
+	// Fields that end up different are marked dirty.
+	void Modify(const std::function<void(TobiiGameIntegration::ExtendedViewSettings&)>& change);
+
+	bool IsDirty() const { return m_dirty.any(); }
+	bool IsDirty(ExtendedViewSettingId id) const { return m_dirty.test(static_cast<size_t>(id)); }
+	const TobiiGameIntegration::ExtendedViewSettings& GetSettings() const { return m_settings; }
+
+private:
+	TobiiGameIntegration::ExtendedViewSettings m_settings;
+	std::bitset<k_extendedViewSettingCount> m_dirty;
+	bool m_isStale = true;
+};
@@ -1,4 +1,7 @@
 #include "tobii_gameintegration.h"
+#include "ApiBackend.h"
+#include "ExtendedViewSettingsRegistry.h"
+#include "PacedScheduler.h"
 #include <iostream>
 #include "windows.h"
 #include <thread>
@@ -15,71 +18,123 @@ HWND GetConsoleHwnd(void); // See SampleHelpFunctions.cpp
 struct SettingItem
 {
     std::string m_name;
-    bool m_valueChanged = false;
-        
+
     SettingItem(std::string name) : m_name{ name } { };
 
-    virtual float GetValue() = 0;
     virtual void ChangeValue(bool increase) = 0;
     virtual void Draw(bool isSelected) const = 0;
+
+protected:
+    void DrawValue(bool isSelected, float value) const
+    {
+        std::cout << (isSelected ? "->" : "  ") << "[" << "] " << m_name << " : " << value << "                       " << std::endl;
+    }
 };
 
 // This class represents a hypothetical in-game slider that the user can control.
+// It is bound to a single Setting<float> member of the ExtendedViewSettings struct, through the registry which sends it to the SDK.
 struct Slider : public SettingItem
 {
-    const float m_minValue;
-    const float m_maxValue;
-    float& m_value;
+    ExtendedViewSettingsRegistry& m_registry;
+    const ExtendedViewSettingId m_id;
 
-    Slider(std::string name, float min, float max, float& current) 
-        : SettingItem(name), m_minValue{min}, m_maxValue{ max }, m_value{ current }
+    Slider(ExtendedViewSettingsRegistry& registry, ExtendedViewSettingId id)
+        : SettingItem(GetSettingName(id)), m_registry{ registry }, m_id{ id }
     { }
 
-    virtual float GetValue() override
-    {
-        return m_value;
-    }
-
     void ChangeValue(bool increase) override
     {
-        float stepSize = (m_maxValue - m_minValue) / 10.f;
-        float newValue = increase ? m_value + stepSize : m_value - stepSize;
-        newValue = std::min<float>(m_maxValue, std::max<float>(m_minValue, newValue));
-        if (newValue != m_value)
-        {
-            m_valueChanged = true;
-            m_value = newValue;
-        }
+        float stepSize = (GetSettingMax(m_id) - GetSettingMin(m_id)) / 10.f;
+        float value = m_registry.GetFloat(m_id);
+        m_registry.SetFloat(m_id, increase ? value + stepSize : value - stepSize); // Clamped to the setting's range, only marked for sending if it changed
     }
 
     void Draw(bool isSelected) const override
     {
-        std::cout << (isSelected ? "->" : "  ") << "[" << "] " << m_name << " : " << m_value << "                       " << std::endl;
+        DrawValue(isSelected, m_registry.GetFloat(m_id));
     }
 };
 
 struct Switch : public SettingItem
 {
-    bool m_value = false;
+    ExtendedViewSettingsRegistry& m_registry;
+    const ExtendedViewSettingId m_id;
 
-    Switch(std::string name, bool currentValue)
-        : SettingItem(name), m_value{ currentValue }
+    Switch(ExtendedViewSettingsRegistry& registry, ExtendedViewSettingId id)
+        : SettingItem(GetSettingName(id)), m_registry{ registry }, m_id{ id }
     { }
 
-    virtual float GetValue() override
+    void ChangeValue(bool increase) override
+    {
+        m_registry.SetBool(m_id, !m_registry.GetBool(m_id));
+    }
+
+    void Draw(bool isSelected) const override
+    {
+        bool value = m_registry.GetBool(m_id);
+        std::cout << (isSelected ? "->" : "  ") << "[" << (value ? " #" : "# ") << "] " << m_name << " : " << (value ? "True " : "False") << "                       " << std::endl;
+    }
+};
+
+enum class CompoundSetting
+{
+    GazePlusHeadPitchLimitDegrees,
+    EyeToHeadLimitsRatio,
+    HeadCenterStabilisation,
+    HeadRotationSensitivity
+};
+
+// We handle changes to the compound settings by calling helper-functions which set multiple ExtendedViewSettings members
+// Note that these helpers-functions overwrite some of the individual Setting members which are used in the detailed settings above for illustrative purposes
+void ApplyCompoundSetting(CompoundSetting setting, float value, ExtendedViewSettings& s)
+{
+    switch (setting)
     {
-        return m_value ? 1.0f : 0.0f;
+    case CompoundSetting::GazePlusHeadPitchLimitDegrees:
+        GazeHeadMixHelpFunctions::SetCameraMaxAnglePitchUp(s.GazeHeadMix, s.HeadTracking, value);
+        GazeHeadMixHelpFunctions::SetCameraMaxAnglePitchDown(s.GazeHeadMix, s.HeadTracking, -value); // Pitch down is negative
+        break;
+    case CompoundSetting::EyeToHeadLimitsRatio:
+        GazeHeadMixHelpFunctions::SetEyeHeadTrackingRatio(s.GazeHeadMix, s.HeadTracking, value);
+        break;
+    case CompoundSetting::HeadCenterStabilisation:
+        HeadTrackingHelpFunctions::SetCenterStabilization(s.HeadTracking, value);
+        break;
+    case CompoundSetting::HeadRotationSensitivity:
+        HeadTrackingHelpFunctions::SetHeadAllRotationAxisSettingsSensitivity(s.HeadTracking, value);
+        break;
     }
+}
+
+// A slider with its own value, which is applied to several members of the ExtendedViewSettings struct at once.
+// The registry works out which members actually changed.
+struct CompoundSlider : public SettingItem
+{
+    ExtendedViewSettingsRegistry& m_registry;
+    const CompoundSetting m_setting;
+    const float m_minValue;
+    const float m_maxValue;
+    float m_value;
+
+    CompoundSlider(ExtendedViewSettingsRegistry& registry, std::string name, CompoundSetting setting, float min, float max, float current)
+        : SettingItem(name), m_registry{ registry }, m_setting{ setting }, m_minValue{ min }, m_maxValue{ max }, m_value{ current }
+    { }
 
     void ChangeValue(bool increase) override
     {
-        m_value = !m_value;
-        m_valueChanged = true;
+        float stepSize = (m_maxValue - m_minValue) / 10.f;
+        float newValue = increase ? m_value + stepSize : m_value - stepSize;
+        newValue = std::min<float>(m_maxValue, std::max<float>(m_minValue, newValue));
+        if (newValue != m_value)
+        {
+            m_value = newValue;
+            m_registry.Modify([this](ExtendedViewSettings& s) { ApplyCompoundSetting(m_setting, m_value, s); });
+        }
     }
 
     void Draw(bool isSelected) const override
     {
-        std::cout << (isSelected ? "->" : "  ") << "[" << (m_value ? " #" : "# ") << "] " << m_name << " : " << (m_value ? "True " : "False") << "                       " << std::endl;
+        DrawValue(isSelected, m_value);
     }
 };
 
@@ -88,173 +143,101 @@ void PrintExtendedViewSettingsControl(std::vector<SettingItem*>& allSettings, bo
 
 void ExtendedViewSettingsSample()
 {
-    ExtendedViewSettings s;
-
-    float gazePlusHeadPitchLimitDegrees = 70.0f;
-    float eyeToHeadLimitsRatio = 1.0f;
-    float headCenterStabilisation = 0.f;
-    float headRotationSensitivity = 1.0f;
+    // Our copy of the settings. The sliders and switches below edit it, and once per frame it sends whatever changed to the SDK.
+    ExtendedViewSettingsRegistry registry;
 
     std::vector<Slider> settingsSliders =
     {
         // These are examples of detailed settings sliders, which are bound here directly to single Setting members of the ExtendedViewSettings struct:
-        { "GazeHeadMix.GazePitchUpLimitDegrees",
-            s.GazeHeadMix.GazePitchUpLimitDegrees.Metadata.MinMaxRange.Min,
-            s.GazeHeadMix.GazePitchUpLimitDegrees.Metadata.MinMaxRange.Max,
-            s.GazeHeadMix.GazePitchUpLimitDegrees },
-        { "HeadTracking.HeadPitchUpDegrees.Limit",
-            s.HeadTracking.PitchUpDegrees.Limit.Metadata.MinMaxRange.Min,
-            s.HeadTracking.PitchUpDegrees.Limit.Metadata.MinMaxRange.Max,
-            s.HeadTracking.PitchUpDegrees.Limit },
-        { "HeadTracking.PitchUpDegrees.SensitivityScaling",
-            s.HeadTracking.PitchUpDegrees.SensitivityScaling.Metadata.MinMaxRange.Min,
-            s.HeadTracking.PitchUpDegrees.SensitivityScaling.Metadata.MinMaxRange.Max,
-            s.HeadTracking.PitchUpDegrees.SensitivityScaling },
-        { "HeadTracking.PitchUpDegrees.DeadZoneNorm",
-            s.HeadTracking.PitchUpDegrees.DeadZoneNorm.Metadata.MinMaxRange.Min,
-            s.HeadTracking.PitchUpDegrees.DeadZoneNorm.Metadata.MinMaxRange.Max,
-            s.HeadTracking.PitchUpDegrees.DeadZoneNorm },
-        { "HeadTracking.PitchUpDegrees.SCurveStrengthNorm",
-            s.HeadTracking.PitchUpDegrees.SCurveStrengthNorm.Metadata.MinMaxRange.Min,
-            s.HeadTracking.PitchUpDegrees.SCurveStrengthNorm.Metadata.MinMaxRange.Max,
-            s.HeadTracking.PitchUpDegrees.SCurveStrengthNorm },
-
-        { "GazeHeadMix.GazePitchDownLimitDegrees",
-            s.GazeHeadMix.GazePitchDownLimitDegrees.Metadata.MinMaxRange.Min,
-            s.GazeHeadMix.GazePitchDownLimitDegrees.Metadata.MinMaxRange.Max,
-            s.GazeHeadMix.GazePitchDownLimitDegrees },
-        { "HeadTracking.PitchDownDegrees.Limit",
-            s.HeadTracking.PitchDownDegrees.Limit.Metadata.MinMaxRange.Min,
-            s.HeadTracking.PitchDownDegrees.Limit.Metadata.MinMaxRange.Max,
-            s.HeadTracking.PitchDownDegrees.Limit },
-        { "HeadTracking.PitchDownDegrees.SensitivityScaling",
-            s.HeadTracking.PitchDownDegrees.SensitivityScaling.Metadata.MinMaxRange.Min,
-            s.HeadTracking.PitchDownDegrees.SensitivityScaling.Metadata.MinMaxRange.Max,
-            s.HeadTracking.PitchDownDegrees.SensitivityScaling },
-        { "HeadTracking.PitchDownDegrees.DeadZoneNorm",
-            s.HeadTracking.PitchDownDegrees.DeadZoneNorm.Metadata.MinMaxRange.Min,
-            s.HeadTracking.PitchDownDegrees.DeadZoneNorm.Metadata.MinMaxRange.Max,
-            s.HeadTracking.PitchDownDegrees.DeadZoneNorm },
-        { "HeadTracking.PitchDownDegrees.SCurveStrengthNorm",
-            s.HeadTracking.PitchDownDegrees.SCurveStrengthNorm.Metadata.MinMaxRange.Min,
-            s.HeadTracking.PitchDownDegrees.SCurveStrengthNorm.Metadata.MinMaxRange.Max,
-            s.HeadTracking.PitchDownDegrees.SCurveStrengthNorm },
-
-            // These are examples of compund settings sliders, which are bound here to local float variables that will be used to set multiple members of the ExtendedViewSettings struct via helper member-functions
-            { "GazePlusHeadPitchLimitDegrees",
-                0.0f,
-                90.0f,
-                gazePlusHeadPitchLimitDegrees },
-            { "EyeToHeadLimitsRatio",
-                0.0f,
-                1.0f,
-                eyeToHeadLimitsRatio },
-            { "HeadCenterStabilisation",
-                0.0f,
-                1.0f,
-                headCenterStabilisation },
-            { "HeadRotationSensitivity",
-                0.0f,
-                5.0f,
-                headRotationSensitivity }
+        { registry, ExtendedViewSettingId::GazeHeadMixGazePitchUpLimitDegrees },
+        { registry, ExtendedViewSettingId::HeadTrackingPitchUpDegreesLimit },
+        { registry, ExtendedViewSettingId::HeadTrackingPitchUpDegreesSensitivityScaling },
+        { registry, ExtendedViewSettingId::HeadTrackingPitchUpDegreesDeadZoneNorm },
+        { registry, ExtendedViewSettingId::HeadTrackingPitchUpDegreesSCurveStrengthNorm },
+
+        { registry, ExtendedViewSettingId::GazeHeadMixGazePitchDownLimitDegrees },
+        { registry, ExtendedViewSettingId::HeadTrackingPitchDownDegreesLimit },
+        { registry, ExtendedViewSettingId::HeadTrackingPitchDownDegreesSensitivityScaling },
+        { registry, ExtendedViewSettingId::HeadTrackingPitchDownDegreesDeadZoneNorm },
+        { registry, ExtendedViewSettingId::HeadTrackingPitchDownDegreesSCurveStrengthNorm }
     };
 
-    std::vector<Switch> settingsSwitches = {
-        { "RelativeHeadPositionEnabled", s.HeadTracking.RelativeHeadPositionEnabled },
-        { "RotateAxisSettingsWithHead", s.HeadTracking.RotateAxisSettingsWithHead },
-        { "CameraBoostEnabled", s.CameraBoost.Enabled },
-        { "GazeHeadMixEnabled", s.GazeHeadMix.Enabled }
+    // These are examples of compund settings sliders, which hold their own value that will be used to set multiple members of the ExtendedViewSettings struct via helper member-functions
+    std::vector<CompoundSlider> compoundSliders =
+    {
+        { registry, "GazePlusHeadPitchLimitDegrees", CompoundSetting::GazePlusHeadPitchLimitDegrees, 0.0f, 90.0f, 70.0f },
+        { registry, "EyeToHeadLimitsRatio", CompoundSetting::EyeToHeadLimitsRatio, 0.0f, 1.0f, 1.0f },
+        { registry, "HeadCenterStabilisation", CompoundSetting::HeadCenterStabilisation, 0.0f, 1.0f, 0.0f },
+        { registry, "HeadRotationSensitivity", CompoundSetting::HeadRotationSensitivity, 0.0f, 5.0f, 1.0f }
+    };
 
+    std::vector<Switch> settingsSwitches = {
+        // RelativeHeadPosition is a flavor of extended view in which head position is applied relative to the current head rotation.
+        // When enabled, turning head to the right 90 and then moving forward would result in movement "forward" in relation to the camera.
+        // When disabled, turning head to the right 90 and then moving forward would result in movement "left" in relation to the camera.
+        { registry, ExtendedViewSettingId::HeadTrackingRelativeHeadPositionEnabled },
+
+        // Enables the rotation of AxisSettings together with Head. This setting relates to RelativeHeadPosition and is used only when RelativeHeadPosition is enabled.
+        // When disabled, the initial AxisSettings are respected. If you restrict head movement forward-backward to 1mm and left-right to 200mm,
+        // and then turn your head 90 to the right - you will have 1mm restriction on left-right head movement and 200mm forward-backward.
+        // When enabled, the Axis Settings are applied in relation to rotated head pose. If you restrict head movement forward-backward to 1mm and left-right to 200mm,
+        // and then turn your head 90 to the right - you will have 200mm restriction on left-right head movement and 1mm forward-backward.
+        { registry, ExtendedViewSettingId::HeadTrackingRotateAxisSettingsWithHead },
+
+        { registry, ExtendedViewSettingId::CameraBoostEnabled },
+        { registry, ExtendedViewSettingId::GazeHeadMixEnabled }
     };
-    
+
     std::vector <SettingItem*> settings;
 
     for (auto& slider : settingsSliders)
         settings.push_back(&slider);
 
+    for (auto& compoundSlider : compoundSliders)
+        settings.push_back(&compoundSlider);
+
     for (auto& settingSwitch : settingsSwitches)
         settings.push_back(&settingSwitch);
 
-    ITobiiGameIntegrationApi* api = GetApi("Extended View Settings Sample");
+    ITobiiGameIntegrationApi* api = GetBackendApi("Extended View Settings Sample");
+    if (api == nullptr)
+    {
+        return;
+    }
     IExtendedView* extendedView = api->GetFeatures()->GetExtendedView();
 
     api->GetTrackerController()->TrackWindow(GetConsoleHwnd());
 
+    // The registry starts out invalidated, so this reads the current settings from the SDK
+    registry.Fetch(*extendedView);
+
     system("cls");
     std::cout << std::fixed << std::setprecision(3);
     PrintExtendedViewSettingsControl(settings, true); // true = force printing of settings even though no input changed
 
+    PacedScheduler frameRate{ 60.0 };
     while ((GetAsyncKeyState(VK_ESCAPE) & 0x8000) == 0)
     {
         api->Update();
-        extendedView->GetSettings(s);
-
-        PrintExtendedViewSettingsControl(settings);
 
-        bool anySettingChanged = false;
-        for (auto& setting : settings)
+        // Only reads from the SDK again if the registry was invalidated, e.g. because the SDK rejected the last settings sent
+        if (registry.Fetch(*extendedView))
         {
-            if (setting->m_valueChanged)
-            {
-                setting->m_valueChanged = false;
-                anySettingChanged = true;
-
-                // We handle changes to the compound settings Sliders by calling helper-functions which set multiple ExtendedViewSettings members
-                // Note that these helpers-functions overwrite some of the individual Setting members which are used in the detailed settings above for illustrative purposes
-                if (setting->m_name == "GazePlusHeadPitchLimitDegrees")
-                {
-                    GazeHeadMixHelpFunctions::SetCameraMaxAnglePitchUp(s.GazeHeadMix, s.HeadTracking, setting->GetValue());
-                    GazeHeadMixHelpFunctions::SetCameraMaxAnglePitchDown(s.GazeHeadMix, s.HeadTracking, -setting->GetValue()); // Pitch down is negative
-                }
-                else if (setting->m_name == "EyeToHeadLimitsRatio")
-                {
-                    GazeHeadMixHelpFunctions::SetEyeHeadTrackingRatio(s.GazeHeadMix, s.HeadTracking, setting->GetValue());
-                }
-                else if (setting->m_name == "HeadCenterStabilisation")
-                {
-                    HeadTrackingHelpFunctions::SetCenterStabilization(s.HeadTracking, setting->GetValue());
-                }
-                else if (setting->m_name == "HeadRotationSensitivity")
-                {
-                    HeadTrackingHelpFunctions::SetHeadAllRotationAxisSettingsSensitivity(s.HeadTracking, setting->GetValue());
-                }
-                if (setting->m_name == "RelativeHeadPositionEnabled")
-                {
-                    // RelativeHeadPosition is a flavor of extended view in which head position is applied relative to the current head rotation.
-                    // When enabled, turning head to the right 90 and then moving forward would result in movement "forward" in relation to the camera.
-                    // When disabled, turning head to the right 90 and then moving forward would result in movement "left" in relation to the camera.
-                    s.HeadTracking.RelativeHeadPositionEnabled = setting->GetValue() == 1.0f;
-                }
-                else if (setting->m_name == "RotateAxisSettingsWithHead")
-                {
-                    // Enables the rotation of AxisSettings together with Head. This setting relates to RelativeHeadPosition and is used only when RelativeHeadPosition is enabled.
-                    // When disabled, the initial AxisSettings are respected. If you restrict head movement forward-backward to 1mm and left-right to 200mm,
-                    // and then turn your head 90 to the right - you will have 1mm restriction on left-right head movement and 200mm forward-backward.
-                    // When enabled, the Axis Settings are applied in relation to rotated head pose. If you restrict head movement forward-backward to 1mm and left-right to 200mm,
-                    // and then turn your head 90 to the right - you will have 200mm restriction on left-right head movement and 1mm forward-backward.
-                    s.HeadTracking.RotateAxisSettingsWithHead = setting->GetValue() == 1.0f;
-                }
-                else if (setting->m_name == "CameraBoostEnabled")
-                {
-                    s.CameraBoost.Enabled = setting->GetValue() == 1.0f;
-                }
-                else if (setting->m_name == "GazeHeadMixEnabled")
-                {
-                    s.GazeHeadMix.Enabled = setting->GetValue() == 1.0f;
-                }
-            }
+            PrintExtendedViewSettingsControl(settings, true);
         }
 
-        if (anySettingChanged)
+        PrintExtendedViewSettingsControl(settings);
+
+        // All changes made this frame are sent in a single UpdateSettings call, and only if a setting actually changed
+        if (registry.Flush(*extendedView))
         {
-            extendedView->UpdateSettings(s);
             PrintExtendedViewSettingsControl(settings, true);
         }
 
         const Transformation extendedViewTransformation = extendedView->GetTransformation();
         std::cout << "Extended View (deg): [ Yaw: " << extendedViewTransformation.Rotation.YawDegrees << " , Pitch: " << extendedViewTransformation.Rotation.PitchDegrees << " ]" << "               \r";
 
-        Sleep(1000 / 60);
+        frameRate.WaitForNextTick();
     }
 
     api->Shutdown();
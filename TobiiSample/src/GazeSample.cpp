@@ -1,4 +1,6 @@
 #include "tobii_gameintegration.h"
+#include "ApiBackend.h"
+#include "PacedScheduler.h"
 #include <iostream>
 #include "windows.h"
 #include <thread>
@@ -7,11 +9,16 @@ using namespace TobiiGameIntegration;
 
 void GazeSample()
 {
-    ITobiiGameIntegrationApi* api = GetApi("Gaze Sample");
+    ITobiiGameIntegrationApi* api = GetBackendApi("Gaze Sample");
+    if (api == nullptr)
+    {
+        return;
+    }
     IStreamsProvider* streamsProvider = api->GetStreamsProvider();
 
     api->GetTrackerController()->TrackRectangle({0,0,1000,1000});
 
+    PacedScheduler frameRate{ 60.0 };
     while(!GetAsyncKeyState(VK_ESCAPE))
     {
         api->Update();
@@ -22,7 +29,7 @@ void GazeSample()
             std::cout << "Gaze point: [" << gazePoint.X << ", " << gazePoint.Y << "]" << std::endl;
         }
 
-        Sleep(1000 / 60);
+        frameRate.WaitForNextTick();
     }
 
     api->Shutdown();
@@ -1,4 +1,6 @@
 #include "tobii_gameintegration.h"
+#include "ApiBackend.h"
+#include "PacedScheduler.h"
 #include <iostream>
 #include "windows.h"
 
@@ -6,11 +8,16 @@ using namespace TobiiGameIntegration;
 
 void HeadMountedDisplaySample()
 {
-    ITobiiGameIntegrationApi* api = GetApi("Head mounted display sample");
+    ITobiiGameIntegrationApi* api = GetBackendApi("Head mounted display sample");
+    if (api == nullptr)
+    {
+        return;
+    }
     IStreamsProvider* streamsProvider = api->GetStreamsProvider();
 
     api->GetTrackerController()->TrackHMD();
 
+    PacedScheduler frameRate{ 60.0 };
     while (!GetAsyncKeyState(VK_ESCAPE))
     {
         api->Update();
@@ -37,7 +44,7 @@ void HeadMountedDisplaySample()
             std::cout << "Timestamp" << hmdGaze.Timestamp << std::endl;
         }
 
-        Sleep(1000 / 60);
+        frameRate.WaitForNextTick();
     }
 
     api->Shutdown();
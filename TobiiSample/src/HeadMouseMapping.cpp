@@ -0,0 +1,130 @@
+#include "HeadMouseMapping.h"
+#include "MappingKernel.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace TobiiGameIntegration;
+
+HeadMouseMapper::HeadMouseMapper(const MappingSettings& settings)
+	: m_settings{ settings }
+{ }
+
+void HeadMouseMapper::DesiredCounts(const Rotation& rotation, float& desiredYaw, float& desiredPitch) const
+{
+	if (m_curves != nullptr)
+	{
+		desiredYaw = m_curves->Yaw.Evaluate(rotation.YawDegrees);
+		desiredPitch = m_curves->Pitch.Evaluate(rotation.PitchDegrees);
+		return;
+	}
+
+	desiredYaw = rotation.YawDegrees;
+	bool yawDead = std::abs(desiredYaw) < m_settings.DeadYawIRL;
+	desiredYaw = std::clamp(desiredYaw, -m_settings.MaxYawIRL, m_settings.MaxYawIRL);
+	if (!yawDead)
+	{
+		desiredYaw -= m_settings.DeadYawIRL * (desiredYaw >= 0.0f ? 1.0f : -1.0f);
+	}
+
+	desiredPitch = rotation.PitchDegrees;
+	bool pitchDead = std::abs(desiredPitch) < m_settings.DeadPitchIRL;
+	desiredPitch = std::clamp(desiredPitch, -m_settings.MaxPitchIRL, m_settings.MaxPitchIRL);
+	if (!pitchDead)
+	{
+		desiredPitch -= m_settings.DeadPitchIRL * (desiredPitch >= 0.0f ? 1.0f : -1.0f);
+	}
+
+	desiredYaw *= m_settings.Sens;
+	desiredPitch *= m_settings.Sens * m_settings.YSensMult;
+
+	if (yawDead)
+	{
+		desiredYaw = 0.0f;
+	}
+	if (pitchDead)
+	{
+		desiredPitch = 0.0f;
+	}
+}
+
+MouseDelta HeadMouseMapper::Map(const Rotation& rotation, int64_t timeStampMicroSeconds)
+{
+	float desiredYaw, desiredPitch;
+	DesiredCounts(rotation, desiredYaw, desiredPitch);
+	return Advance(desiredYaw, desiredPitch, timeStampMicroSeconds);
+}
+
+MouseDelta HeadMouseMapper::Advance(float desiredYaw, float desiredPitch, int64_t timeStampMicroSeconds)
+{
+	auto desiredDeltaYaw = desiredYaw - m_actualYaw;
+	auto desiredDeltaPitch = desiredPitch - m_actualPitch;
+
+	long dx = static_cast<long>(std::round(desiredDeltaYaw));
+	long minusDy = static_cast<long>(std::round(desiredDeltaPitch));
+
+	m_actualYaw += static_cast<float>(dx);
+	m_actualPitch += static_cast<float>(minusDy);
+
+	return { dx, minusDy, timeStampMicroSeconds };
+}
+
+void HeadMouseMapper::Resync(const Rotation& rotation)
+{
+	float desiredYaw, desiredPitch;
+	DesiredCounts(rotation, desiredYaw, desiredPitch);
+	m_actualYaw = std::round(desiredYaw);
+	m_actualPitch = std::round(desiredPitch);
+}
+
+void HeadMouseMapper::ResyncHeadPose(const HeadPose& headPose)
+{
+	Rotation rotation = headPose.Rotation;
+	rotation.YawDegrees *= m_settings.HeadPoseYawScale;
+	rotation.PitchDegrees *= m_settings.HeadPosePitchScale;
+	Resync(rotation);
+}
+
+int HeadMouseMapper::MapHeadPoses(const HeadPose* headPoses, int count, MouseDelta* deltas)
+{
+	int written = 0;
+	if (m_curves != nullptr)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			Rotation rotation = headPoses[i].Rotation;
+			rotation.YawDegrees *= m_settings.HeadPoseYawScale;
+			rotation.PitchDegrees *= m_settings.HeadPosePitchScale;
+
+			const MouseDelta delta = Map(rotation, headPoses[i].TimeStampMicroSeconds);
+			if (delta.Dx || delta.MinusDy)
+			{
+				deltas[written++] = delta;
+			}
+		}
+		return written;
+	}
+
+	// Deadzone, clamp and sens vectorized over the batch; the deltas depend on each other so stay scalar
+	static constexpr int k_chunk = 64;
+	float yaw[k_chunk], pitch[k_chunk], desiredYaw[k_chunk], desiredPitch[k_chunk];
+	for (int first = 0; first < count; first += k_chunk)
+	{
+		const int chunk = (std::min)(k_chunk, count - first);
+		for (int i = 0; i < chunk; i++)
+		{
+			yaw[i] = headPoses[first + i].Rotation.YawDegrees;
+			pitch[i] = headPoses[first + i].Rotation.PitchDegrees;
+		}
+		ComputeDesiredCounts(m_settings, yaw, pitch, desiredYaw, desiredPitch, chunk);
+
+		for (int i = 0; i < chunk; i++)
+		{
+			const MouseDelta delta = Advance(desiredYaw[i], desiredPitch[i], headPoses[first + i].TimeStampMicroSeconds);
+			if (delta.Dx || delta.MinusDy)
+			{
+				deltas[written++] = delta;
+			}
+		}
+	}
+	return written;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ResponseCurve.h"
+#include "TobiiPlatform.h"
+#include <cstdint>
+
+// Absolute head-angle to mouse-position mapping used by MyNewMain.cpp.
+// Angles are in Extended View degrees, outputs are mouse counts.
+struct MappingSettings
+{
+	float Sens;
+	float YSensMult;
+	float DeadYawIRL;
+	float DeadPitchIRL;
+	float MaxYawIRL;
+	float MaxPitchIRL;
+
+	// Raw HeadPose rotation is not scaled by the Extended View axis settings,
+	// GetTransformation() is. These bring raw poses onto the same scale so one set of
+	// numbers works for both paths (HeadTracking.*.SensitivityScaling, 2.0 by default).
+	float HeadPoseYawScale = 1.0f;
+	float HeadPosePitchScale = 1.0f;
+};
+
+struct MouseDelta
+{
+	long Dx;
+	long MinusDy;
+	int64_t TimeStampMicroSeconds;
+};
+
+class HeadMouseMapper
+{
+public:
+	explicit HeadMouseMapper(const MappingSettings& settings);
+
+	// Response curves to use instead of the deadzone/clamp/sens in MappingSettings, nullptr to go back.
+	// The curves are not copied and must outlive their use here.
+	void SetCurves(const ResponseCurves* curves) { m_curves = curves; }
+	const ResponseCurves* GetCurves() const { return m_curves; }
+
+	// Desired absolute cursor offset in counts for the given rotation (deadzone, clamp, sens).
+	void DesiredCounts(const TobiiGameIntegration::Rotation& rotation, float& desiredYaw, float& desiredPitch) const;
+
+	// Maps one Extended View rotation and advances the emitted position by the rounded delta.
+	MouseDelta Map(const TobiiGameIntegration::Rotation& rotation, int64_t timeStampMicroSeconds);
+
+	// Maps raw head poses in order, one delta per sample. Only non-zero deltas are written,
+	// each stamped with the time of the sample that produced it.
+	// deltas must have room for count entries. Returns the number of deltas written.
+	int MapHeadPoses(const TobiiGameIntegration::HeadPose* headPoses, int count, MouseDelta* deltas);
+
+	// Moves the emitted position to where the rotation maps without emitting anything, so output that
+	// was held back (cursor visible, paused) resumes without a jump. The HeadPose version applies
+	// the HeadPose scale like MapHeadPoses().
+	void Resync(const TobiiGameIntegration::Rotation& rotation);
+	void ResyncHeadPose(const TobiiGameIntegration::HeadPose& headPose);
+
+	const MappingSettings& GetSettings() const { return m_settings; }
+	float GetActualYaw() const { return m_actualYaw; }
+	float GetActualPitch() const { return m_actualPitch; }
+
+private:
+	// Emits the rounded difference to the desired position and advances the emitted position by it.
+	MouseDelta Advance(float desiredYaw, float desiredPitch, int64_t timeStampMicroSeconds);
+
+	MappingSettings m_settings;
+	const ResponseCurves* m_curves = nullptr;
+	float m_actualYaw = 0.0f;
+	float m_actualPitch = 0.0f;
+};
@@ -0,0 +1,195 @@
+#include "HeadPoseFilter.h"
+#include "Clock.h"
+#include <cmath>
+#include <sstream>
+
+using namespace TobiiGameIntegration;
+
+static constexpr float k_twoPi = 6.28318531f;
+
+// Smoothing factor of a first order low-pass with this cutoff, for a step of dt seconds.
+static float LowPassAlpha(float cutoffHz, float dt)
+{
+	const float tau = 1.0f / (k_twoPi * cutoffHz);
+	return 1.0f / (1.0f + tau / dt);
+}
+
+static std::array<float*, HeadPoseFilter::k_axisCount> Axes(HeadPose& headPose)
+{
+	return { &headPose.Rotation.YawDegrees, &headPose.Rotation.PitchDegrees, &headPose.Rotation.RollDegrees,
+		&headPose.Position.X, &headPose.Position.Y, &headPose.Position.Z };
+}
+
+void HeadPoseFilter::AddStage(const FilterStageSettings& settings)
+{
+	if (m_stageCount < k_maxStages)
+	{
+		m_stages[m_stageCount++] = Stage{ settings };
+	}
+}
+
+void HeadPoseFilter::Reset()
+{
+	for (Stage& stage : m_stages)
+	{
+		stage.HasState = false;
+	}
+}
+
+void HeadPoseFilter::FilterHeadPoses(HeadPose* headPoses, int count)
+{
+	for (int i = 0; i < m_stageCount; i++)
+	{
+		Stage& stage = m_stages[i];
+		const int64_t start = NowNanoSeconds();
+		FilterStage(stage, headPoses, count);
+		stage.Stats.NanoSeconds += NowNanoSeconds() - start;
+		stage.Stats.Samples += count;
+	}
+}
+
+void HeadPoseFilter::FilterStage(Stage& stage, HeadPose* headPoses, int count)
+{
+	const FilterStageSettings& settings = stage.Settings;
+	for (int i = 0; i < count; i++)
+	{
+		const std::array<float*, k_axisCount> values = Axes(headPoses[i]);
+		const int64_t elapsed = headPoses[i].TimeStampMicroSeconds - stage.LastTimeStamp;
+
+		if (!stage.HasState || elapsed > k_maxGapMicroSeconds)
+		{
+			for (int axis = 0; axis < k_axisCount; axis++)
+			{
+				stage.Axes[axis] = { *values[axis] };
+			}
+			stage.LastTimeStamp = headPoses[i].TimeStampMicroSeconds;
+			stage.HasState = true;
+			continue;
+		}
+		if (elapsed <= 0)
+		{
+			for (int axis = 0; axis < k_axisCount; axis++)
+			{
+				*values[axis] = stage.Axes[axis].Value;
+			}
+			continue;
+		}
+
+		const float dt = elapsed * 1e-6f;
+		if (settings.Type == FilterStageType::Ema)
+		{
+			const float alpha = LowPassAlpha(settings.MinCutoffHz, dt);
+			for (int axis = 0; axis < k_axisCount; axis++)
+			{
+				AxisState& state = stage.Axes[axis];
+				state.Value += alpha * (*values[axis] - state.Value);
+				*values[axis] = state.Value;
+			}
+		}
+		else
+		{
+			const float derivativeAlpha = LowPassAlpha(settings.DerivativeCutoffHz, dt);
+			for (int axis = 0; axis < k_axisCount; axis++)
+			{
+				AxisState& state = stage.Axes[axis];
+				const float speed = (*values[axis] - state.Value) / dt;
+				state.Derivative += derivativeAlpha * (speed - state.Derivative);
+				const float cutoff = settings.MinCutoffHz + settings.Beta * std::abs(state.Derivative);
+				state.Value += LowPassAlpha(cutoff, dt) * (*values[axis] - state.Value);
+				*values[axis] = state.Value;
+			}
+		}
+		stage.LastTimeStamp = headPoses[i].TimeStampMicroSeconds;
+	}
+}
+
+static bool ParseStage(const std::string& text, FilterStageSettings& settings)
+{
+	const size_t colon = text.find(':');
+	const std::string type = text.substr(0, colon);
+	if (type == "ema")
+	{
+		settings.Type = FilterStageType::Ema;
+		settings.MinCutoffHz = 10.0f;
+	}
+	else if (type != "oneeuro")
+	{
+		return false;
+	}
+
+	std::istringstream entries{ colon == std::string::npos ? "" : text.substr(colon + 1) };
+	std::string entry;
+	while (std::getline(entries, entry, ','))
+	{
+		const size_t equals = entry.find('=');
+		const std::string key = entry.substr(0, equals);
+		float value;
+		try
+		{
+			value = std::stof(equals == std::string::npos ? "" : entry.substr(equals + 1));
+		}
+		catch (const std::exception&)
+		{
+			return false;
+		}
+
+		if ((key == "cutoff" && settings.Type == FilterStageType::Ema) || (key == "mincutoff" && settings.Type == FilterStageType::OneEuro))
+		{
+			settings.MinCutoffHz = value;
+		}
+		else if (key == "beta" && settings.Type == FilterStageType::OneEuro)
+		{
+			settings.Beta = value;
+		}
+		else if (key == "dcutoff" && settings.Type == FilterStageType::OneEuro)
+		{
+			settings.DerivativeCutoffHz = value;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return settings.MinCutoffHz > 0.0f && settings.DerivativeCutoffHz > 0.0f && settings.Beta >= 0.0f;
+}
+
+bool ParseFilterChain(const std::string& spec, HeadPoseFilter& filter, std::string& error)
+{
+	if (spec.empty() || spec == "off")
+	{
+		return true;
+	}
+
+	std::istringstream stages{ spec };
+	std::string text;
+	while (std::getline(stages, text, '+'))
+	{
+		FilterStageSettings settings;
+		if (!ParseStage(text, settings))
+		{
+			error = "bad filter stage '" + text + "'";
+			return false;
+		}
+		if (filter.GetStageCount() == HeadPoseFilter::k_maxStages)
+		{
+			error = "too many filter stages, at most " + std::to_string(HeadPoseFilter::k_maxStages);
+			return false;
+		}
+		filter.AddStage(settings);
+	}
+	return true;
+}
+
+std::string DescribeFilterStage(const FilterStageSettings& settings)
+{
+	std::ostringstream text;
+	if (settings.Type == FilterStageType::Ema)
+	{
+		text << "ema cutoff=" << settings.MinCutoffHz;
+	}
+	else
+	{
+		text << "oneeuro mincutoff=" << settings.MinCutoffHz << " beta=" << settings.Beta << " dcutoff=" << settings.DerivativeCutoffHz;
+	}
+	return text.str();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "TobiiPlatform.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Optional smoothing between GetHeadPoses() and the predictor/mapper: a short chain of per-axis
+// low-pass stages over all six axes of the pose, driven by the real sample timestamps. Compared to
+// a wide deadzone it removes tracker noise without the static offset, and the One Euro stage keeps
+// the lag low while the head moves.
+enum class FilterStageType
+{
+	Ema,		// fixed cutoff
+	OneEuro,	// cutoff rises with speed: MinCutoffHz when still, + Beta * |speed|
+};
+
+struct FilterStageSettings
+{
+	FilterStageType Type = FilterStageType::OneEuro;
+	float MinCutoffHz = 1.0f;			// Ema: the cutoff
+	float Beta = 0.05f;					// OneEuro: Hz per degree (millimeter for position) per second
+	float DerivativeCutoffHz = 1.0f;	// OneEuro: smoothing of the speed estimate
+};
+
+struct FilterStageStats
+{
+	uint64_t Samples = 0;
+	uint64_t NanoSeconds = 0;
+};
+
+class HeadPoseFilter
+{
+public:
+	static constexpr int k_maxStages = 4;
+	static constexpr int k_axisCount = 6;	// yaw, pitch, roll, x, y, z
+
+	HeadPoseFilter() = default;
+
+	// Stages beyond k_maxStages are rejected by ParseFilterChain(), not here.
+	void AddStage(const FilterStageSettings& settings);
+	int GetStageCount() const { return m_stageCount; }
+	bool IsEnabled() const { return m_stageCount > 0; }
+
+	// Forgets the history, the next pose passes through.
+	void Reset();
+
+	// Filters the poses in place, in order, one stage at a time over the whole batch. Poses with a
+	// timestamp at or before the previous one get the previous output; gaps longer than
+	// k_maxGapMicroSeconds (dropouts, presence loss) restart the filter.
+	void FilterHeadPoses(TobiiGameIntegration::HeadPose* headPoses, int count);
+
+	// Time spent per stage, for the benchmark reports. Written by the filtering thread only.
+	const FilterStageStats& GetStageStats(int stage) const { return m_stages[stage].Stats; }
+	const FilterStageSettings& GetStageSettings(int stage) const { return m_stages[stage].Settings; }
+
+	static constexpr int64_t k_maxGapMicroSeconds = 100'000;
+
+private:
+	struct AxisState
+	{
+		float Value = 0.0f;
+		float Derivative = 0.0f;
+	};
+
+	struct Stage
+	{
+		FilterStageSettings Settings;
+		std::array<AxisState, k_axisCount> Axes;
+		int64_t LastTimeStamp = 0;
+		bool HasState = false;
+		FilterStageStats Stats;
+	};
+
+	static void FilterStage(Stage& stage, TobiiGameIntegration::HeadPose* headPoses, int count);
+
+	std::array<Stage, k_maxStages> m_stages;
+	int m_stageCount = 0;
+};
+
+// Parses stages separated by '+', each "<type>[:key=value,...]":
+//   ema:cutoff=<Hz>
+//   oneeuro:mincutoff=<Hz>,beta=<Hz per unit/s>,dcutoff=<Hz>
+// e.g. "oneeuro:mincutoff=0.5,beta=0.1+ema:cutoff=30". "off" or "" leaves the filter empty.
+bool ParseFilterChain(const std::string& spec, HeadPoseFilter& filter, std::string& error);
+
+// Describes a stage for reports, e.g. "oneeuro mincutoff=1 beta=0.05 dcutoff=1".
+std::string DescribeFilterStage(const FilterStageSettings& settings);
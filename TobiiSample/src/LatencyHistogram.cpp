@@ -0,0 +1,114 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+
+LatencyHistogram::LatencyHistogram()
+{
+	Reset();
+}
+
+int LatencyHistogram::BucketIndex(uint64_t value)
+{
+	static constexpr uint64_t k_maxValue = (uint64_t{ 1 } << k_maxValueBits) - 1;
+	value = (std::min)(value, k_maxValue);
+	if (value < (uint64_t{ 1 } << k_linearBits))
+	{
+		return static_cast<int>(value);
+	}
+	const int exponent = static_cast<int>(std::bit_width(value)) - k_linearBits;
+	const int subBucket = static_cast<int>(value >> exponent);	// [64, 128)
+	return exponent * k_halfBucketCount + subBucket;
+}
+
+int64_t LatencyHistogram::BucketHighestValue(int index)
+{
+	if (index < (1 << k_linearBits))
+	{
+		return index;
+	}
+	const int exponent = index / k_halfBucketCount - 1;
+	const int64_t subBucket = index - exponent * k_halfBucketCount;
+	return ((subBucket + 1) << exponent) - 1;
+}
+
+void LatencyHistogram::Record(int64_t value)
+{
+	value = (std::max)(value, int64_t{ 0 });
+	m_buckets[BucketIndex(static_cast<uint64_t>(value))]++;
+	m_min = m_count ? (std::min)(m_min, value) : value;
+	m_max = m_count ? (std::max)(m_max, value) : value;
+	m_sum += value;
+	m_count++;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+	if (other.m_count == 0)
+	{
+		return;
+	}
+	for (int i = 0; i < k_bucketCount; i++)
+	{
+		m_buckets[i] += other.m_buckets[i];
+	}
+	m_min = m_count ? (std::min)(m_min, other.m_min) : other.m_min;
+	m_max = m_count ? (std::max)(m_max, other.m_max) : other.m_max;
+	m_sum += other.m_sum;
+	m_count += other.m_count;
+}
+
+void LatencyHistogram::Reset()
+{
+	std::fill(std::begin(m_buckets), std::end(m_buckets), uint64_t{ 0 });
+	m_count = 0;
+	m_min = 0;
+	m_max = 0;
+	m_sum = 0;
+}
+
+int64_t LatencyHistogram::GetPercentile(double percentile) const
+{
+	if (m_count == 0)
+	{
+		return 0;
+	}
+	const double clamped = std::clamp(percentile, 0.0, 100.0);
+	const uint64_t rank = (std::max)(uint64_t{ 1 }, static_cast<uint64_t>(clamped / 100.0 * m_count + 0.5));
+
+	uint64_t seen = 0;
+	for (int i = 0; i < k_bucketCount; i++)
+	{
+		seen += m_buckets[i];
+		if (seen >= rank)
+		{
+			return std::clamp(BucketHighestValue(i), m_min, m_max);
+		}
+	}
+	return m_max;
+}
+
+void LatencyHistogram::Print(std::ostream& out, const char* title, const char* unit) const
+{
+	out << title << ": " << m_count << " values";
+	if (m_count == 0)
+	{
+		out << std::endl;
+		return;
+	}
+	// Restored at the end, the caller's later output keeps its own format
+	const std::ios_base::fmtflags flags = out.flags();
+	const std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(1) << ", mean " << GetMean() << " " << unit << std::endl;
+	out << "  min " << GetMin() << ", p50 " << GetPercentile(50.0) << ", p95 " << GetPercentile(95.0) <<
+		", p99 " << GetPercentile(99.0) << ", max " << GetMax() << " " << unit << std::endl;
+
+	static constexpr double k_percentiles[] = { 0.0, 10.0, 25.0, 50.0, 75.0, 90.0, 95.0, 99.0, 99.9, 99.99, 100.0 };
+	out << "  " << std::setw(10) << "percentile" << std::setw(12) << unit << std::endl;
+	for (double percentile : k_percentiles)
+	{
+		out << "  " << std::setw(10) << std::setprecision(2) << percentile << std::setw(12) << GetPercentile(percentile) << std::endl;
+	}
+	out.flags(flags);
+	out.precision(precision);
+}
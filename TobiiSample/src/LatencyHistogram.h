@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+// Fixed-size log-linear histogram for non-negative integer values (microseconds), HdrHistogram style:
+// values below 128 get their own bucket, above that every power of two is split into 64 linear
+// buckets, so any reported value is within 1/64 (1.6%) of a recorded one. Record() never allocates.
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	void Record(int64_t value);
+	void Merge(const LatencyHistogram& other);
+	void Reset();
+
+	uint64_t GetCount() const { return m_count; }
+	int64_t GetMin() const { return m_count ? m_min : 0; }
+	int64_t GetMax() const { return m_count ? m_max : 0; }
+	double GetMean() const { return m_count ? static_cast<double>(m_sum) / m_count : 0.0; }
+	// Smallest bucket value at or below which `percentile` percent of the recorded values fall.
+	int64_t GetPercentile(double percentile) const;
+
+	// Summary line plus a percentile distribution table.
+	void Print(std::ostream& out, const char* title, const char* unit = "us") const;
+
+private:
+	static constexpr int k_linearBits = 7;
+	static constexpr int k_halfBucketCount = 1 << (k_linearBits - 1);
+	static constexpr int k_maxValueBits = 40;
+	static constexpr int k_bucketCount = (k_maxValueBits - k_linearBits + 2) * k_halfBucketCount;
+
+	static int BucketIndex(uint64_t value);
+	static int64_t BucketHighestValue(int index);
+
+	uint64_t m_buckets[k_bucketCount];
+	uint64_t m_count = 0;
+	int64_t m_min = 0;
+	int64_t m_max = 0;
+	int64_t m_sum = 0;
+};
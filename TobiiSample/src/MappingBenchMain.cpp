@@ -0,0 +1,194 @@
+// Microbenchmark and bit-exactness check for the batch mapping kernel in MappingKernel.h.
+// Build it instead of MyNewMain.cpp, e.g. on Linux:
+//   g++ -std=c++20 -O2 -fpermissive -Ivendor/tobii/include src/MappingBenchMain.cpp src/MappingKernel.cpp
+//       src/HeadMouseMapping.cpp src/ResponseCurve.cpp src/StrategySettings.cpp -o mapping-bench
+// Usage: mapping-bench [samples]
+#include "HeadMouseMapping.h"
+#include "MappingKernel.h"
+#include "SquadTuning.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace TobiiGameIntegration;
+
+static constexpr int k_repeats = 20;
+
+// Values around every boundary of the scalar code, for both signs.
+static std::vector<float> EdgeValues(const MappingSettings& settings)
+{
+	std::vector<float> values = { 0.0f, std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(),
+		std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::max(), 1e-30f, 0.5f, 1e6f };
+	for (float boundary : { settings.DeadYawIRL, settings.DeadPitchIRL, settings.MaxYawIRL, settings.MaxPitchIRL })
+	{
+		for (float scale : { 1.0f, settings.HeadPoseYawScale, settings.HeadPosePitchScale })
+		{
+			const float value = boundary / scale;
+			values.push_back(value);
+			values.push_back(std::nextafter(value, 0.0f));
+			values.push_back(std::nextafter(value, 1e9f));
+		}
+	}
+	const size_t positive = values.size();
+	for (size_t i = 0; i < positive; i++)
+	{
+		values.push_back(-values[i]);
+	}
+	return values;
+}
+
+static bool SameBits(float a, float b)
+{
+	return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// Checks every SIMD level against HeadMouseMapper::DesiredCounts(), then MapHeadPoses() against Map().
+static bool CheckBitExact(const MappingSettings& settings, const HeadPoseColumns& poses)
+{
+	const size_t count = poses.Size();
+	std::vector<float> referenceYaw(count), referencePitch(count);
+	HeadMouseMapper reference{ settings };
+	for (size_t i = 0; i < count; i++)
+	{
+		Rotation rotation;
+		rotation.YawDegrees = poses.Yaw[i] * settings.HeadPoseYawScale;
+		rotation.PitchDegrees = poses.Pitch[i] * settings.HeadPosePitchScale;
+		reference.DesiredCounts(rotation, referenceYaw[i], referencePitch[i]);
+	}
+
+	bool ok = true;
+	std::vector<float> desiredYaw(count), desiredPitch(count);
+	for (SimdLevel level = SimdLevel::Scalar; level <= GetSupportedSimdLevel(); level = static_cast<SimdLevel>(static_cast<int>(level) + 1))
+	{
+		ComputeDesiredCounts(settings, poses.Yaw.data(), poses.Pitch.data(), desiredYaw.data(), desiredPitch.data(), count, level);
+		size_t mismatches = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			if (!SameBits(desiredYaw[i], referenceYaw[i]) || !SameBits(desiredPitch[i], referencePitch[i]))
+			{
+				if (mismatches++ == 0)
+				{
+					std::cout << "  first mismatch at yaw " << poses.Yaw[i] << ", pitch " << poses.Pitch[i] << ": " << desiredYaw[i] << "/" << desiredPitch[i] <<
+						" instead of " << referenceYaw[i] << "/" << referencePitch[i] << std::endl;
+				}
+			}
+		}
+		std::cout << "  " << GetSimdLevelName(level) << ": " << (mismatches == 0 ? "bit-exact" : "MISMATCH") << " over " << count << " samples" << std::endl;
+		ok &= mismatches == 0;
+	}
+
+	// The batched deltas must equal the one-pose-at-a-time path
+	HeadMouseMapper batched{ settings }, single{ settings };
+	std::vector<HeadPose> headPoses(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		headPoses[i].Rotation.YawDegrees = poses.Yaw[i];
+		headPoses[i].Rotation.PitchDegrees = poses.Pitch[i];
+		headPoses[i].TimeStampMicroSeconds = poses.TimeStampMicroSeconds[i];
+	}
+	std::vector<MouseDelta> deltas(count);
+	const int deltaCount = batched.MapHeadPoses(headPoses.data(), static_cast<int>(count), deltas.data());
+	int expected = 0;
+	bool deltasMatch = true;
+	for (size_t i = 0; i < count; i++)
+	{
+		Rotation rotation = headPoses[i].Rotation;
+		rotation.YawDegrees *= settings.HeadPoseYawScale;
+		rotation.PitchDegrees *= settings.HeadPosePitchScale;
+		const MouseDelta delta = single.Map(rotation, headPoses[i].TimeStampMicroSeconds);
+		if (delta.Dx || delta.MinusDy)
+		{
+			const MouseDelta& other = deltas[expected++];
+			deltasMatch &= expected <= deltaCount && other.Dx == delta.Dx && other.MinusDy == delta.MinusDy &&
+				other.TimeStampMicroSeconds == delta.TimeStampMicroSeconds;
+		}
+	}
+	deltasMatch &= expected == deltaCount;
+	std::cout << "  MapHeadPoses: " << (deltasMatch ? "same deltas as Map()" : "MISMATCH") << ", " << deltaCount << " deltas" << std::endl;
+	return ok && deltasMatch;
+}
+
+template <typename Function>
+static double SamplesPerSecond(size_t samples, Function&& function)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (int repeat = 0; repeat < k_repeats; repeat++)
+	{
+		function();
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return samples * static_cast<double>(k_repeats) / seconds;
+}
+
+int main(int argc, char** argv)
+{
+	const size_t sampleCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t{ 1 } << 20;
+
+	MappingSettings settings = SquadMappingSettings();
+	settings.HeadPoseYawScale = 2.0f;
+	settings.HeadPosePitchScale = 2.0f;
+	MappingSettings pitchSettings = settings;
+	pitchSettings.YSensMult = 0.25f;
+	pitchSettings.MaxPitchIRL = 100.0f / (pitchSettings.Sens * pitchSettings.YSensMult) + pitchSettings.DeadPitchIRL;
+
+	// Random head motion with the edge values mixed in
+	std::mt19937 random{ 1 };
+	std::uniform_real_distribution<float> yawDistribution{ -60.0f, 60.0f };
+	std::uniform_real_distribution<float> pitchDistribution{ -40.0f, 40.0f };
+	const std::vector<float> edges = EdgeValues(pitchSettings);
+	std::vector<HeadPose> headPoses(sampleCount);
+	for (size_t i = 0; i < sampleCount; i++)
+	{
+		headPoses[i].Rotation.YawDegrees = i % 64 == 0 ? edges[(i / 64) % edges.size()] : yawDistribution(random);
+		headPoses[i].Rotation.PitchDegrees = i % 64 == 1 ? edges[(i / 64) % edges.size()] : pitchDistribution(random);
+		headPoses[i].TimeStampMicroSeconds = static_cast<int64_t>(i) * 1000;
+	}
+	HeadPoseColumns columns;
+	columns.Append(headPoses.data(), headPoses.size());
+
+	std::cout << "Supported: " << GetSimdLevelName(GetSupportedSimdLevel()) << std::endl;
+	std::cout << "Bit-exactness, pitch off:" << std::endl;
+	bool ok = CheckBitExact(settings, columns);
+	std::cout << "Bit-exactness, pitch on:" << std::endl;
+	ok &= CheckBitExact(pitchSettings, columns);
+
+	std::vector<float> desiredYaw(sampleCount), desiredPitch(sampleCount);
+	std::cout << "Throughput over " << sampleCount << " samples x " << k_repeats << ":" << std::endl;
+
+	HeadMouseMapper reference{ pitchSettings };
+	const double scalarReference = SamplesPerSecond(sampleCount, [&]
+	{
+		for (size_t i = 0; i < sampleCount; i++)
+		{
+			Rotation rotation;
+			rotation.YawDegrees = columns.Yaw[i] * pitchSettings.HeadPoseYawScale;
+			rotation.PitchDegrees = columns.Pitch[i] * pitchSettings.HeadPosePitchScale;
+			reference.DesiredCounts(rotation, desiredYaw[i], desiredPitch[i]);
+		}
+	});
+	std::cout << "  DesiredCounts() per pose: " << scalarReference / 1e6 << " M samples/s" << std::endl;
+
+	for (SimdLevel level = SimdLevel::Scalar; level <= GetSupportedSimdLevel(); level = static_cast<SimdLevel>(static_cast<int>(level) + 1))
+	{
+		const double rate = SamplesPerSecond(sampleCount, [&]
+		{
+			ComputeDesiredCounts(pitchSettings, columns.Yaw.data(), columns.Pitch.data(), desiredYaw.data(), desiredPitch.data(), sampleCount, level);
+		});
+		std::cout << "  kernel " << GetSimdLevelName(level) << ": " << rate / 1e6 << " M samples/s (" << rate / scalarReference << "x)" << std::endl;
+	}
+
+	std::vector<MouseDelta> deltas(sampleCount);
+	const double mapRate = SamplesPerSecond(sampleCount, [&]
+	{
+		HeadMouseMapper mapper{ pitchSettings };
+		mapper.MapHeadPoses(headPoses.data(), static_cast<int>(sampleCount), deltas.data());
+	});
+	std::cout << "  MapHeadPoses() with deltas: " << mapRate / 1e6 << " M samples/s" << std::endl;
+
+	return ok ? 0 : 1;
+}
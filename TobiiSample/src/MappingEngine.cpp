@@ -0,0 +1,243 @@
+#include "MappingEngine.h"
+#include "RateIntegrator.h"
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstdlib>
+
+using namespace TobiiGameIntegration;
+
+// Strategy policies. Each one is a plain struct the engine template calls directly, so everything it
+// does per pose is inlined into the batch loop:
+//   MouseDelta Step(float yaw, float pitch, int64_t timeStampMicroSeconds, bool isModifierHeld)
+//   void Resync(float yaw, float pitch, int64_t timeStampMicroSeconds)
+//   float GetActualYaw() const, float GetActualPitch() const
+// Angles come in already multiplied by the HeadPose scales, so they are on the Extended View scale the
+// old mains' constants were tuned for. A strategy may also provide MapHeadPoses() for the whole batch.
+
+// Counts emitted so far, for the strategies that only produce relative motion.
+struct EmittedPosition
+{
+	MouseDelta Emit(long dx, long minusDy, int64_t timeStampMicroSeconds)
+	{
+		m_actualYaw += static_cast<float>(dx);
+		m_actualPitch += static_cast<float>(minusDy);
+		return { dx, minusDy, timeStampMicroSeconds };
+	}
+
+	float GetActualYaw() const { return m_actualYaw; }
+	float GetActualPitch() const { return m_actualPitch; }
+
+private:
+	float m_actualYaw = 0.0f;
+	float m_actualPitch = 0.0f;
+};
+
+// MyNewMain.cpp: HeadMouseMapper as it is, batch kernel included.
+struct AbsoluteStrategy
+{
+	static constexpr MappingStrategyKind k_kind = MappingStrategyKind::Absolute;
+
+	AbsoluteStrategy(const StrategySettings&, const MappingSettings& mappingSettings)
+		: m_mapper{ mappingSettings }
+	{ }
+
+	int MapHeadPoses(const HeadPose* headPoses, int count, MouseDelta* deltas) { return m_mapper.MapHeadPoses(headPoses, count, deltas); }
+	void ResyncHeadPose(const HeadPose& headPose) { m_mapper.ResyncHeadPose(headPose); }
+	void SetCurves(const ResponseCurves* curves) { m_mapper.SetCurves(curves); }
+	float GetActualYaw() const { return m_mapper.GetActualYaw(); }
+	float GetActualPitch() const { return m_mapper.GetActualPitch(); }
+
+private:
+	HeadMouseMapper m_mapper;
+};
+
+// The old MyMain.cpp: the angle beyond a radial deadzone sets the cursor speed, integrated by a RateIntegrator
+// on the pose timestamps, so a late loop iteration no longer shows up as a speed spike.
+struct RateStrategy : EmittedPosition
+{
+	static constexpr MappingStrategyKind k_kind = MappingStrategyKind::Rate;
+
+	RateStrategy(const StrategySettings& settings, const MappingSettings&)
+		: m_settings{ settings },
+		m_integrator{ std::llround(settings.StepMilliSeconds * 1000.0), std::llround(settings.MaxCatchUpMilliSeconds * 1000.0) }
+	{ }
+
+	MouseDelta Step(float yaw, float pitch, int64_t timeStampMicroSeconds, bool)
+	{
+		// The deadzone is taken off the length of the (yaw, pitch) vector, not off each axis
+		const float distance = std::sqrt(yaw * yaw + pitch * pitch);
+		const float excess = distance > m_settings.DeadRadiusDegrees ? (distance - m_settings.DeadRadiusDegrees) / distance : 0.0f;
+		const float speedX = std::clamp(yaw * excess * m_settings.SpeedYaw, -m_settings.MaxSpeed, m_settings.MaxSpeed);
+		const float speedMinusY = std::clamp(pitch * excess * m_settings.SpeedPitch, -m_settings.MaxSpeed, m_settings.MaxSpeed);
+		const MouseDelta delta = m_integrator.Advance(speedX, speedMinusY, timeStampMicroSeconds);
+		return Emit(delta.Dx, delta.MinusDy, timeStampMicroSeconds);
+	}
+
+	void Resync(float, float, int64_t timeStampMicroSeconds) { m_integrator.Reset(timeStampMicroSeconds); }
+
+private:
+	StrategySettings m_settings;
+	RateIntegrator m_integrator;
+};
+
+// The old MyMainOld.cpp: the change since the previous pose, truncated to counts. Steps below the threshold are
+// dropped, which filters jitter but also slow turns; the reference always moves on. The threshold is
+// per pose, so it only suits tracker-rate streams: at 1 kHz hardly any step reaches it.
+struct FollowStrategy : EmittedPosition
+{
+	static constexpr MappingStrategyKind k_kind = MappingStrategyKind::Follow;
+
+	FollowStrategy(const StrategySettings& settings, const MappingSettings&)
+		: m_settings{ settings }
+	{ }
+
+	MouseDelta Step(float yaw, float pitch, int64_t timeStampMicroSeconds, bool)
+	{
+		if (!m_hasReference)
+		{
+			Resync(yaw, pitch, timeStampMicroSeconds);
+		}
+		long dx = static_cast<long>((yaw - m_referenceYaw) * m_settings.Sens);
+		long minusDy = static_cast<long>((pitch - m_referencePitch) * m_settings.Sens * m_settings.YSensMult);
+		m_referenceYaw = yaw;
+		m_referencePitch = pitch;
+		if (std::abs(dx) < m_settings.ThresholdCounts)
+		{
+			dx = 0;
+		}
+		if (std::abs(minusDy) < m_settings.ThresholdCounts)
+		{
+			minusDy = 0;
+		}
+		return Emit(dx, minusDy, timeStampMicroSeconds);
+	}
+
+	void Resync(float yaw, float pitch, int64_t)
+	{
+		m_referenceYaw = yaw;
+		m_referencePitch = pitch;
+		m_hasReference = true;
+	}
+
+private:
+	StrategySettings m_settings;
+	float m_referenceYaw = 0.0f;
+	float m_referencePitch = 0.0f;
+	bool m_hasReference = false;
+};
+
+// The old 3P.cpp: while the key is held the cursor follows the head angle; on release it returns by the same
+// amount. The part of a count that couldn't be emitted stays pending instead of being lost.
+struct HoldStrategy : EmittedPosition
+{
+	static constexpr MappingStrategyKind k_kind = MappingStrategyKind::Hold;
+
+	HoldStrategy(const StrategySettings& settings, const MappingSettings&)
+		: m_settings{ settings }, m_pitchSens{ settings.Sens * settings.YSensMult }
+	{ }
+
+	MouseDelta Step(float yaw, float pitch, int64_t timeStampMicroSeconds, bool isModifierHeld)
+	{
+		const float targetYaw = isModifierHeld ? yaw : 0.0f;
+		const float targetPitch = isModifierHeld && m_settings.HoldPitch ? pitch : 0.0f;
+		const long dx = static_cast<long>((targetYaw - m_consumedYaw) * m_settings.Sens);
+		const long minusDy = static_cast<long>((targetPitch - m_consumedPitch) * m_pitchSens);
+		m_consumedYaw += static_cast<float>(dx) / m_settings.Sens;
+		m_consumedPitch += static_cast<float>(minusDy) / m_pitchSens;
+		return Emit(dx, minusDy, timeStampMicroSeconds);
+	}
+
+	// Whatever was consumed stays consumed, so a release still returns the cursor
+	void Resync(float, float, int64_t) { }
+
+private:
+	StrategySettings m_settings;
+	float m_pitchSens;
+	float m_consumedYaw = 0.0f;
+	float m_consumedPitch = 0.0f;
+};
+
+template <typename Strategy>
+concept MapsWholeBatches = requires(Strategy strategy, const HeadPose* headPoses, MouseDelta* deltas)
+{
+	{ strategy.MapHeadPoses(headPoses, 0, deltas) } -> std::same_as<int>;
+};
+
+template <typename Strategy>
+class StrategyEngine final : public MappingEngine
+{
+public:
+	StrategyEngine(const StrategySettings& strategySettings, const MappingSettings& mappingSettings)
+		: m_strategy{ strategySettings, mappingSettings },
+		m_yawScale{ mappingSettings.HeadPoseYawScale }, m_pitchScale{ mappingSettings.HeadPosePitchScale }
+	{ }
+
+	int MapHeadPoses(const HeadPose* headPoses, int count, MouseDelta* deltas) override
+	{
+		if constexpr (MapsWholeBatches<Strategy>)
+		{
+			return m_strategy.MapHeadPoses(headPoses, count, deltas);
+		}
+		else
+		{
+			const bool isModifierHeld = m_isModifierHeld;
+			int written = 0;
+			for (int i = 0; i < count; i++)
+			{
+				const HeadPose& headPose = headPoses[i];
+				const MouseDelta delta = m_strategy.Step(headPose.Rotation.YawDegrees * m_yawScale, headPose.Rotation.PitchDegrees * m_pitchScale,
+					headPose.TimeStampMicroSeconds, isModifierHeld);
+				if (delta.Dx || delta.MinusDy)
+				{
+					deltas[written++] = delta;
+				}
+			}
+			return written;
+		}
+	}
+
+	void ResyncHeadPose(const HeadPose& headPose) override
+	{
+		if constexpr (MapsWholeBatches<Strategy>)
+		{
+			m_strategy.ResyncHeadPose(headPose);
+		}
+		else
+		{
+			m_strategy.Resync(headPose.Rotation.YawDegrees * m_yawScale, headPose.Rotation.PitchDegrees * m_pitchScale, headPose.TimeStampMicroSeconds);
+		}
+	}
+
+	void SetCurves(const ResponseCurves* curves) override
+	{
+		if constexpr (requires { m_strategy.SetCurves(curves); })
+		{
+			m_strategy.SetCurves(curves);
+		}
+	}
+
+	float GetActualYaw() const override { return m_strategy.GetActualYaw(); }
+	float GetActualPitch() const override { return m_strategy.GetActualPitch(); }
+	MappingStrategyKind GetKind() const override { return Strategy::k_kind; }
+
+private:
+	Strategy m_strategy;
+	float m_yawScale;
+	float m_pitchScale;
+};
+
+std::unique_ptr<MappingEngine> CreateMappingEngine(const StrategySettings& strategy, const MappingSettings& mappingSettings)
+{
+	switch (strategy.Kind)
+	{
+	case MappingStrategyKind::Rate:
+		return std::make_unique<StrategyEngine<RateStrategy>>(strategy, mappingSettings);
+	case MappingStrategyKind::Follow:
+		return std::make_unique<StrategyEngine<FollowStrategy>>(strategy, mappingSettings);
+	case MappingStrategyKind::Hold:
+		return std::make_unique<StrategyEngine<HoldStrategy>>(strategy, mappingSettings);
+	default:
+		return std::make_unique<StrategyEngine<AbsoluteStrategy>>(strategy, mappingSettings);
+	}
+}
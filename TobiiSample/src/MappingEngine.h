@@ -0,0 +1,42 @@
+#pragma once
+
+#include "HeadMouseMapping.h"
+#include "StrategySettings.h"
+#include <memory>
+
+// Runs one mapping strategy over batches of raw head poses. The strategy is picked at startup and
+// compiled into the engine as a template policy (see MappingEngine.cpp), so the per-pose loop has no
+// virtual calls; the only dispatch is the one call per batch through this interface.
+// Used from one thread, like HeadMouseMapper.
+class MappingEngine
+{
+public:
+	virtual ~MappingEngine() = default;
+
+	// Same contract as HeadMouseMapper::MapHeadPoses(): one delta per pose at most, zero deltas left
+	// out, deltas must have room for count entries. Returns the number written.
+	virtual int MapHeadPoses(const TobiiGameIntegration::HeadPose* headPoses, int count, MouseDelta* deltas) = 0;
+
+	// Takes the pose as the new reference without emitting anything, for output that resumes after
+	// being held back.
+	virtual void ResyncHeadPose(const TobiiGameIntegration::HeadPose& headPose) = 0;
+
+	// Response curves for the absolute strategy, ignored by the others. Same lifetime rules as
+	// HeadMouseMapper::SetCurves().
+	virtual void SetCurves(const ResponseCurves* curves) { }
+
+	// State of the hold key, read by the hold strategy at the start of every batch.
+	void SetModifierHeld(bool isHeld) { m_isModifierHeld = isHeld; }
+
+	// Cursor offset emitted so far, in counts, for the telemetry line.
+	virtual float GetActualYaw() const = 0;
+	virtual float GetActualPitch() const = 0;
+
+	virtual MappingStrategyKind GetKind() const = 0;
+
+protected:
+	bool m_isModifierHeld = false;
+};
+
+// mappingSettings: HeadPose scales for every strategy, plus deadzone/clamp/sens for the absolute one.
+std::unique_ptr<MappingEngine> CreateMappingEngine(const StrategySettings& strategy, const MappingSettings& mappingSettings);
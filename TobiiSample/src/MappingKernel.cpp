@@ -0,0 +1,217 @@
+#include "MappingKernel.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MAPPING_KERNEL_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define MAPPING_TARGET_AVX
+#else
+#define MAPPING_TARGET_AVX __attribute__((target("avx")))
+#endif
+#else
+#define MAPPING_KERNEL_X86 0
+#endif
+
+using namespace TobiiGameIntegration;
+
+void HeadPoseColumns::Clear()
+{
+	for (std::vector<float>* column : { &Yaw, &Pitch, &Roll, &X, &Y, &Z })
+	{
+		column->clear();
+	}
+	TimeStampMicroSeconds.clear();
+}
+
+void HeadPoseColumns::Append(const HeadPose* headPoses, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const HeadPose& headPose = headPoses[i];
+		Yaw.push_back(headPose.Rotation.YawDegrees);
+		Pitch.push_back(headPose.Rotation.PitchDegrees);
+		Roll.push_back(headPose.Rotation.RollDegrees);
+		X.push_back(headPose.Position.X);
+		Y.push_back(headPose.Position.Y);
+		Z.push_back(headPose.Position.Z);
+		TimeStampMicroSeconds.push_back(headPose.TimeStampMicroSeconds);
+	}
+}
+
+// Per-axis constants, computed the way the scalar code computes them.
+struct AxisKernel
+{
+	float Scale;
+	float Dead;
+	float Max;
+	float Gain;
+};
+
+static void AxisKernels(const MappingSettings& settings, AxisKernel& yaw, AxisKernel& pitch)
+{
+	yaw = { settings.HeadPoseYawScale, settings.DeadYawIRL, settings.MaxYawIRL, settings.Sens };
+	pitch = { settings.HeadPosePitchScale, settings.DeadPitchIRL, settings.MaxPitchIRL, settings.Sens * settings.YSensMult };
+}
+
+// Same operations in the same order as HeadMouseMapper::DesiredCounts(), one axis.
+static float DesiredScalar(float degrees, const AxisKernel& axis)
+{
+	float desired = degrees * axis.Scale;
+	const bool dead = std::abs(desired) < axis.Dead;
+	desired = std::clamp(desired, -axis.Max, axis.Max);
+	if (!dead)
+	{
+		desired -= axis.Dead * (desired >= 0.0f ? 1.0f : -1.0f);
+	}
+	desired *= axis.Gain;
+	return dead ? 0.0f : desired;
+}
+
+static void DesiredCountsScalar(const AxisKernel& axis, const float* input, float* output, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		output[i] = DesiredScalar(input[i], axis);
+	}
+}
+
+#if MAPPING_KERNEL_X86
+// The selects replace the branches: clamp keeps NaN like std::clamp does (both compares false), and the
+// deadzone offset is +dead or -dead exactly as dead * +-1.0f is. Dead lanes end up +0.0f.
+static inline __m128 Select(__m128 mask, __m128 ifSet, __m128 ifClear)
+{
+	return _mm_or_ps(_mm_and_ps(mask, ifSet), _mm_andnot_ps(mask, ifClear));
+}
+
+static void DesiredCountsSse2(const AxisKernel& axis, const float* input, float* output, size_t count)
+{
+	const __m128 scale = _mm_set1_ps(axis.Scale);
+	const __m128 dead = _mm_set1_ps(axis.Dead);
+	const __m128 negativeDead = _mm_set1_ps(-axis.Dead);
+	const __m128 max = _mm_set1_ps(axis.Max);
+	const __m128 negativeMax = _mm_set1_ps(-axis.Max);
+	const __m128 gain = _mm_set1_ps(axis.Gain);
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	const __m128 zero = _mm_setzero_ps();
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 value = _mm_mul_ps(_mm_loadu_ps(input + i), scale);
+		const __m128 isDead = _mm_cmplt_ps(_mm_and_ps(value, absMask), dead);
+		__m128 clamped = Select(_mm_cmplt_ps(max, value), max, value);
+		clamped = Select(_mm_cmplt_ps(value, negativeMax), negativeMax, clamped);
+		const __m128 offset = Select(_mm_cmpge_ps(clamped, zero), dead, negativeDead);
+		const __m128 desired = _mm_mul_ps(_mm_sub_ps(clamped, offset), gain);
+		_mm_storeu_ps(output + i, _mm_andnot_ps(isDead, desired));
+	}
+	DesiredCountsScalar(axis, input + i, output + i, count - i);
+}
+
+// Bitwise select rather than blendv: GCC lowers blendv through 256-bit integer compares, which AVX
+// (without AVX2) does not have, and ends up with a scalar branch per lane.
+MAPPING_TARGET_AVX static inline __m256 Select(__m256 mask, __m256 ifSet, __m256 ifClear)
+{
+	return _mm256_or_ps(_mm256_and_ps(mask, ifSet), _mm256_andnot_ps(mask, ifClear));
+}
+
+MAPPING_TARGET_AVX static void DesiredCountsAvx(const AxisKernel& axis, const float* input, float* output, size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(axis.Scale);
+	const __m256 dead = _mm256_set1_ps(axis.Dead);
+	const __m256 negativeDead = _mm256_set1_ps(-axis.Dead);
+	const __m256 max = _mm256_set1_ps(axis.Max);
+	const __m256 negativeMax = _mm256_set1_ps(-axis.Max);
+	const __m256 gain = _mm256_set1_ps(axis.Gain);
+	const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+	const __m256 zero = _mm256_setzero_ps();
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m256 value = _mm256_mul_ps(_mm256_loadu_ps(input + i), scale);
+		const __m256 isDead = _mm256_cmp_ps(_mm256_and_ps(value, absMask), dead, _CMP_LT_OQ);
+		__m256 clamped = Select(_mm256_cmp_ps(max, value, _CMP_LT_OQ), max, value);
+		clamped = Select(_mm256_cmp_ps(value, negativeMax, _CMP_LT_OQ), negativeMax, clamped);
+		const __m256 offset = Select(_mm256_cmp_ps(clamped, zero, _CMP_GE_OQ), dead, negativeDead);
+		const __m256 desired = _mm256_mul_ps(_mm256_sub_ps(clamped, offset), gain);
+		_mm256_storeu_ps(output + i, _mm256_andnot_ps(isDead, desired));
+	}
+	_mm256_zeroupper();
+	DesiredCountsSse2(axis, input + i, output + i, count - i);
+}
+
+static SimdLevel DetectSimdLevel()
+{
+#ifdef _MSC_VER
+	int registers[4];
+	__cpuid(registers, 1);
+	const bool osSavesAvx = (registers[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+	if (osSavesAvx && (registers[2] & (1 << 28)) != 0)
+	{
+		return SimdLevel::Avx;
+	}
+	return SimdLevel::Sse2;
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx"))
+	{
+		return SimdLevel::Avx;
+	}
+	return __builtin_cpu_supports("sse2") ? SimdLevel::Sse2 : SimdLevel::Scalar;
+#endif
+}
+#else
+static SimdLevel DetectSimdLevel()
+{
+	return SimdLevel::Scalar;
+}
+#endif
+
+SimdLevel GetSupportedSimdLevel()
+{
+	static const SimdLevel level = DetectSimdLevel();
+	return level;
+}
+
+const char* GetSimdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::Sse2:
+		return "SSE2";
+	case SimdLevel::Avx:
+		return "AVX";
+	default:
+		return "scalar";
+	}
+}
+
+void ComputeDesiredCounts(const MappingSettings& settings, const float* yaw, const float* pitch,
+	float* desiredYaw, float* desiredPitch, size_t count, SimdLevel level)
+{
+	AxisKernel yawKernel, pitchKernel;
+	AxisKernels(settings, yawKernel, pitchKernel);
+	level = (std::min)(level, GetSupportedSimdLevel());
+
+	switch (level)
+	{
+#if MAPPING_KERNEL_X86
+	case SimdLevel::Avx:
+		DesiredCountsAvx(yawKernel, yaw, desiredYaw, count);
+		DesiredCountsAvx(pitchKernel, pitch, desiredPitch, count);
+		break;
+	case SimdLevel::Sse2:
+		DesiredCountsSse2(yawKernel, yaw, desiredYaw, count);
+		DesiredCountsSse2(pitchKernel, pitch, desiredPitch, count);
+		break;
+#endif
+	default:
+		DesiredCountsScalar(yawKernel, yaw, desiredYaw, count);
+		DesiredCountsScalar(pitchKernel, pitch, desiredPitch, count);
+		break;
+	}
+}
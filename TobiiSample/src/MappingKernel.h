@@ -0,0 +1,40 @@
+#pragma once
+
+#include "HeadMouseMapping.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Head poses as structure-of-arrays, for batch mapping, replay analysis and parameter sweeps.
+struct HeadPoseColumns
+{
+	std::vector<float> Yaw;
+	std::vector<float> Pitch;
+	std::vector<float> Roll;
+	std::vector<float> X;
+	std::vector<float> Y;
+	std::vector<float> Z;
+	std::vector<int64_t> TimeStampMicroSeconds;
+
+	size_t Size() const { return TimeStampMicroSeconds.size(); }
+	void Clear();
+	void Append(const TobiiGameIntegration::HeadPose* headPoses, size_t count);
+};
+
+enum class SimdLevel
+{
+	Scalar,
+	Sse2,
+	Avx
+};
+
+// Best level this CPU and OS support, detected once.
+SimdLevel GetSupportedSimdLevel();
+const char* GetSimdLevelName(SimdLevel level);
+
+// HeadMouseMapper::DesiredCounts() over whole arrays of raw head pose angles, including the HeadPose
+// scale that MapHeadPoses() applies first. Branch-free, and bit-exact against the scalar code for
+// every input including NaN, signed zeros and the deadzone/limit boundaries. Response curves are
+// not handled here. level is lowered to what the CPU supports.
+void ComputeDesiredCounts(const MappingSettings& settings, const float* yaw, const float* pitch,
+	float* desiredYaw, float* desiredPitch, size_t count, SimdLevel level = GetSupportedSimdLevel());
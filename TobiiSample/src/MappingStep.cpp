@@ -0,0 +1,84 @@
+#include "MappingStep.h"
+#include "Trace.h"
+
+using namespace TobiiGameIntegration;
+
+MappingStep::MappingStep(MappingEngine& mapper, HeadPoseFilter& filter, PosePredictor& predictor, OutputGate& gate, MouseOutput& output,
+	OutputCoalescer* coalescer, bool resyncOnResume)
+	: m_mapper{ mapper }, m_filter{ filter }, m_predictor{ predictor }, m_gate{ gate }, m_output{ output }, m_coalescer{ coalescer },
+	m_resyncOnResume{ resyncOnResume }
+{ }
+
+int MappingStep::MapBatch(HeadPose* headPoses, int count, int64_t nowMicroSeconds, MouseDelta* deltas, TelemetrySnapshot& snapshot)
+{
+	snapshot.Pose = headPoses[count - 1];
+	snapshot.PoseTimeStampMicroSeconds = headPoses[count - 1].TimeStampMicroSeconds;
+
+	// Keeps filtering while the cursor is visible so there is no stale motion on resume
+	{
+		TRACE_ZONE("Filter");
+		m_filter.FilterHeadPoses(headPoses, count);
+	}
+	{
+		TRACE_ZONE("Predict");
+		m_predictor.PredictHeadPoses(headPoses, count);
+	}
+
+	m_gate.Advance(headPoses[count - 1].TimeStampMicroSeconds);
+	const bool outputAllowed = m_gate.IsOutputAllowed();
+	if (m_coalescer != nullptr && outputAllowed != m_wasOutputAllowed && m_coalescer->OnGateChanged(outputAllowed, nowMicroSeconds))
+	{
+		m_emittedCount++;
+	}
+	m_hasResumed = outputAllowed && !m_wasOutputAllowed;
+	m_wasOutputAllowed = outputAllowed;
+
+	int deltaCount = 0;
+	if (outputAllowed)
+	{
+		// Without a resync the head motion made while output was held is emitted at once here
+		if (m_hasResumed && m_resyncOnResume)
+		{
+			m_mapper.ResyncHeadPose(headPoses[0]);
+		}
+		{
+			TRACE_ZONE("MapHeadPoses");
+			deltaCount = m_mapper.MapHeadPoses(headPoses, count, deltas);
+		}
+		if (m_coalescer != nullptr)
+		{
+			TRACE_ZONE("CoalesceAndEmit");
+			// From here on deltas holds what was emitted: the combined move, if its period is over
+			m_coalescer->Add(deltas, deltaCount);
+			deltaCount = m_coalescer->Poll(nowMicroSeconds, deltas) ? 1 : 0;
+		}
+		else if (deltaCount > 0)
+		{
+			TRACE_ZONE("Emit");
+			m_output.Emit(deltas, deltaCount);
+		}
+	}
+	m_emittedCount += deltaCount;
+
+	snapshot.OutputActive = outputAllowed;
+	snapshot.ActualYaw = m_mapper.GetActualYaw();
+	snapshot.ActualPitch = m_mapper.GetActualPitch();
+	snapshot.DeltasEmitted = m_emittedCount;
+	return deltaCount;
+}
+
+void MappingStep::Poll(int64_t nowMicroSeconds)
+{
+	if (m_coalescer != nullptr && m_wasOutputAllowed && m_coalescer->Poll(nowMicroSeconds))
+	{
+		m_emittedCount++;
+	}
+}
+
+void MappingStep::Flush(int64_t nowMicroSeconds)
+{
+	if (m_coalescer != nullptr && m_wasOutputAllowed && m_coalescer->Flush(nowMicroSeconds))
+	{
+		m_emittedCount++;
+	}
+}
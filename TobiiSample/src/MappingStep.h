@@ -0,0 +1,52 @@
+#pragma once
+
+#include "HeadPoseFilter.h"
+#include "MappingEngine.h"
+#include "MouseOutput.h"
+#include "OutputCoalescer.h"
+#include "OutputGate.h"
+#include "PosePredictor.h"
+#include "Telemetry.h"
+#include <cstdint>
+
+// Everything MyNewMain's mapping thread does with one batch of head poses: filter, predictor, output
+// gate, resync on resume, the mapping strategy, then the coalescer or the mouse output. ReplayMain
+// runs its batches through the same step, so what it measures is what runs live.
+// Used from one thread, like MappingEngine.
+class MappingStep
+{
+public:
+	// coalescer may be null. All of them are used by reference and must outlive the step.
+	MappingStep(MappingEngine& mapper, HeadPoseFilter& filter, PosePredictor& predictor, OutputGate& gate, MouseOutput& output,
+		OutputCoalescer* coalescer, bool resyncOnResume);
+
+	// Filters and predicts headPoses in place, then maps and emits them. nowMicroSeconds is the clock
+	// the coalescer runs on, see OutputCoalescer. deltas must have room for count entries and gets what
+	// went out: the mapped deltas, or the combined move if the coalescer emitted one. Returns how many.
+	// Fills in snapshot except QueueDepth.
+	int MapBatch(TobiiGameIntegration::HeadPose* headPoses, int count, int64_t nowMicroSeconds, MouseDelta* deltas,
+		TelemetrySnapshot& snapshot);
+
+	// Motion waiting in the coalescer for the end of its period, for when no poses come in.
+	void Poll(int64_t nowMicroSeconds);
+	// Whatever the coalescer still holds, at the end of a run.
+	void Flush(int64_t nowMicroSeconds);
+
+	bool IsOutputAllowed() const { return m_wasOutputAllowed; }
+	// The last batch was the first one with output allowed again.
+	bool HasResumed() const { return m_hasResumed; }
+	// Deltas and combined moves sent to the output so far.
+	uint64_t GetEmittedCount() const { return m_emittedCount; }
+
+private:
+	MappingEngine& m_mapper;
+	HeadPoseFilter& m_filter;
+	PosePredictor& m_predictor;
+	OutputGate& m_gate;
+	MouseOutput& m_output;
+	OutputCoalescer* m_coalescer;
+	bool m_resyncOnResume;
+	bool m_wasOutputAllowed = false;
+	bool m_hasResumed = false;
+	uint64_t m_emittedCount = 0;
+};
@@ -0,0 +1,189 @@
+#include "MouseOutput.h"
+#include "Clock.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include "windows.h"
+#endif
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+bool SendInputMouseOutput::Emit(const MouseDelta* deltas, int count)
+{
+	INPUT inputs[k_maxBatch];
+	bool allSent = true;
+	for (int first = 0; first < count; first += k_maxBatch)
+	{
+		const int batch = (std::min)(k_maxBatch, count - first);
+		for (int i = 0; i < batch; i++)
+		{
+			INPUT& input = inputs[i];
+			input = {};
+			input.type = INPUT_MOUSE;
+			input.mi.dx = deltas[first + i].Dx;
+			input.mi.dy = -deltas[first + i].MinusDy;
+			input.mi.dwFlags = MOUSEEVENTF_MOVE;
+		}
+		allSent &= SendInput(static_cast<UINT>(batch), inputs, sizeof(INPUT)) == static_cast<UINT>(batch);
+	}
+	return allSent;
+}
+#endif
+
+#ifdef __linux__
+UInputMouseOutput::~UInputMouseOutput()
+{
+	if (m_fd >= 0)
+	{
+		ioctl(m_fd, UI_DEV_DESTROY);
+		close(m_fd);
+	}
+}
+
+bool UInputMouseOutput::Open()
+{
+	m_fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+	if (m_fd < 0)
+	{
+		return false;
+	}
+
+	// A button makes desktops treat the device as a mouse rather than an unknown relative device
+	ioctl(m_fd, UI_SET_EVBIT, EV_KEY);
+	ioctl(m_fd, UI_SET_KEYBIT, BTN_LEFT);
+	ioctl(m_fd, UI_SET_EVBIT, EV_REL);
+	ioctl(m_fd, UI_SET_RELBIT, REL_X);
+	ioctl(m_fd, UI_SET_RELBIT, REL_Y);
+
+	uinput_setup setup;
+	std::memset(&setup, 0, sizeof(setup));
+	setup.id.bustype = BUS_VIRTUAL;
+	setup.id.vendor = 0x2104;	// Tobii
+	setup.id.product = 0x0001;
+	std::strncpy(setup.name, "Tobii head mouse", UINPUT_MAX_NAME_SIZE - 1);
+
+	if (ioctl(m_fd, UI_DEV_SETUP, &setup) < 0 || ioctl(m_fd, UI_DEV_CREATE) < 0)
+	{
+		close(m_fd);
+		m_fd = -1;
+		return false;
+	}
+	return true;
+}
+
+bool UInputMouseOutput::Emit(const MouseDelta* deltas, int count)
+{
+	input_event events[k_maxBatch * 3];
+	bool allSent = true;
+	for (int first = 0; first < count; first += k_maxBatch)
+	{
+		const int batch = (std::min)(k_maxBatch, count - first);
+		int eventCount = 0;
+		auto addEvent = [&](unsigned short type, unsigned short code, int value)
+		{
+			input_event& event = events[eventCount++];
+			std::memset(&event, 0, sizeof(event));
+			event.type = type;
+			event.code = code;
+			event.value = value;
+		};
+		for (int i = 0; i < batch; i++)
+		{
+			addEvent(EV_REL, REL_X, static_cast<int>(deltas[first + i].Dx));
+			addEvent(EV_REL, REL_Y, static_cast<int>(-deltas[first + i].MinusDy));
+			addEvent(EV_SYN, SYN_REPORT, 0);
+		}
+		const ssize_t size = static_cast<ssize_t>(eventCount * sizeof(input_event));
+		allSent &= write(m_fd, events, size) == size;
+	}
+	return allSent;
+}
+#endif
+
+CaptureMouseOutput::CaptureMouseOutput(size_t maxStoredDeltas)
+	: m_maxStoredDeltas{ maxStoredDeltas }
+{ }
+
+bool CaptureMouseOutput::Emit(const MouseDelta* deltas, int count)
+{
+	const int64_t now = NowMicroSeconds();
+	for (int i = 0; i < count; i++)
+	{
+		if (m_deltas.size() < m_maxStoredDeltas)
+		{
+			m_deltas.push_back({ deltas[i], now });
+		}
+		m_totalDx += deltas[i].Dx;
+		m_totalMinusDy += deltas[i].MinusDy;
+	}
+	m_deltaCount += count;
+	m_emitCount++;
+	return true;
+}
+
+void CaptureMouseOutput::Clear()
+{
+	m_deltas.clear();
+	m_deltaCount = 0;
+	m_emitCount = 0;
+	m_totalDx = 0;
+	m_totalMinusDy = 0;
+}
+
+std::unique_ptr<MouseOutput> CreateMouseOutput(const char* outputSpec)
+{
+	std::string spec{ outputSpec != nullptr ? outputSpec : "" };
+	if (spec.empty())
+	{
+#ifdef _WIN32
+		spec = "sendinput";
+#else
+		spec = "uinput";
+#endif
+	}
+
+	if (spec == "sendinput")
+	{
+#ifdef _WIN32
+		return std::make_unique<SendInputMouseOutput>();
+#else
+		std::cerr << "The sendinput output is only available on Windows" << std::endl;
+		return nullptr;
+#endif
+	}
+	if (spec == "uinput")
+	{
+#ifdef __linux__
+		auto output = std::make_unique<UInputMouseOutput>();
+		if (!output->Open())
+		{
+			std::cerr << "Can't create a uinput device, check the permissions of /dev/uinput" << std::endl;
+			return nullptr;
+		}
+		return output;
+#else
+		std::cerr << "The uinput output is only available on Linux" << std::endl;
+		return nullptr;
+#endif
+	}
+	if (spec == "capture")
+	{
+		return std::make_unique<CaptureMouseOutput>();
+	}
+	if (spec.compare(0, 8, "capture:") == 0)
+	{
+		return std::make_unique<CaptureMouseOutput>(std::strtoull(spec.c_str() + 8, nullptr, 10));
+	}
+
+	std::cerr << "Unknown mouse output " << spec << std::endl;
+	return nullptr;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "HeadMouseMapping.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Where mouse deltas go. Emit() takes every delta that is due at once so backends can inject them
+// with a single system call. MinusDy is positive for upward motion, as produced by HeadMouseMapper.
+class MouseOutput
+{
+public:
+	virtual ~MouseOutput() = default;
+
+	// Returns false if the system rejected some of the input.
+	virtual bool Emit(const MouseDelta* deltas, int count) = 0;
+	bool Emit(const MouseDelta& delta) { return Emit(&delta, 1); }
+
+	virtual const char* GetName() const = 0;
+};
+
+#ifdef _WIN32
+// One SendInput() call per Emit(), up to k_maxBatch relative moves each.
+class SendInputMouseOutput : public MouseOutput
+{
+public:
+	bool Emit(const MouseDelta* deltas, int count) override;
+	const char* GetName() const override { return "sendinput"; }
+
+	static constexpr int k_maxBatch = 64;
+};
+#endif
+
+#ifdef __linux__
+// Virtual relative mouse through /dev/uinput (needs write access to it, usually the input group).
+// One write() per Emit(): REL_X, REL_Y and SYN_REPORT events for every delta.
+class UInputMouseOutput : public MouseOutput
+{
+public:
+	~UInputMouseOutput() override;
+
+	bool Open();
+	bool Emit(const MouseDelta* deltas, int count) override;
+	const char* GetName() const override { return "uinput"; }
+
+	static constexpr int k_maxBatch = 64;
+
+private:
+	int m_fd = -1;
+};
+#endif
+
+struct CapturedMouseDelta
+{
+	MouseDelta Delta;
+	int64_t EmitMicroSeconds;		// NowMicroSeconds() when Emit() was called
+};
+
+// Keeps every emitted delta in memory instead of moving the cursor, for replay runs, benchmarks and
+// regression comparisons. Totals cover all deltas, storage stops after maxStoredDeltas.
+class CaptureMouseOutput : public MouseOutput
+{
+public:
+	explicit CaptureMouseOutput(size_t maxStoredDeltas = SIZE_MAX);
+
+	bool Emit(const MouseDelta* deltas, int count) override;
+	const char* GetName() const override { return "capture"; }
+
+	const std::vector<CapturedMouseDelta>& GetDeltas() const { return m_deltas; }
+	uint64_t GetDeltaCount() const { return m_deltaCount; }
+	uint64_t GetEmitCount() const { return m_emitCount; }
+	int64_t GetTotalDx() const { return m_totalDx; }
+	int64_t GetTotalMinusDy() const { return m_totalMinusDy; }
+	void Clear();
+
+private:
+	size_t m_maxStoredDeltas;
+	std::vector<CapturedMouseDelta> m_deltas;
+	uint64_t m_deltaCount = 0;
+	uint64_t m_emitCount = 0;
+	int64_t m_totalDx = 0;
+	int64_t m_totalMinusDy = 0;
+};
+
+// Creates the output named by a spec string:
+//   ""                     the platform's injecting backend: sendinput on Windows, uinput on Linux
+//   "sendinput"            Windows SendInput()
+//   "uinput"               Linux virtual mouse
+//   "capture[:<max>]"      in-memory capture, storing at most <max> deltas
+// Returns nullptr (and prints why) when the output cannot be created.
+std::unique_ptr<MouseOutput> CreateMouseOutput(const char* outputSpec);
@@ -1,42 +1,259 @@
 #include "tobii_gameintegration.h"
+#include "ActivityGovernor.h"
+#include "ApiBackend.h"
+#include "Clock.h"
+#include "HeadMouseMapping.h"
+#include "HeadPoseFilter.h"
+#include "LatencyHistogram.h"
+#include "MappingEngine.h"
+#include "MappingStep.h"
+#include "MouseOutput.h"
+#include "OutputCoalescer.h"
+#include "OpenTrackUdp.h"
+#include "OutputGate.h"
+#include "PacedScheduler.h"
+#include "PosePredictor.h"
+#include "PoseSharedMemory.h"
+#include "ProfileWatcher.h"
+#include "SessionArchive.h"
+#include "SessionRecording.h"
+#include "SquadTuning.h"
+#include "SpscRing.h"
+#include "Telemetry.h"
+#include "Trace.h"
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <future>
 #include <iostream>
-#include <iomanip>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
 #include "windows.h"
 
 using namespace TobiiGameIntegration;
 
-#define ENABLE_PITCH 0
-
-// settings tuned for Squad game with 3200x2000 res and 1000 DPI mouse
-// change only the numbers, unless you know what you're doing
-static constexpr float k_sens = 30.0f;
-#if ENABLE_PITCH
-static constexpr float k_ySensMult = 0.25f;
-#else
-static constexpr float k_ySensMult = 0.0f;
-#endif
-static constexpr float k_deadYawIRL = 7.5f;
-static constexpr float k_deadPitchIRL = 7.5f;
-static constexpr float k_maxYawIRL = 650.0f / k_sens + k_deadYawIRL;
-#if ENABLE_PITCH
-static constexpr float k_maxPitchIRL = 100.0f / (k_sens * k_ySensMult) + k_deadPitchIRL;
-#else
-static constexpr float k_maxPitchIRL = 0.0f;
-#endif
+// 1: map every buffered HeadPose from GetHeadPoses(), 0: map only the latest GetTransformation()
+#define USE_HEAD_POSE_BATCH 1
 
 HWND GetConsoleHwnd(void); // See SampleHelpFunctions.cpp
 
-bool IsCursorVisible()
+static constexpr int k_deltaBatchSize = 64;
+
+// Tracker thread -> mapping thread: the pose and when the tracker thread got it, on NowMicroSeconds().
+// The tracker's own timestamps may be on another clock, the arrival time is what latency is measured from.
+struct QueuedHeadPose
+{
+	HeadPose Pose;
+	int64_t ArrivalMicroSeconds;
+};
+
+// 1024 poses is about a second at the fastest tracker rates.
+using HeadPoseRing = SpscRing<QueuedHeadPose, 1024>;
+
+struct CommandLineOptions
+{
+	std::string BackendSpec;	// --backend <spec>, see ApiBackend.h
+	std::string RecordPath;		// --record <file>
+	std::string ArchivePath;	// --archive <file>: head poses and gaze points, compressed, see SessionArchive.h
+	std::string OutputSpec;		// --output <spec>, see MouseOutput.h
+	double CoalesceRateHz = 0.0;	// --coalesce <hz>[:flush]: at most one combined move per period, see OutputCoalescer
+	CoalescerGatePolicy CoalescePolicy = CoalescerGatePolicy::Discard;
+	std::string GateSpec;		// --gate <spec>, see OutputGate.h
+	std::string PublishName;	// --publish <name>: share poses with other local processes, see PoseSharedMemory.h
+	std::string OpenTrackOut;	// --opentrack-out [<address>:]<port>: send raw head poses on as OpenTrack UDP packets
+	bool ResyncOnResume = true;	// --resume resync|catchup: what happens to head motion made while output was held
+	std::string ProfilePath;	// --profile <file>: response curves, see ResponseCurve.h. Reloaded when the file changes
+	int UpdateRateHz = 1000;	// --rate <hz>: tracker Update() calls per second, see PacedScheduler
+	int SpinMicroSeconds = 0;	// --spin <us>: busy-wait this long before each Update() deadline for tighter pacing
+	bool IdleThrottling = true;	// --idle on|off: poll less while nobody is there or the head is still, see ActivityGovernor
+	int BenchSeconds = 0;		// --bench-latency <seconds>: measure for this long, then print the report and exit
+	std::string FilterSpec;		// --filter <chain>: smoothing before prediction and mapping, see ParseFilterChain()
+	int PredictMilliseconds = 0;	// --predict <ms>: extrapolate head poses this far ahead, see PosePredictor.h
+	int TelemetryRateHz = 20;		// --telemetry <hz|off|inline>, see TelemetryRenderer
+	std::string TracePath;			// --trace <file>: F9 writes the recent tracing zones there, see Trace.h
+	double TraceSeconds = 10.0;		// --trace-seconds <s>: how far back F9 goes
+};
+
+CommandLineOptions ParseOptions(int argc, char** argv)
 {
-	CURSORINFO ci = { sizeof(CURSORINFO) };
-	if (GetCursorInfo(&ci))
-		return ci.flags & CURSOR_SHOWING;
-	return false;
+	CommandLineOptions options;
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		const std::string arg{ argv[i] };
+		if (arg == "--backend")
+		{
+			options.BackendSpec = argv[++i];
+		}
+		else if (arg == "--record")
+		{
+			options.RecordPath = argv[++i];
+		}
+		else if (arg == "--archive")
+		{
+			options.ArchivePath = argv[++i];
+		}
+		else if (arg == "--gate")
+		{
+			options.GateSpec = argv[++i];
+		}
+		else if (arg == "--publish")
+		{
+			options.PublishName = argv[++i];
+		}
+		else if (arg == "--opentrack-out")
+		{
+			options.OpenTrackOut = argv[++i];
+		}
+		else if (arg == "--resume")
+		{
+			options.ResyncOnResume = std::string{ argv[++i] } != "catchup";
+		}
+		else if (arg == "--profile")
+		{
+			options.ProfilePath = argv[++i];
+		}
+		else if (arg == "--output")
+		{
+			options.OutputSpec = argv[++i];
+		}
+		else if (arg == "--coalesce")
+		{
+			if (!ParseCoalescerSpec(argv[++i], options.CoalesceRateHz, options.CoalescePolicy))
+			{
+				std::cout << "Invalid --coalesce " << argv[i] << ", not coalescing" << std::endl;
+				options.CoalesceRateHz = 0.0;
+			}
+		}
+		else if (arg == "--rate")
+		{
+			options.UpdateRateHz = (std::max)(std::atoi(argv[++i]), 1);
+		}
+		else if (arg == "--idle")
+		{
+			options.IdleThrottling = std::string{ argv[++i] } != "off";
+		}
+		else if (arg == "--spin")
+		{
+			options.SpinMicroSeconds = std::atoi(argv[++i]);
+		}
+		else if (arg == "--bench-latency")
+		{
+			options.BenchSeconds = std::atoi(argv[++i]);
+		}
+		else if (arg == "--filter")
+		{
+			options.FilterSpec = argv[++i];
+		}
+		else if (arg == "--predict")
+		{
+			options.PredictMilliseconds = std::atoi(argv[++i]);
+		}
+		else if (arg == "--trace")
+		{
+			options.TracePath = argv[++i];
+		}
+		else if (arg == "--trace-seconds")
+		{
+			options.TraceSeconds = std::atof(argv[++i]);
+		}
+		else if (arg == "--telemetry")
+		{
+			if (!ParseTelemetryRate(argv[++i], options.TelemetryRateHz))
+			{
+				std::cout << "Invalid --telemetry " << argv[i] << ", using " << options.TelemetryRateHz << " Hz" << std::endl;
+			}
+		}
+	}
+	return options;
 }
 
-int main() {
-	ITobiiGameIntegrationApi* api = GetApi("Extended View Sample");
+// Each histogram is written by one thread only and read after both threads have been joined.
+// ArrivalToEmit works with any tracker. SampleToEmit assumes HeadPose timestamps are on the NowMicroSeconds()
+// clock, which holds for the offline backends; samples that can't be on the same clock are counted as
+// mismatches instead, and the histogram is only reported when there were none.
+struct LatencyBenchmark
+{
+	LatencyHistogram UpdatePeriod;		// tracker thread: between Update() calls
+	LatencyHistogram UpdateLateness;	// tracker thread: wake-up after the Update() deadline
+	uint64_t MissedUpdateDeadlines = 0;
+	LatencyHistogram MappingPeriod;		// mapping thread: between batches that had poses
+	LatencyHistogram BatchWork;			// mapping thread: time spent on one batch, from pop to telemetry published
+	LatencyHistogram ArrivalToEmit;		// pose handed to the mapping thread -> its mouse delta emitted
+	LatencyHistogram SampleToEmit;		// HeadPose timestamp -> its mouse delta emitted
+	uint64_t ClockMismatches = 0;
+};
+
+// When the last poses popped by the mapping thread arrived, to find the arrival behind an emitted delta.
+// A delta belongs to the first pose at or after its timestamp: rate mode steps fall between poses, and a
+// coalesced move carries the timestamp of a pose from an earlier batch.
+class ArrivalHistory
+{
+public:
+	void Add(int64_t timeStampMicroSeconds, int64_t arrivalMicroSeconds)
+	{
+		const size_t slot = m_count++ % k_size;
+		m_timeStamps[slot] = timeStampMicroSeconds;
+		m_arrivals[slot] = arrivalMicroSeconds;
+	}
+
+	bool Find(int64_t timeStampMicroSeconds, int64_t& arrivalMicroSeconds) const
+	{
+		bool found = false;
+		for (uint64_t i = m_count; i > 0 && m_count - i < k_size; i--)
+		{
+			const size_t slot = (i - 1) % k_size;
+			if (m_timeStamps[slot] < timeStampMicroSeconds)
+			{
+				break;
+			}
+			arrivalMicroSeconds = m_arrivals[slot];
+			found = true;
+		}
+		return found;
+	}
+
+private:
+	static constexpr size_t k_size = 1024;
+	int64_t m_timeStamps[k_size] = {};
+	int64_t m_arrivals[k_size] = {};
+	uint64_t m_count = 0;
+};
+
+struct Pipeline
+{
+	CommandLineOptions Options;
+	HeadPoseRing Ring;
+	std::atomic<bool> Running{ true };
+	std::promise<std::optional<MappingSettings>> MappingSettingsPromise;	// nullopt: the backend couldn't be opened
+	std::unique_ptr<MouseOutput> Output;	// used by the mapping thread only
+	std::unique_ptr<TelemetryRenderer> Telemetry;	// published to by the mapping thread only
+	std::unique_ptr<OutputGate> Gate;				// advanced by the mapping thread only, read by both
+	std::unique_ptr<ActivityGovernor> Activity;		// used by the tracker thread only; nullptr: --idle off
+	std::unique_ptr<SharedPosePublisher> Publisher;	// used by the tracker thread only; nullptr: no --publish
+	std::unique_ptr<OpenTrackSender> OpenTrackOut;	// used by the tracker thread only; nullptr: no --opentrack-out
+	std::atomic<int64_t> PollPeriodMicroSeconds{ 1000 };	// tracker thread -> mapping thread: current Update() period
+	HeadPoseFilter Filter;							// used by the mapping thread only
+	SnapshotSlot<ResponseCurves> Curves;			// empty: the SquadTuning.h constants. Read by the mapping thread only
+	StrategySettings Strategy;						// from the profile, absolute without one
+	LatencyBenchmark Benchmark;
+};
+
+static constexpr int64_t k_maxPlausibleLatencyMicroSeconds = 10'000'000;
+
+// Owns the ITobiiGameIntegrationApi: every API call happens on this thread.
+void TrackerThread(Pipeline& pipeline)
+{
+	const CommandLineOptions& options = pipeline.Options;
+	ITobiiGameIntegrationApi* api = GetBackendApi("Extended View Sample", options.BackendSpec.c_str());
+	if (api == nullptr)
+	{
+		// GetBackendApi() has said why
+		pipeline.MappingSettingsPromise.set_value(std::nullopt);
+		return;
+	}
+	IStreamsProvider* streamsProvider = api->GetStreamsProvider();
 	IExtendedView* extendedView = api->GetFeatures()->GetExtendedView();
 
 	// Turn on head tracking position
@@ -47,69 +264,389 @@ int main() {
 
 	api->GetTrackerController()->TrackWindow(GetConsoleHwnd());
 
-	std::cout << "F8 to exit" << std::endl << std::endl;
+	SessionRecorder recorder;
+	if (!options.RecordPath.empty() && !recorder.Open(options.RecordPath.c_str()))
+	{
+		std::cout << "Can't create " << options.RecordPath << ", not recording" << std::endl;
+	}
+	SessionArchiveWriter archive;
+	std::string archiveError;
+	if (!options.ArchivePath.empty() && !archive.Open(options.ArchivePath.c_str(), ArchiveSettings{}, archiveError))
+	{
+		std::cout << archiveError << ", not archiving" << std::endl;
+	}
+
+	MappingSettings mappingSettings = SquadMappingSettings();
+#if USE_HEAD_POSE_BATCH
+	mappingSettings.HeadPoseYawScale = extendedViewSettings.HeadTracking.YawRightDegrees.SensitivityScaling;
+	mappingSettings.HeadPosePitchScale = extendedViewSettings.HeadTracking.PitchUpDegrees.SensitivityScaling;
+#endif
+	pipeline.MappingSettingsPromise.set_value(mappingSettings);
+
+	HeadPoseRing& ring = pipeline.Ring;
+	PacedScheduler pacing{ static_cast<double>(options.UpdateRateHz), options.SpinMicroSeconds };
+	pipeline.PollPeriodMicroSeconds = pacing.GetPeriodMicroSeconds();
+	ActivityGovernor* activity = pipeline.Activity.get();
+	if (activity != nullptr)
+	{
+		activity->ConfigureStreams(streamsProvider);
+	}
+	int64_t lastUpdate = -1;
+	TRACE_THREAD("tracker");
+	while (pipeline.Running.load(std::memory_order_relaxed))
+	{
+		{
+			TRACE_ZONE("WaitForNextTick");
+			pacing.WaitForNextTick();
+		}
+		TRACE_ZONE("Tick");
+		{
+			TRACE_ZONE("Update");
+			api->Update();
+		}
+		if (options.BenchSeconds > 0)
+		{
+			const int64_t now = NowMicroSeconds();
+			if (lastUpdate >= 0)
+			{
+				pipeline.Benchmark.UpdatePeriod.Record(now - lastUpdate);
+			}
+			lastUpdate = now;
+		}
+		// While nobody is there the head stream is left unread, so the API unsubscribes it
+		const HeadPose* headPoses = nullptr;
+		int headPoseCount = 0;
+#if !USE_HEAD_POSE_BATCH
+		HeadPose headPose;
+#endif
+		if (activity == nullptr || activity->ShouldReadHeadPoses())
+		{
+#if USE_HEAD_POSE_BATCH
+			TRACE_ZONE("GetHeadPoses");
+			// Poses buffered since the previous Update(), oldest first
+			headPoseCount = streamsProvider->GetHeadPoses(headPoses);
+			const int64_t arrival = NowMicroSeconds();
+			for (int i = 0; i < headPoseCount; i++)
+			{
+				ring.TryPush({ headPoses[i], arrival });
+			}
+#else
+			TRACE_ZONE("GetTransformation");
+			static_cast<Transformation&>(headPose) = extendedView->GetTransformation();
+			headPose.TimeStampMicroSeconds = NowMicroSeconds();
+			ring.TryPush({ headPose, headPose.TimeStampMicroSeconds });
+			headPoses = &headPose;
+			headPoseCount = 1;
+#endif
+		}
+		const HeadPose* latestHeadPose = headPoseCount > 0 ? &headPoses[headPoseCount - 1] : nullptr;
+		// Gaze only while someone is there, like the publisher, so the gaze streams get unsubscribed too
+		const bool isPresent = streamsProvider->IsPresent();
+		const bool readGaze = isPresent && (activity == nullptr || activity->ShouldReadHeadPoses());
+		if (recorder.IsOpen())
+		{
+			TRACE_ZONE("RecordFrame");
+			recorder.RecordFrame(api, headPoses, headPoseCount, readGaze);
+		}
+		if (archive.IsOpen())
+		{
+			TRACE_ZONE("Archive");
+			const GazePoint* gazePoints = nullptr;
+			const int gazePointCount = readGaze ? streamsProvider->GetGazePoints(gazePoints) : 0;
+			archive.AddHeadPoses(headPoses, headPoseCount);
+			archive.AddGazePoints(gazePoints, gazePointCount);
+		}
+		if (pipeline.Publisher != nullptr)
+		{
+			TRACE_ZONE("PublishPoses");
+			pipeline.Publisher->Publish(streamsProvider, extendedView, headPoses, headPoseCount);
+		}
+		if (pipeline.OpenTrackOut != nullptr)
+		{
+			TRACE_ZONE("OpenTrackSend");
+			pipeline.OpenTrackOut->Send(headPoses, headPoseCount);
+		}
+
+		if (activity != nullptr && activity->Advance(NowMicroSeconds(), isPresent, latestHeadPose, !pipeline.Gate->IsOutputAllowed()))
+		{
+			pacing.SetRate(activity->GetRateHz());
+			pipeline.PollPeriodMicroSeconds.store(pacing.GetPeriodMicroSeconds(), std::memory_order_relaxed);
+		}
+	}
 
-	while (!GetAsyncKeyState(VK_F8))
+	if (activity != nullptr)
 	{
-		Sleep(1);
-		api->Update();
+		activity->Finish(NowMicroSeconds());
+	}
+	if (archive.IsOpen() && !archive.Close())
+	{
+		std::cout << "Can't finish " << options.ArchivePath << ", it can still be read without its index" << std::endl;
+	}
+	pipeline.Benchmark.UpdateLateness.Merge(pacing.GetLatenessHistogram());
+	pipeline.Benchmark.MissedUpdateDeadlines = pacing.GetMissedCount();
+	api->Shutdown();
+}
 
-		const Transformation trans = extendedView->GetTransformation();
+// Owns the mapping state and all output: telemetry and mouse.
+void MappingThread(Pipeline& pipeline, const MappingSettings& mappingSettings)
+{
+	HeadPoseRing& ring = pipeline.Ring;
+	MouseOutput& output = *pipeline.Output;
+	TelemetryRenderer& telemetry = *pipeline.Telemetry;
+	OutputGate& gate = *pipeline.Gate;
+	LatencyBenchmark& benchmark = pipeline.Benchmark;
+	const bool measure = pipeline.Options.BenchSeconds > 0;
+	// Polls an empty ring at twice the Update() rate, off the tick grid
+	PacedScheduler idle{ 2.0 * pipeline.Options.UpdateRateHz };
 
-		std::cout << std::fixed << std::setprecision(3);
-		std::cout << "Extended View Rot(deg) [Y: " << trans.Rotation.YawDegrees << ",P: " << trans.Rotation.PitchDegrees << ",R: " << trans.Rotation.RollDegrees << "] " <<
-			"Pos(mm) [X: " << trans.Position.X << ",Y: " << trans.Position.Y << ",Z: " << trans.Position.Z << "]          \r";
+	std::unique_ptr<MappingEngine> mapper = CreateMappingEngine(pipeline.Strategy, mappingSettings);
+	const bool isHoldStrategy = pipeline.Strategy.Kind == MappingStrategyKind::Hold;
+	std::unique_ptr<OutputCoalescer> coalescer;
+	if (pipeline.Options.CoalesceRateHz > 0.0)
+	{
+		coalescer = std::make_unique<OutputCoalescer>(output, pipeline.Options.CoalesceRateHz, pipeline.Options.CoalescePolicy);
+	}
+	PredictionSettings predictionSettings;
+	predictionSettings.HorizonMicroSeconds = pipeline.Options.PredictMilliseconds * int64_t{ 1000 };
+	PosePredictor predictor{ predictionSettings };
+	MappingStep step{ *mapper, pipeline.Filter, predictor, gate, output, coalescer.get(), pipeline.Options.ResyncOnResume };
+	HeadPose headPoses[k_deltaBatchSize];
+	MouseDelta deltas[k_deltaBatchSize];
+	QueuedHeadPose queued;
+	std::unique_ptr<ArrivalHistory> arrivals = measure ? std::make_unique<ArrivalHistory>() : nullptr;
+	int64_t lastBatch = -1;
+	int64_t batchStart = 0;
 
-		if (IsCursorVisible())
+	TRACE_THREAD("mapping");
+	while (pipeline.Running.load(std::memory_order_relaxed))
+	{
+		int headPoseCount = 0;
+		while (headPoseCount < k_deltaBatchSize && ring.TryPop(queued))
+		{
+			headPoses[headPoseCount++] = queued.Pose;
+			if (arrivals != nullptr)
+			{
+				arrivals->Add(queued.Pose.TimeStampMicroSeconds, queued.ArrivalMicroSeconds);
+			}
+		}
+		if (headPoseCount == 0)
 		{
+			// Motion that was waiting for the end of its output period
+			step.Poll(NowMicroSeconds());
+			idle.WaitUntil(NowMicroSeconds() + pipeline.PollPeriodMicroSeconds.load(std::memory_order_relaxed) / 2);
 			continue;
 		}
+		TRACE_ZONE("Batch");
+		if (measure)
+		{
+			const int64_t now = NowMicroSeconds();
+			if (lastBatch >= 0)
+			{
+				benchmark.MappingPeriod.Record(now - lastBatch);
+			}
+			lastBatch = now;
+			batchStart = now;
+		}
 
-		static float actualYaw = 0.0f;
-		static float actualPitch = 0.0f;
+		// Picks up a reloaded profile, the emitted position carries over
+		mapper->SetCurves(pipeline.Curves.Acquire());
+		// Left Alt, like the old 3P.cpp, sampled by the gate's watcher thread
+		if (isHoldStrategy)
+		{
+			mapper->SetModifierHeld(gate.IsModifierHeld());
+		}
 
-		auto desiredYaw = trans.Rotation.YawDegrees;
-		bool yawDead = std::abs(desiredYaw) < k_deadYawIRL;
-		desiredYaw = std::clamp(desiredYaw, -k_maxYawIRL, k_maxYawIRL);
-		if (!yawDead)
+		TelemetrySnapshot snapshot;
+		snapshot.QueueDepth = static_cast<uint32_t>(ring.Size());
+		const int deltaCount = step.MapBatch(headPoses, headPoseCount, NowMicroSeconds(), deltas, snapshot);
 		{
-			desiredYaw -= k_deadYawIRL * (desiredYaw >= 0.0f ? 1.0f : -1.0f);
+			TRACE_ZONE("PublishTelemetry");
+			telemetry.Publish(snapshot);
 		}
 
-		auto desiredPitch = trans.Rotation.PitchDegrees;
-		bool pitchDead = std::abs(desiredPitch) < k_deadPitchIRL;
-		desiredPitch = std::clamp(desiredPitch, -k_maxPitchIRL, k_maxPitchIRL);
-		if (!pitchDead)
+		if (measure)
 		{
-			desiredPitch -= k_deadPitchIRL * (desiredPitch >= 0.0f ? 1.0f : -1.0f);
+			const int64_t emitted = NowMicroSeconds();
+			for (int i = 0; i < deltaCount; i++)
+			{
+				int64_t arrival;
+				if (arrivals->Find(deltas[i].TimeStampMicroSeconds, arrival))
+				{
+					benchmark.ArrivalToEmit.Record(emitted - arrival);
+				}
+				const int64_t latency = emitted - deltas[i].TimeStampMicroSeconds;
+				if (latency >= 0 && latency <= k_maxPlausibleLatencyMicroSeconds)
+				{
+					benchmark.SampleToEmit.Record(latency);
+				}
+				else
+				{
+					benchmark.ClockMismatches++;
+				}
+			}
+			benchmark.BatchWork.Record(NowMicroSeconds() - batchStart);
 		}
+	}
+}
+
+void PrintLatencyBenchmark(const LatencyBenchmark& benchmark)
+{
+	std::cout << std::endl;
+	benchmark.ArrivalToEmit.Print(std::cout, "Head pose arrival to mouse delta latency");
+	if (benchmark.ClockMismatches == 0)
+	{
+		benchmark.SampleToEmit.Print(std::cout, "Head pose timestamp to mouse delta latency");
+	}
+	else
+	{
+		std::cout << "  " << benchmark.ClockMismatches << " head pose timestamps are on another clock, timestamp to mouse delta latency not reported" << std::endl;
+	}
+	benchmark.UpdatePeriod.Print(std::cout, "Tracker Update() period");
+	std::cout << "  " << benchmark.MissedUpdateDeadlines << " Update() deadlines missed" << std::endl;
+	benchmark.UpdateLateness.Print(std::cout, "Tracker wake-up after deadline");
+	benchmark.MappingPeriod.Print(std::cout, "Mapping batch period");
+	benchmark.BatchWork.Print(std::cout, "Mapping batch work");
+}
 
-		desiredYaw *= k_sens;
-		desiredPitch *= k_sens * k_ySensMult;
+void PrintFilterCosts(const HeadPoseFilter& filter)
+{
+	for (int i = 0; i < filter.GetStageCount(); i++)
+	{
+		const FilterStageStats& stats = filter.GetStageStats(i);
+		std::cout << "Filter stage " << i << " (" << DescribeFilterStage(filter.GetStageSettings(i)) << "): " << stats.Samples << " poses";
+		if (stats.Samples > 0)
+		{
+			std::cout << ", " << static_cast<double>(stats.NanoSeconds) / stats.Samples << " ns/pose";
+		}
+		std::cout << std::endl;
+	}
+}
 
-		if (yawDead)
+int main(int argc, char** argv) {
+	auto pipeline = std::make_unique<Pipeline>();
+	pipeline->Options = ParseOptions(argc, argv);
+	pipeline->Output = CreateMouseOutput(pipeline->Options.OutputSpec.c_str());
+	if (pipeline->Output == nullptr)
+	{
+		return 1;
+	}
+	if (!pipeline->Options.ProfilePath.empty())
+	{
+		ResponseProfile profile;
+		std::string error;
+		if (!LoadResponseProfile(pipeline->Options.ProfilePath.c_str(), profile, error))
 		{
-			desiredYaw = 0.0f;
+			std::cout << error << std::endl;
+			return 1;
 		}
-		if (pitchDead)
+		if (profile.HasCurves)
 		{
-			desiredPitch = 0.0f;
+			pipeline->Curves.Publish(std::make_unique<const ResponseCurves>(profile));
 		}
+		pipeline->Strategy = profile.Strategy;
+	}
+	std::string filterError;
+	if (!ParseFilterChain(pipeline->Options.FilterSpec, pipeline->Filter, filterError))
+	{
+		std::cout << filterError << std::endl;
+		return 1;
+	}
+	pipeline->Gate = CreateOutputGate(pipeline->Options.GateSpec.c_str(), GetConsoleHwnd());
+	if (pipeline->Gate == nullptr)
+	{
+		return 1;
+	}
+	pipeline->Telemetry = std::make_unique<TelemetryRenderer>(pipeline->Options.TelemetryRateHz);
+	if (!pipeline->Options.OpenTrackOut.empty())
+	{
+		std::string address = "127.0.0.1", openTrackError;
+		uint16_t port = k_defaultOpenTrackPort;
+		pipeline->OpenTrackOut = std::make_unique<OpenTrackSender>();
+		if (!ParseOpenTrackEndpoint(pipeline->Options.OpenTrackOut, address, port) || !pipeline->OpenTrackOut->Open(address, port, openTrackError))
+		{
+			std::cout << "Can't send OpenTrack packets to " << pipeline->Options.OpenTrackOut << " " << openTrackError << std::endl;
+			return 1;
+		}
+	}
+	if (!pipeline->Options.PublishName.empty())
+	{
+		pipeline->Publisher = std::make_unique<SharedPosePublisher>();
+		std::string publishError;
+		if (!pipeline->Publisher->Create(pipeline->Options.PublishName, publishError))
+		{
+			std::cout << "Can't publish poses as " << pipeline->Options.PublishName << ": " << publishError << std::endl;
+			return 1;
+		}
+	}
+	if (pipeline->Options.IdleThrottling)
+	{
+		ActivitySettings activitySettings;
+		activitySettings.ActiveRateHz = pipeline->Options.UpdateRateHz;
+		pipeline->Activity = std::make_unique<ActivityGovernor>(activitySettings);
+	}
 
-		auto desiredDeltaYaw = desiredYaw - actualYaw;
-		auto desiredDeltaPitch = desiredPitch - actualPitch;
-
-		long dx = static_cast<long>(std::round(desiredDeltaYaw));
-		long minusDy = static_cast<long>(std::round(desiredDeltaPitch));
+	// Before the threads: the mapping thread may emit as soon as it starts
+	pipeline->Gate->Start();
+	std::thread trackerThread{ TrackerThread, std::ref(*pipeline) };
+	const std::optional<MappingSettings> mappingSettings = pipeline->MappingSettingsPromise.get_future().get();
+	if (!mappingSettings)
+	{
+		trackerThread.join();
+		pipeline->Gate->Stop();
+		return 1;
+	}
+	std::thread mappingThread{ MappingThread, std::ref(*pipeline), std::cref(*mappingSettings) };
 
-		actualYaw += static_cast<float>(dx);
-		actualPitch += static_cast<float>(minusDy);
+	std::cout << "F8 to exit, F7 to pause or resume mouse output" << (pipeline->Options.TracePath.empty() ? "" : ", F9 to write a trace") <<
+		std::endl << std::endl;
+	pipeline->Telemetry->Start();
+	std::unique_ptr<ProfileWatcher> profileWatcher;
+	if (!pipeline->Options.ProfilePath.empty())
+	{
+		profileWatcher = std::make_unique<ProfileWatcher>(pipeline->Options.ProfilePath, pipeline->Curves);
+		profileWatcher->Start();
+	}
 
-		if (dx || minusDy)
+	const int64_t benchEnd = NowMicroSeconds() + pipeline->Options.BenchSeconds * int64_t{ 1'000'000 };
+	while (!GetAsyncKeyState(VK_F8) && (pipeline->Options.BenchSeconds == 0 || NowMicroSeconds() < benchEnd))
+	{
+		Sleep(50);
+		// Low bit: pressed since the previous call. Right after a stutter, while it is still in the rings
+		if (!pipeline->Options.TracePath.empty() && (GetAsyncKeyState(VK_F9) & 1))
 		{
-			mouse_event(MOUSEEVENTF_MOVE, static_cast<DWORD>(dx), static_cast<DWORD>(-minusDy), 0, 0);
+			std::string traceError;
+			if (WriteChromeTrace(pipeline->Options.TracePath.c_str(), pipeline->Options.TraceSeconds, traceError))
+			{
+				std::cout << std::endl << "Last " << pipeline->Options.TraceSeconds << " s traced to " << pipeline->Options.TracePath << std::endl;
+			}
+			else
+			{
+				std::cout << std::endl << "No trace written: " << traceError << std::endl;
+			}
 		}
 	}
 
-	api->Shutdown();
+	pipeline->Running = false;
+	trackerThread.join();
+	mappingThread.join();
+	profileWatcher.reset();
+	pipeline->Gate->Stop();
+	pipeline->Telemetry->Stop();
+
+	const SpscRingStats stats = pipeline->Ring.GetStats();
+	std::cout << std::endl << "Poses pushed: " << stats.Pushed << ", overruns: " << stats.Overruns << ", max depth: " << stats.MaxDepthAtPush <<
+		", popped: " << stats.Popped << ", empty polls: " << stats.EmptyPolls << ", max depth at pop: " << stats.MaxDepthAtPop << std::endl;
+	if (pipeline->Activity != nullptr)
+	{
+		pipeline->Activity->Print(std::cout);
+	}
+	if (pipeline->OpenTrackOut != nullptr)
+	{
+		std::cout << "OpenTrack packets sent: " << pipeline->OpenTrackOut->GetSentCount() << ", dropped: " << pipeline->OpenTrackOut->GetDroppedCount() << std::endl;
+	}
+	if (pipeline->Options.BenchSeconds > 0)
+	{
+		PrintLatencyBenchmark(pipeline->Benchmark);
+		PrintFilterCosts(pipeline->Filter);
+	}
 }
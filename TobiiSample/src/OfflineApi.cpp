@@ -0,0 +1,229 @@
+#include "OfflineApi.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace TobiiGameIntegration;
+
+OfflineApi::OfflineApi(const char* trackerName)
+{
+	m_trackerInfo.Type = TrackerType::PC;
+	m_trackerInfo.Capabilities = StreamFlags::Presence | StreamFlags::Head | StreamFlags::Gaze | StreamFlags::HMD;
+	m_trackerInfo.Url = trackerName;
+	m_trackerInfo.FriendlyName = trackerName;
+	m_trackerInfo.MonitorNameInOS = "";
+	m_trackerInfo.ModelName = trackerName;
+	m_trackerInfo.Generation = "offline";
+	m_trackerInfo.SerialNumber = "";
+	m_trackerInfo.FirmwareVersion = "";
+	m_trackerInfo.IsAttached = true;
+
+	std::fill(std::begin(m_autoUnsubscribeTimeouts), std::end(m_autoUnsubscribeTimeouts), -1.0f);
+}
+
+bool OfflineApi::GetTrackerInfo(TrackerInfo& trackerInfo)
+{
+	trackerInfo = m_trackerInfo;
+	return true;
+}
+
+bool OfflineApi::GetTrackerInfo(const char* url, TrackerInfo& trackerInfo)
+{
+	if (url == nullptr || std::strcmp(url, m_trackerInfo.Url) != 0)
+	{
+		return false;
+	}
+	trackerInfo = m_trackerInfo;
+	return true;
+}
+
+bool OfflineApi::GetTrackerInfos(const TrackerInfo*& trackerInfos, int& numberOfTrackerInfos)
+{
+	trackerInfos = &m_trackerInfo;
+	numberOfTrackerInfos = 1;
+	return true;
+}
+
+bool OfflineApi::IsStreamSupported(const StreamFlags& stream) const
+{
+	return (m_trackerInfo.Capabilities & stream) == stream;
+}
+
+int OfflineApi::GetHeadPoses(const HeadPose*& headPoses)
+{
+	headPoses = m_headPoses.data();
+	return static_cast<int>(m_headPoses.size());
+}
+
+bool OfflineApi::GetLatestHeadPose(HeadPose& headPose)
+{
+	if (m_hasHeadPose)
+	{
+		headPose = m_latestHeadPose;
+	}
+	return m_hasHeadPose;
+}
+
+int OfflineApi::GetGazePoints(const GazePoint*& gazePoints)
+{
+	gazePoints = m_gazePoints.data();
+	return static_cast<int>(m_gazePoints.size());
+}
+
+bool OfflineApi::GetLatestGazePoint(GazePoint& gazePoint)
+{
+	if (m_hasGazePoint)
+	{
+		gazePoint = m_latestGazePoint;
+	}
+	return m_hasGazePoint;
+}
+
+int OfflineApi::GetHMDGaze(const HMDGaze*& hmdGaze)
+{
+	hmdGaze = m_hmdGazes.data();
+	return static_cast<int>(m_hmdGazes.size());
+}
+
+bool OfflineApi::GetLatestHMDGaze(HMDGaze& latestHMDGaze)
+{
+	if (m_hasHMDGaze)
+	{
+		latestHMDGaze = m_latestHMDGaze;
+	}
+	return m_hasHMDGaze;
+}
+
+void OfflineApi::SetAutoUnsubscribe(StreamType stream, float timeout)
+{
+	if (stream < StreamType::Count)
+	{
+		m_autoUnsubscribeTimeouts[static_cast<int>(stream)] = timeout;
+	}
+}
+
+void OfflineApi::UnsetAutoUnsubscribe(StreamType stream)
+{
+	SetAutoUnsubscribe(stream, -1.0f);
+}
+
+float OfflineApi::GetAutoUnsubscribeTimeout(StreamType stream) const
+{
+	return stream < StreamType::Count ? m_autoUnsubscribeTimeouts[static_cast<int>(stream)] : -1.0f;
+}
+
+void OfflineApi::ConvertGazePoint(const GazePoint& fromGazePoint, GazePoint& toGazePoint, UnitType fromUnit, UnitType toUnit)
+{
+	// There is no window to measure offline, only the two normalized spaces convert.
+	toGazePoint = fromGazePoint;
+	if (fromUnit == UnitType::SignedNormalized && toUnit == UnitType::Normalized)
+	{
+		toGazePoint.X = (fromGazePoint.X + 1.0f) * 0.5f;
+		toGazePoint.Y = (fromGazePoint.Y + 1.0f) * 0.5f;
+	}
+	else if (fromUnit == UnitType::Normalized && toUnit == UnitType::SignedNormalized)
+	{
+		toGazePoint.X = fromGazePoint.X * 2.0f - 1.0f;
+		toGazePoint.Y = fromGazePoint.Y * 2.0f - 1.0f;
+	}
+}
+
+Transformation OfflineApi::GetTransformation()
+{
+	return m_isPaused ? Transformation() : m_transformation;
+}
+
+bool OfflineApi::UpdateSettings(const ExtendedViewSettings& settings)
+{
+	m_settings = settings;
+	return true;
+}
+
+void OfflineApi::ResetDefaultHeadPose()
+{
+	m_defaultHeadPose = m_latestHeadPose;
+	m_transformation = Transformation();
+}
+
+void OfflineApi::Pause(bool reCenter, float transitionDuration)
+{
+	m_isPaused = true;
+	if (reCenter)
+	{
+		ResetDefaultHeadPose();
+	}
+}
+
+void OfflineApi::GetAimAtGazeFilterGazePoint(GazePoint& gazePoint, float& gazePointStability) const
+{
+	gazePoint = m_latestGazePoint;
+	gazePointStability = 1.0f;
+}
+
+void OfflineApi::BeginFrame()
+{
+	m_headPoses.clear();
+	m_gazePoints.clear();
+	m_hmdGazes.clear();
+}
+
+void OfflineApi::AddHeadPose(const HeadPose& headPose)
+{
+	m_headPoses.push_back(headPose);
+	m_latestHeadPose = headPose;
+	m_hasHeadPose = true;
+	m_transformation = ViewFromHeadPose(headPose);
+}
+
+void OfflineApi::AddGazePoint(const GazePoint& gazePoint)
+{
+	m_gazePoints.push_back(gazePoint);
+	m_latestGazePoint = gazePoint;
+	m_hasGazePoint = true;
+}
+
+void OfflineApi::AddHMDGaze(const HMDGaze& hmdGaze)
+{
+	m_hmdGazes.push_back(hmdGaze);
+	m_latestHMDGaze = hmdGaze;
+	m_hasHMDGaze = true;
+}
+
+void OfflineApi::SetTransformation(const Transformation& transformation)
+{
+	m_transformation = transformation;
+}
+
+static float ScaleAxis(float value, const AxisSettings& positive, const AxisSettings& negative)
+{
+	const AxisSettings& axis = value >= 0.0f ? positive : negative;
+	const float scaled = value * axis.SensitivityScaling.Value;
+	return value >= 0.0f ? (std::min)(scaled, axis.Limit.Value) : (std::max)(scaled, axis.Limit.Value);
+}
+
+Transformation OfflineApi::ViewFromHeadPose(const HeadPose& headPose) const
+{
+	const HeadTrackingSettings& headTracking = m_settings.HeadTracking;
+	Transformation view;
+	if (!headTracking.Enabled)
+	{
+		return view;
+	}
+
+	view.Rotation.YawDegrees = ScaleAxis(headPose.Rotation.YawDegrees - m_defaultHeadPose.Rotation.YawDegrees,
+		headTracking.YawRightDegrees, headTracking.YawLeftDegrees);
+	view.Rotation.PitchDegrees = ScaleAxis(headPose.Rotation.PitchDegrees - m_defaultHeadPose.Rotation.PitchDegrees,
+		headTracking.PitchUpDegrees, headTracking.PitchDownDegrees);
+	if (headTracking.RotationRollEnabled)
+	{
+		view.Rotation.RollDegrees = ScaleAxis(headPose.Rotation.RollDegrees - m_defaultHeadPose.Rotation.RollDegrees,
+			headTracking.RollRightDegrees, headTracking.RollLeftDegrees);
+	}
+
+	if (headTracking.PositionEnabled)
+	{
+		view.Position.X = ScaleAxis(headPose.Position.X - m_defaultHeadPose.Position.X, headTracking.XRightMm, headTracking.XLeftMm);
+		view.Position.Y = ScaleAxis(headPose.Position.Y - m_defaultHeadPose.Position.Y, headTracking.YUpMm, headTracking.YDownMm);
+		view.Position.Z = ScaleAxis(headPose.Position.Z - m_defaultHeadPose.Position.Z, headTracking.ZBackMm, headTracking.ZForwardMm);
+	}
+	return view;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "TobiiPlatform.h"
+#include <vector>
+
+// Base for ITobiiGameIntegrationApi implementations that do not talk to a tracker
+// (replay, synthetic, network input). One object implements every interface the samples use.
+// Derived classes implement Update(): call BeginFrame() and then add the samples for that frame.
+// Like the real API, the object is released by Shutdown().
+class OfflineApi :
+	public TobiiGameIntegration::ITobiiGameIntegrationApi,
+	public TobiiGameIntegration::ITrackerController,
+	public TobiiGameIntegration::IStreamsProvider,
+	public TobiiGameIntegration::IFeatures,
+	public TobiiGameIntegration::IExtendedView,
+	public TobiiGameIntegration::IStatistics,
+	public TobiiGameIntegration::IFilters
+{
+public:
+	OfflineApi(const char* trackerName);
+	virtual ~OfflineApi() = default;
+
+	// ITobiiGameIntegrationApi
+	TobiiGameIntegration::ITrackerController* GetTrackerController() override { return this; }
+	TobiiGameIntegration::IStreamsProvider* GetStreamsProvider() override { return this; }
+	TobiiGameIntegration::IFeatures* GetFeatures() override { return this; }
+	TobiiGameIntegration::IStatistics* GetStatistics() override { return this; }
+	TobiiGameIntegration::IFilters* GetFilters() override { return this; }
+	bool IsInitialized() override { return true; }
+	void Shutdown() override { delete this; }
+
+	// ITrackerController
+	bool GetTrackerInfo(TobiiGameIntegration::TrackerInfo& trackerInfo) override;
+	bool GetTrackerInfo(const char* url, TobiiGameIntegration::TrackerInfo& trackerInfo) override;
+	void UpdateTrackerInfos() override { }
+	bool GetTrackerInfos(const TobiiGameIntegration::TrackerInfo*& trackerInfos, int& numberOfTrackerInfos) override;
+	bool TrackHMD() override { m_isTracking = true; return true; }
+	bool TrackRectangle(const TobiiGameIntegration::Rectangle& rectangle) override { m_isTracking = true; return true; }
+	bool TrackWindow(void* windowHandle) override { m_isTracking = true; return true; }
+	void StopTracking() override { m_isTracking = false; }
+	bool IsConnected() const override { return m_isTracking; }
+	bool IsEnabled() const override { return true; }
+	bool IsStreamSupported(const TobiiGameIntegration::StreamFlags& stream) const override;
+
+	// IStreamsProvider
+	int GetHeadPoses(const TobiiGameIntegration::HeadPose*& headPoses) override;
+	bool GetLatestHeadPose(TobiiGameIntegration::HeadPose& headPose) override;
+	int GetGazePoints(const TobiiGameIntegration::GazePoint*& gazePoints) override;
+	bool GetLatestGazePoint(TobiiGameIntegration::GazePoint& gazePoint) override;
+	int GetHMDGaze(const TobiiGameIntegration::HMDGaze*& hmdGaze) override;
+	bool GetLatestHMDGaze(TobiiGameIntegration::HMDGaze& latestHMDGaze) override;
+	bool IsPresent() override { return m_isPresent; }
+	void SetAutoUnsubscribe(TobiiGameIntegration::StreamType stream, float timeout) override;
+	void UnsetAutoUnsubscribe(TobiiGameIntegration::StreamType stream) override;
+	void ConvertGazePoint(const TobiiGameIntegration::GazePoint& fromGazePoint, TobiiGameIntegration::GazePoint& toGazePoint,
+		TobiiGameIntegration::UnitType fromUnit, TobiiGameIntegration::UnitType toUnit) override;
+
+	// IFeatures
+	TobiiGameIntegration::IExtendedView* GetExtendedView() override { return this; }
+
+	// IExtendedView
+	TobiiGameIntegration::Transformation GetTransformation() override;
+	bool UpdateSettings(const TobiiGameIntegration::ExtendedViewSettings& settings) override;
+	void ResetDefaultHeadPose() override;
+	void Pause(bool reCenter, float transitionDuration = 0.2f) override;
+	void UnPause(float transitionDuration = 0.2f) override { m_isPaused = false; }
+	bool IsPaused() override { return m_isPaused; }
+	void GetSettings(TobiiGameIntegration::ExtendedViewSettings& settings) const override { settings = m_settings; }
+
+	// IStatistics
+	void SetFeatureList(const TobiiGameIntegration::Feature* gameFeatures, int numberOfFeatures) override { }
+	const char* GetLiteral(TobiiGameIntegration::Literal literal) const override { return ""; }
+	void SendFeatureEnabled(int featureId) override { }
+	void SendFeatureDisabled(int featureId) override { }
+	void SendFeaturesState() override { }
+	void StopAllLogging() override { }
+	void ResumeAllLogging() override { }
+
+	// IFilters
+	const TobiiGameIntegration::ResponsiveFilterSettings& GetResponsiveFilterSettings() const override { return m_responsiveFilterSettings; }
+	void SetResponsiveFilterSettings(TobiiGameIntegration::ResponsiveFilterSettings settings) override { m_responsiveFilterSettings = settings; }
+	const TobiiGameIntegration::AimAtGazeFilterSettings& GetAimAtGazeFilterSettings() const override { return m_aimAtGazeFilterSettings; }
+	void SetAimAtGazeFilterSettings(TobiiGameIntegration::AimAtGazeFilterSettings settings) override { m_aimAtGazeFilterSettings = settings; }
+	void GetResponsiveFilterGazePoint(TobiiGameIntegration::GazePoint& gazePoint) const override { gazePoint = m_latestGazePoint; }
+	void GetAimAtGazeFilterGazePoint(TobiiGameIntegration::GazePoint& gazePoint, float& gazePointStability) const override;
+
+	// True once a finite source (recording, fixed-length synthetic run) has nothing more to produce.
+	virtual bool IsFinished() const { return false; }
+
+	// Timeout set through SetAutoUnsubscribe(), negative when unset.
+	float GetAutoUnsubscribeTimeout(TobiiGameIntegration::StreamType stream) const;
+
+protected:
+	// Clears the per-Update() stream buffers. The latest samples are kept.
+	void BeginFrame();
+	// Also derives the Extended View transformation from the pose unless SetTransformation() is used.
+	void AddHeadPose(const TobiiGameIntegration::HeadPose& headPose);
+	void AddGazePoint(const TobiiGameIntegration::GazePoint& gazePoint);
+	void AddHMDGaze(const TobiiGameIntegration::HMDGaze& hmdGaze);
+	void SetPresent(bool isPresent) { m_isPresent = isPresent; }
+	// Use a recorded transformation instead of deriving one from the head poses.
+	void SetTransformation(const TobiiGameIntegration::Transformation& transformation);
+
+	TobiiGameIntegration::ExtendedViewSettings m_settings;
+
+private:
+	// Rough stand-in for Extended View: default head pose offset, per-direction sensitivity and limits.
+	TobiiGameIntegration::Transformation ViewFromHeadPose(const TobiiGameIntegration::HeadPose& headPose) const;
+
+	TobiiGameIntegration::TrackerInfo m_trackerInfo;
+	bool m_isTracking = false;
+	bool m_isPresent = false;
+	bool m_isPaused = false;
+
+	std::vector<TobiiGameIntegration::HeadPose> m_headPoses;
+	std::vector<TobiiGameIntegration::GazePoint> m_gazePoints;
+	std::vector<TobiiGameIntegration::HMDGaze> m_hmdGazes;
+	TobiiGameIntegration::HeadPose m_latestHeadPose;
+	TobiiGameIntegration::GazePoint m_latestGazePoint;
+	TobiiGameIntegration::HMDGaze m_latestHMDGaze;
+	bool m_hasHeadPose = false;
+	bool m_hasGazePoint = false;
+	bool m_hasHMDGaze = false;
+
+	TobiiGameIntegration::Transformation m_transformation;
+	TobiiGameIntegration::Transformation m_defaultHeadPose;
+	float m_autoUnsubscribeTimeouts[static_cast<int>(TobiiGameIntegration::StreamType::Count)];
+
+	TobiiGameIntegration::ResponsiveFilterSettings m_responsiveFilterSettings;
+	TobiiGameIntegration::AimAtGazeFilterSettings m_aimAtGazeFilterSettings;
+};
@@ -0,0 +1,67 @@
+#include "OpenTrackApi.h"
+#include "Clock.h"
+#include <sstream>
+
+using namespace TobiiGameIntegration;
+
+bool ParseOpenTrackSettings(const std::string& spec, OpenTrackSettings& settings, std::string& error)
+{
+	std::istringstream entries{ spec };
+	std::string entry;
+	bool first = true;
+	while (std::getline(entries, entry, ','))
+	{
+		bool ok = false;
+		if (first && entry.find('=') == std::string::npos)
+		{
+			ok = ParseOpenTrackEndpoint(entry, settings.Address, settings.Port);
+		}
+		else if (entry.rfind("timeout=", 0) == 0)
+		{
+			try
+			{
+				settings.TimeoutSeconds = std::stof(entry.substr(8));
+				ok = settings.TimeoutSeconds >= 0.0f;
+			}
+			catch (const std::exception&)
+			{
+			}
+		}
+		first = false;
+
+		if (!ok)
+		{
+			error = "bad opentrack setting '" + entry + "'";
+			return false;
+		}
+	}
+	return true;
+}
+
+OpenTrackApi::OpenTrackApi(const OpenTrackSettings& settings)
+	: OfflineApi("opentrack"), m_settings{ settings }
+{ }
+
+void OpenTrackApi::Update()
+{
+	BeginFrame();
+
+	// Everything queued since the previous Update(), however far the source ran ahead
+	OpenTrackPacket packets[OpenTrackReceiver::k_maxBatch];
+	int64_t receiveMicroSeconds[OpenTrackReceiver::k_maxBatch];
+	int count;
+	do
+	{
+		count = m_receiver.Drain(packets, receiveMicroSeconds, OpenTrackReceiver::k_maxBatch);
+		for (int i = 0; i < count; i++)
+		{
+			AddHeadPose(HeadPoseFromOpenTrack(packets[i], receiveMicroSeconds[i]));
+			m_lastPacketMicroSeconds = receiveMicroSeconds[i];
+		}
+	} while (count == OpenTrackReceiver::k_maxBatch);
+
+	const int64_t silentMicroSeconds = NowMicroSeconds() - m_lastPacketMicroSeconds;
+	SetPresent(m_lastPacketMicroSeconds >= 0 && silentMicroSeconds < static_cast<int64_t>(m_settings.AbsentSeconds * 1e6));
+	m_isFinished = m_settings.TimeoutSeconds > 0.0f && m_lastPacketMicroSeconds >= 0 &&
+		silentMicroSeconds >= static_cast<int64_t>(m_settings.TimeoutSeconds * 1e6);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "OfflineApi.h"
+#include "OpenTrackUdp.h"
+#include <string>
+
+struct OpenTrackSettings
+{
+	std::string Address = "127.0.0.1";
+	uint16_t Port = k_defaultOpenTrackPort;
+	float AbsentSeconds = 0.5f;		// no packet for this long -> not present
+	float TimeoutSeconds = 0.0f;	// >0: IsFinished() once packets stopped for this long, for replays
+};
+
+// Parses "[<address>:]<port>[,timeout=<seconds>]", e.g. "4242" or "0.0.0.0:4242,timeout=5".
+// Returns false and names the offending entry in error.
+bool ParseOpenTrackSettings(const std::string& spec, OpenTrackSettings& settings, std::string& error);
+
+// Head poses from anything that speaks OpenTrack's UDP output (OpenTrack itself, phone and webcam
+// trackers), for machines without a Tobii tracker. Presence follows the packet stream; there is no gaze.
+class OpenTrackApi : public OfflineApi
+{
+public:
+	explicit OpenTrackApi(const OpenTrackSettings& settings);
+
+	// Listens on the configured port, false and why if that fails.
+	bool Open(std::string& error) { return m_receiver.Open(m_settings.Address, m_settings.Port, error); }
+
+	void Update() override;
+	bool IsFinished() const override { return m_isFinished; }
+
+	const OpenTrackReceiver& GetReceiver() const { return m_receiver; }
+
+private:
+	OpenTrackSettings m_settings;
+	OpenTrackReceiver m_receiver;
+	int64_t m_lastPacketMicroSeconds = -1;
+	bool m_isFinished = false;
+};
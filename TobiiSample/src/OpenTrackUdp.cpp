@@ -0,0 +1,347 @@
+#include "OpenTrackUdp.h"
+#include "Clock.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <ctime>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace TobiiGameIntegration;
+
+// Room for a 1 kHz source to run ahead of a stalled reader for a quarter of a second
+static constexpr int k_receiveBufferBytes = 256 * 1024;
+
+HeadPose HeadPoseFromOpenTrack(const OpenTrackPacket& packet, int64_t timeStampMicroSeconds)
+{
+	HeadPose headPose;
+	headPose.Position.X = static_cast<float>(packet.X * 10.0);
+	headPose.Position.Y = static_cast<float>(packet.Y * 10.0);
+	headPose.Position.Z = static_cast<float>(packet.Z * 10.0);
+	headPose.Rotation.YawDegrees = static_cast<float>(packet.YawDegrees);
+	headPose.Rotation.PitchDegrees = static_cast<float>(packet.PitchDegrees);
+	headPose.Rotation.RollDegrees = static_cast<float>(packet.RollDegrees);
+	headPose.TimeStampMicroSeconds = timeStampMicroSeconds;
+	return headPose;
+}
+
+OpenTrackPacket OpenTrackFromHeadPose(const Transformation& transformation)
+{
+	return OpenTrackPacket{ transformation.Position.X / 10.0, transformation.Position.Y / 10.0, transformation.Position.Z / 10.0,
+		transformation.Rotation.YawDegrees, transformation.Rotation.PitchDegrees, transformation.Rotation.RollDegrees };
+}
+
+bool ParseOpenTrackEndpoint(const std::string& text, std::string& address, uint16_t& port)
+{
+	const size_t colon = text.rfind(':');
+	if (colon != std::string::npos)
+	{
+		address = text.substr(0, colon);
+	}
+	try
+	{
+		const int value = std::stoi(text.substr(colon == std::string::npos ? 0 : colon + 1));
+		if (value <= 0 || value > 65535)
+		{
+			return false;
+		}
+		port = static_cast<uint16_t>(value);
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+	return !address.empty();
+}
+
+#ifdef _WIN32
+
+static std::string SocketErrorText(const char* what)
+{
+	return std::string{ what } + " failed, error " + std::to_string(WSAGetLastError());
+}
+
+static void CloseSocket(intptr_t& socketHandle)
+{
+	if (socketHandle != -1)
+	{
+		closesocket(static_cast<SOCKET>(socketHandle));
+		WSACleanup();
+		socketHandle = -1;
+	}
+}
+
+#else
+
+static std::string SocketErrorText(const char* what)
+{
+	return std::string{ what } + " failed: " + std::strerror(errno);
+}
+
+static void CloseSocket(intptr_t& socketHandle)
+{
+	if (socketHandle != -1)
+	{
+		close(static_cast<int>(socketHandle));
+		socketHandle = -1;
+	}
+}
+
+#endif
+
+// Non-blocking UDP socket, bound to address:port when binding, otherwise connected to it.
+static bool OpenUdpSocket(const std::string& address, uint16_t port, bool binding, intptr_t& socketHandle, std::string& error)
+{
+	sockaddr_in endpoint{};
+	endpoint.sin_family = AF_INET;
+	endpoint.sin_port = htons(port);
+	if (inet_pton(AF_INET, address.c_str(), &endpoint.sin_addr) != 1)
+	{
+		error = "invalid IPv4 address " + address;
+		return false;
+	}
+
+#ifdef _WIN32
+	WSADATA data;
+	if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+	{
+		error = "WSAStartup failed";
+		return false;
+	}
+	const SOCKET created = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (created == INVALID_SOCKET)
+	{
+		error = SocketErrorText("socket");
+		WSACleanup();
+		return false;
+	}
+	socketHandle = static_cast<intptr_t>(created);
+	u_long nonBlocking = 1;
+	const bool configured = ioctlsocket(created, FIONBIO, &nonBlocking) == 0;
+#else
+	const int created = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (created < 0)
+	{
+		error = SocketErrorText("socket");
+		return false;
+	}
+	socketHandle = created;
+	const int enabled = 1;
+	// Per-datagram arrival times, so a batch drained at once keeps its original spacing
+	const bool configured = !binding || setsockopt(created, SOL_SOCKET, SO_TIMESTAMPNS, &enabled, sizeof(enabled)) == 0;
+#endif
+	if (!configured)
+	{
+		error = SocketErrorText("configuring the socket");
+		CloseSocket(socketHandle);
+		return false;
+	}
+
+	if (binding)
+	{
+		const int bufferBytes = k_receiveBufferBytes;
+		setsockopt(socketHandle, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&bufferBytes), sizeof(bufferBytes));
+		if (bind(socketHandle, reinterpret_cast<const sockaddr*>(&endpoint), sizeof(endpoint)) != 0)
+		{
+			error = SocketErrorText("bind");
+			CloseSocket(socketHandle);
+			return false;
+		}
+	}
+	else if (connect(socketHandle, reinterpret_cast<const sockaddr*>(&endpoint), sizeof(endpoint)) != 0)
+	{
+		error = SocketErrorText("connect");
+		CloseSocket(socketHandle);
+		return false;
+	}
+	return true;
+}
+
+OpenTrackReceiver::~OpenTrackReceiver()
+{
+	CloseSocket(m_socket);
+}
+
+bool OpenTrackReceiver::Open(const std::string& address, uint16_t port, std::string& error)
+{
+	CloseSocket(m_socket);
+	return OpenUdpSocket(address, port, true, m_socket, error);
+}
+
+#ifdef _WIN32
+
+int OpenTrackReceiver::Drain(OpenTrackPacket* packets, int64_t* receiveMicroSeconds, int maxCount)
+{
+	// Winsock has no batched receive; each datagram costs one call, plus the one that finds the queue empty
+	const int64_t now = NowMicroSeconds();
+	int count = 0;
+	char buffer[sizeof(OpenTrackPacket) + 1];
+	while (m_socket != -1 && count < maxCount)
+	{
+		const int received = recv(static_cast<SOCKET>(m_socket), buffer, sizeof(buffer), 0);
+		m_systemCallCount++;
+		if (received < 0)
+		{
+			const int error = WSAGetLastError();
+			if (error == WSAEMSGSIZE)
+			{
+				m_malformedCount++;
+				continue;
+			}
+			// WSAEWOULDBLOCK: drained. WSAECONNRESET reports an ICMP error from an earlier send, not data loss.
+			if (error == WSAECONNRESET)
+			{
+				continue;
+			}
+			break;
+		}
+		if (received != sizeof(OpenTrackPacket))
+		{
+			m_malformedCount++;
+			continue;
+		}
+		std::memcpy(&packets[count], buffer, sizeof(OpenTrackPacket));
+		receiveMicroSeconds[count] = now;
+		count++;
+	}
+	m_receivedCount += count;
+	return count;
+}
+
+#else
+
+int OpenTrackReceiver::Drain(OpenTrackPacket* packets, int64_t* receiveMicroSeconds, int maxCount)
+{
+	if (m_socket == -1)
+	{
+		return 0;
+	}
+
+	// Kernel timestamps are on CLOCK_REALTIME, the rest of the pipeline is on NowMicroSeconds()
+	timespec realtime;
+	clock_gettime(CLOCK_REALTIME, &realtime);
+	const int64_t now = NowMicroSeconds();
+	const int64_t realtimeToNow = now - (static_cast<int64_t>(realtime.tv_sec) * 1'000'000 + realtime.tv_nsec / 1000);
+
+	// One byte more than a packet so oversized datagrams show up as MSG_TRUNC instead of fitting
+	char buffers[k_maxBatch][sizeof(OpenTrackPacket) + 1];
+	alignas(cmsghdr) char controls[k_maxBatch][CMSG_SPACE(sizeof(timespec))];
+	iovec vectors[k_maxBatch];
+	mmsghdr messages[k_maxBatch];
+
+	int count = 0;
+	while (count < maxCount)
+	{
+		const int batch = (std::min)(k_maxBatch, maxCount - count);
+		for (int i = 0; i < batch; i++)
+		{
+			vectors[i] = { buffers[i], sizeof(buffers[i]) };
+			messages[i] = {};
+			messages[i].msg_hdr.msg_iov = &vectors[i];
+			messages[i].msg_hdr.msg_iovlen = 1;
+			messages[i].msg_hdr.msg_control = controls[i];
+			messages[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+		}
+		const int received = recvmmsg(static_cast<int>(m_socket), messages, batch, MSG_DONTWAIT, nullptr);
+		m_systemCallCount++;
+		if (received <= 0)
+		{
+			break;
+		}
+
+		for (int i = 0; i < received; i++)
+		{
+			const msghdr& header = messages[i].msg_hdr;
+			if (messages[i].msg_len != sizeof(OpenTrackPacket) || (header.msg_flags & MSG_TRUNC))
+			{
+				m_malformedCount++;
+				continue;
+			}
+			std::memcpy(&packets[count], buffers[i], sizeof(OpenTrackPacket));
+			int64_t arrival = now;
+			for (const cmsghdr* control = CMSG_FIRSTHDR(&header); control != nullptr; control = CMSG_NXTHDR(const_cast<msghdr*>(&header), const_cast<cmsghdr*>(control)))
+			{
+				if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPNS)
+				{
+					timespec stamp;
+					std::memcpy(&stamp, CMSG_DATA(control), sizeof(stamp));
+					arrival = (std::min)(now, static_cast<int64_t>(stamp.tv_sec) * 1'000'000 + stamp.tv_nsec / 1000 + realtimeToNow);
+				}
+			}
+			receiveMicroSeconds[count] = arrival;
+			count++;
+		}
+		if (received < batch)
+		{
+			break;
+		}
+	}
+	m_receivedCount += count;
+	return count;
+}
+
+#endif
+
+OpenTrackSender::~OpenTrackSender()
+{
+	CloseSocket(m_socket);
+}
+
+bool OpenTrackSender::Open(const std::string& address, uint16_t port, std::string& error)
+{
+	CloseSocket(m_socket);
+	return OpenUdpSocket(address, port, false, m_socket, error);
+}
+
+int OpenTrackSender::Send(const HeadPose* headPoses, int count)
+{
+	if (m_socket == -1 || count <= 0)
+	{
+		return 0;
+	}
+
+	int sent = 0;
+#ifdef _WIN32
+	for (int i = 0; i < count; i++)
+	{
+		const OpenTrackPacket packet = OpenTrackFromHeadPose(headPoses[i]);
+		// Nobody listening shows up as WSAECONNRESET on a later call; a pose that isn't taken is dropped either way
+		sent += send(static_cast<SOCKET>(m_socket), reinterpret_cast<const char*>(&packet), sizeof(packet), 0) == sizeof(packet);
+	}
+#else
+	OpenTrackPacket packets[OpenTrackReceiver::k_maxBatch];
+	iovec vectors[OpenTrackReceiver::k_maxBatch];
+	mmsghdr messages[OpenTrackReceiver::k_maxBatch];
+	for (int first = 0; first < count; first += OpenTrackReceiver::k_maxBatch)
+	{
+		const int batch = (std::min)(OpenTrackReceiver::k_maxBatch, count - first);
+		for (int i = 0; i < batch; i++)
+		{
+			packets[i] = OpenTrackFromHeadPose(headPoses[first + i]);
+			vectors[i] = { &packets[i], sizeof(OpenTrackPacket) };
+			messages[i] = {};
+			messages[i].msg_hdr.msg_iov = &vectors[i];
+			messages[i].msg_hdr.msg_iovlen = 1;
+		}
+		// ECONNREFUSED: nobody listening yet, the next call tries again
+		const int batchSent = sendmmsg(static_cast<int>(m_socket), messages, batch, MSG_DONTWAIT);
+		sent += (std::max)(batchSent, 0);
+		if (batchSent < batch)
+		{
+			break;
+		}
+	}
+#endif
+	m_sentCount += sent;
+	m_droppedCount += count - sent;
+	return sent;
+}
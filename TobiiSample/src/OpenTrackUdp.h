@@ -0,0 +1,86 @@
+#pragma once
+
+#include "TobiiPlatform.h"
+#include <cstdint>
+#include <string>
+
+static constexpr uint16_t k_defaultOpenTrackPort = 4242;
+
+// OpenTrack's "UDP over network" format, both directions: one datagram per pose holding six
+// little-endian doubles. Position in centimetres, rotation in degrees.
+struct OpenTrackPacket
+{
+	double X;
+	double Y;
+	double Z;
+	double YawDegrees;
+	double PitchDegrees;
+	double RollDegrees;
+};
+
+static_assert(sizeof(OpenTrackPacket) == 48, "OpenTrackPacket is the wire format");
+
+// Axes are passed through as they are, only the position is converted between cm and the API's mm.
+// If a direction comes out reversed, invert it in OpenTrack's options.
+TobiiGameIntegration::HeadPose HeadPoseFromOpenTrack(const OpenTrackPacket& packet, int64_t timeStampMicroSeconds);
+OpenTrackPacket OpenTrackFromHeadPose(const TobiiGameIntegration::Transformation& transformation);
+
+// Non-blocking UDP receiver. Drain() takes everything queued on the socket with as few system calls as
+// the platform allows: recvmmsg() batches on Linux, one recvfrom() per datagram on Windows.
+class OpenTrackReceiver
+{
+public:
+	static constexpr int k_maxBatch = 64;
+
+	OpenTrackReceiver() = default;
+	~OpenTrackReceiver();
+
+	OpenTrackReceiver(const OpenTrackReceiver&) = delete;
+	OpenTrackReceiver& operator=(const OpenTrackReceiver&) = delete;
+
+	// address: the local address to listen on, "127.0.0.1" for loopback only.
+	bool Open(const std::string& address, uint16_t port, std::string& error);
+
+	// Copies up to maxCount waiting packets, oldest first, and returns how many. Never waits.
+	// receiveMicroSeconds gets each packet's arrival on the NowMicroSeconds() clock: the kernel's receive
+	// timestamp on Linux, the time of the Drain() call elsewhere. Datagrams of the wrong size are skipped.
+	int Drain(OpenTrackPacket* packets, int64_t* receiveMicroSeconds, int maxCount);
+
+	uint64_t GetReceivedCount() const { return m_receivedCount; }
+	uint64_t GetMalformedCount() const { return m_malformedCount; }
+	uint64_t GetSystemCallCount() const { return m_systemCallCount; }
+
+private:
+	intptr_t m_socket = -1;
+	uint64_t m_receivedCount = 0;
+	uint64_t m_malformedCount = 0;
+	uint64_t m_systemCallCount = 0;
+};
+
+// Republishes head poses as OpenTrack packets, one datagram per pose so receivers see the tracker's
+// native rate. Non-blocking: poses that don't fit in the socket buffer are dropped and counted.
+class OpenTrackSender
+{
+public:
+	OpenTrackSender() = default;
+	~OpenTrackSender();
+
+	OpenTrackSender(const OpenTrackSender&) = delete;
+	OpenTrackSender& operator=(const OpenTrackSender&) = delete;
+
+	bool Open(const std::string& address, uint16_t port, std::string& error);
+
+	// Sends the poses in order, batched with sendmmsg() on Linux. Returns how many went out.
+	int Send(const TobiiGameIntegration::HeadPose* headPoses, int count);
+
+	uint64_t GetSentCount() const { return m_sentCount; }
+	uint64_t GetDroppedCount() const { return m_droppedCount; }
+
+private:
+	intptr_t m_socket = -1;
+	uint64_t m_sentCount = 0;
+	uint64_t m_droppedCount = 0;
+};
+
+// Parses "[<address>:]<port>" for --opentrack-out and the opentrack backend. Returns false if invalid.
+bool ParseOpenTrackEndpoint(const std::string& text, std::string& address, uint16_t& port);
@@ -0,0 +1,97 @@
+#include "OutputCoalescer.h"
+#include <string>
+
+OutputCoalescer::OutputCoalescer(MouseOutput& output, double rateHz, CoalescerGatePolicy gatePolicy)
+	: m_output{ output }, m_periodMicroSeconds{ rateHz > 0.0 ? static_cast<int64_t>(1e6 / rateHz) : 0 }, m_gatePolicy{ gatePolicy }
+{ }
+
+void OutputCoalescer::Add(const MouseDelta* deltas, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		m_accumulatedDx += deltas[i].Dx;
+		m_accumulatedMinusDy += deltas[i].MinusDy;
+		if (m_oldestPendingMicroSeconds < 0)
+		{
+			m_oldestPendingMicroSeconds = deltas[i].TimeStampMicroSeconds;
+		}
+	}
+	m_addedCount += count;
+}
+
+bool OutputCoalescer::Poll(int64_t nowMicroSeconds, MouseDelta* emitted)
+{
+	if (nowMicroSeconds - m_lastEmitMicroSeconds < m_periodMicroSeconds)
+	{
+		return false;
+	}
+	return Flush(nowMicroSeconds, emitted);
+}
+
+bool OutputCoalescer::Flush(int64_t nowMicroSeconds, MouseDelta* emitted)
+{
+	const MouseDelta delta{ static_cast<long>(m_accumulatedDx), static_cast<long>(m_accumulatedMinusDy), m_oldestPendingMicroSeconds };
+	m_accumulatedDx = 0;
+	m_accumulatedMinusDy = 0;
+	if (delta.Dx == 0 && delta.MinusDy == 0)
+	{
+		// Motion that cancelled out, nothing to move
+		m_oldestPendingMicroSeconds = -1;
+		return false;
+	}
+
+	m_output.Emit(delta);
+	m_emittedCount++;
+	m_lastEmitMicroSeconds = nowMicroSeconds;
+	m_oldestPendingMicroSeconds = -1;
+	if (emitted != nullptr)
+	{
+		*emitted = delta;
+	}
+	return true;
+}
+
+void OutputCoalescer::Discard()
+{
+	m_accumulatedDx = 0;
+	m_accumulatedMinusDy = 0;
+	m_oldestPendingMicroSeconds = -1;
+}
+
+bool OutputCoalescer::OnGateChanged(bool isOutputAllowed, int64_t nowMicroSeconds)
+{
+	if (isOutputAllowed)
+	{
+		return false;
+	}
+	const bool flushed = m_gatePolicy == CoalescerGatePolicy::Flush && Flush(nowMicroSeconds);
+	Discard();
+	return flushed;
+}
+
+bool ParseCoalescerSpec(const char* text, double& rateHz, CoalescerGatePolicy& gatePolicy)
+{
+	const std::string value{ text };
+	if (value == "off")
+	{
+		rateHz = 0.0;
+		return true;
+	}
+
+	const size_t colon = value.find(':');
+	const std::string policy = colon == std::string::npos ? "" : value.substr(colon + 1);
+	if (!policy.empty() && policy != "flush" && policy != "discard")
+	{
+		return false;
+	}
+	try
+	{
+		rateHz = std::stod(value.substr(0, colon));
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+	gatePolicy = policy == "flush" ? CoalescerGatePolicy::Flush : CoalescerGatePolicy::Discard;
+	return rateHz >= 0.0;
+}
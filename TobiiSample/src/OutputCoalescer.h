@@ -0,0 +1,58 @@
+#pragma once
+
+#include "MouseOutput.h"
+#include <cstdint>
+
+// What happens to motion still waiting in the coalescer when the output gate closes.
+enum class CoalescerGatePolicy
+{
+	Discard,	// dropped, like the motion made while output is held (resync)
+	Flush,		// emitted at once, before the gate takes effect
+};
+
+// Sits between the mapping and a MouseOutput. Sums the mapped deltas per axis and emits them as at
+// most one combined move per output period, like a real mouse's report rate. The deltas are whole counts
+// already (fractions are carried by the mapping itself, e.g. RateIntegrator), so over any window the
+// emitted total equals the added total exactly, whatever the loop rate.
+// Time is whatever clock the caller passes in: NowMicroSeconds() live, sample time in replays.
+// Used from one thread.
+class OutputCoalescer
+{
+public:
+	// rateHz 0: no coalescing, whole counts go out on every Poll().
+	OutputCoalescer(MouseOutput& output, double rateHz, CoalescerGatePolicy gatePolicy = CoalescerGatePolicy::Discard);
+
+	// The timestamp of the oldest pending delta is what the combined move carries, so latency measured
+	// from it covers the coalescing delay.
+	void Add(const MouseDelta* deltas, int count);
+
+	// Emits the pending motion if a period has passed since the previous move. Returns true if a move
+	// went out, and copies it to emitted when given.
+	bool Poll(int64_t nowMicroSeconds, MouseDelta* emitted = nullptr);
+	// Emits the pending motion now.
+	bool Flush(int64_t nowMicroSeconds, MouseDelta* emitted = nullptr);
+	// Drops everything pending.
+	void Discard();
+
+	// Applies the gate policy when output gets blocked. Call on every gate state change. Returns true if
+	// the pending motion was flushed out.
+	bool OnGateChanged(bool isOutputAllowed, int64_t nowMicroSeconds);
+
+	int64_t GetPeriodMicroSeconds() const { return m_periodMicroSeconds; }
+	uint64_t GetAddedCount() const { return m_addedCount; }
+	uint64_t GetEmittedCount() const { return m_emittedCount; }
+
+private:
+	MouseOutput& m_output;
+	int64_t m_periodMicroSeconds;
+	CoalescerGatePolicy m_gatePolicy;
+	int64_t m_accumulatedDx = 0;
+	int64_t m_accumulatedMinusDy = 0;
+	int64_t m_oldestPendingMicroSeconds = -1;
+	int64_t m_lastEmitMicroSeconds = INT64_MIN / 2;
+	uint64_t m_addedCount = 0;
+	uint64_t m_emittedCount = 0;
+};
+
+// Parses "<hz>[:flush]" for --coalesce, "off" or "0" for no coalescing.
+bool ParseCoalescerSpec(const char* text, double& rateHz, CoalescerGatePolicy& gatePolicy);
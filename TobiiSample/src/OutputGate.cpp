@@ -0,0 +1,250 @@
+#include "OutputGate.h"
+#include "Trace.h"
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+void OutputGate::SetReasons(uint32_t reasons)
+{
+	const bool wasAllowed = m_blockedReasons.load(std::memory_order_relaxed) == 0;
+	m_blockedReasons.store(reasons, std::memory_order_relaxed);
+	if (wasAllowed != (reasons == 0))
+	{
+		m_transitionCount.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void OutputGate::SetReason(GateReason reason, bool isSet)
+{
+	const uint32_t reasons = m_blockedReasons.load(std::memory_order_relaxed);
+	SetReasons(isSet ? reasons | reason : reasons & ~static_cast<uint32_t>(reason));
+}
+
+#ifdef _WIN32
+WindowsOutputGate* WindowsOutputGate::s_instance = nullptr;
+
+WindowsOutputGate::WindowsOutputGate(HWND ownWindow, int pauseKey, int modifierKey)
+	: m_ownWindow{ ownWindow }, m_pauseKey{ pauseKey }, m_modifierKey{ modifierKey }
+{ }
+
+WindowsOutputGate::~WindowsOutputGate()
+{
+	Stop();
+}
+
+void WindowsOutputGate::Start()
+{
+	if (m_running)
+	{
+		return;
+	}
+	// The state is right before Start() returns: output must not flow while the cursor is visible or the
+	// console has focus just because the watcher hasn't run yet
+	OnForegroundChanged(GetForegroundWindow());
+	PollCursor();
+	m_running = true;
+	m_thread = std::thread{ &WindowsOutputGate::Run, this };
+}
+
+void WindowsOutputGate::Stop()
+{
+	m_running = false;
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+void CALLBACK WindowsOutputGate::WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND window, LONG objectId, LONG childId,
+	DWORD threadId, DWORD timeMs)
+{
+	WindowsOutputGate* gate = s_instance;
+	if (gate == nullptr)
+	{
+		return;
+	}
+	if (event == EVENT_SYSTEM_FOREGROUND)
+	{
+		gate->OnForegroundChanged(window);
+	}
+	else if (objectId == OBJID_CURSOR)
+	{
+		gate->PollCursor();
+	}
+}
+
+void WindowsOutputGate::PollCursor()
+{
+	TRACE_ZONE("PollCursor");
+	CURSORINFO ci = { sizeof(CURSORINFO) };
+	if (GetCursorInfo(&ci))
+	{
+		SetReason(GateCursorVisible, (ci.flags & CURSOR_SHOWING) != 0);
+	}
+}
+
+void WindowsOutputGate::OnForegroundChanged(HWND window)
+{
+	SetReason(GateFocusLost, m_ownWindow != nullptr && window == m_ownWindow);
+}
+
+void WindowsOutputGate::Run()
+{
+	// Out-of-context hooks are delivered to this thread while it pumps messages
+	s_instance = this;
+	TRACE_THREAD("gate");
+	HWINEVENTHOOK foregroundHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr, WinEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+	HWINEVENTHOOK cursorHook = SetWinEventHook(EVENT_OBJECT_SHOW, EVENT_OBJECT_HIDE, nullptr, WinEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+
+	// Again, for changes between Start() and the hooks
+	OnForegroundChanged(GetForegroundWindow());
+	PollCursor();
+
+	while (m_running.load(std::memory_order_relaxed))
+	{
+		MsgWaitForMultipleObjects(0, nullptr, FALSE, k_pollMilliseconds, QS_ALLINPUT);
+		MSG msg;
+		while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+		{
+			DispatchMessage(&msg);
+		}
+
+		PollCursor();
+		// Low bit: pressed since the previous call
+		if (m_pauseKey != 0 && (GetAsyncKeyState(m_pauseKey) & 1))
+		{
+			m_paused = !m_paused;
+			SetReason(GatePaused, m_paused);
+		}
+		// High bit: down right now
+		if (m_modifierKey != 0)
+		{
+			SetModifierHeld((GetAsyncKeyState(m_modifierKey) & 0x8000) != 0);
+		}
+	}
+
+	UnhookWinEvent(cursorHook);
+	UnhookWinEvent(foregroundHook);
+	s_instance = nullptr;
+}
+#endif
+
+ScriptedOutputGate::ScriptedOutputGate(const std::vector<GateInterval>& intervals, double repeatSeconds)
+	: m_intervals{ intervals }, m_repeatSeconds{ repeatSeconds }
+{ }
+
+void ScriptedOutputGate::Advance(int64_t timeStampMicroSeconds)
+{
+	if (!m_started)
+	{
+		m_startMicroSeconds = timeStampMicroSeconds;
+		m_started = true;
+	}
+
+	double seconds = (timeStampMicroSeconds - m_startMicroSeconds) * 1e-6;
+	if (m_repeatSeconds > 0.0)
+	{
+		seconds = std::fmod(seconds, m_repeatSeconds);
+	}
+
+	uint32_t reasons = 0;
+	for (const GateInterval& interval : m_intervals)
+	{
+		if (seconds >= interval.StartSeconds && seconds < interval.EndSeconds)
+		{
+			reasons |= interval.Reason;
+		}
+	}
+	SetReasons(reasons);
+}
+
+bool ParseGateScript(const std::string& script, std::vector<GateInterval>& intervals, double& repeatSeconds, std::string& error)
+{
+	intervals.clear();
+	repeatSeconds = 0.0;
+	std::istringstream entries{ script };
+	std::string entry;
+	while (std::getline(entries, entry, ','))
+	{
+		if (entry.empty())
+		{
+			continue;
+		}
+
+		bool ok = false;
+		try
+		{
+			if (entry.compare(0, 7, "repeat=") == 0)
+			{
+				repeatSeconds = std::stod(entry.substr(7));
+				ok = repeatSeconds > 0.0;
+			}
+			else
+			{
+				const size_t at = entry.find('@');
+				const size_t dash = entry.find('-', at);
+				if (at != std::string::npos && dash != std::string::npos)
+				{
+					const std::string reason = entry.substr(0, at);
+					GateInterval interval{ std::stod(entry.substr(at + 1, dash - at - 1)), std::stod(entry.substr(dash + 1)), GateCursorVisible };
+					ok = interval.EndSeconds > interval.StartSeconds;
+					if (reason == "focus")
+					{
+						interval.Reason = GateFocusLost;
+					}
+					else if (reason == "pause")
+					{
+						interval.Reason = GatePaused;
+					}
+					else if (reason != "cursor")
+					{
+						ok = false;
+					}
+					intervals.push_back(interval);
+				}
+			}
+		}
+		catch (const std::exception&)
+		{
+		}
+
+		if (!ok)
+		{
+			error = "bad gate script entry '" + entry + "'";
+			return false;
+		}
+	}
+	return true;
+}
+
+std::unique_ptr<OutputGate> CreateOutputGate(const char* gateSpec, void* ownWindow)
+{
+	const std::string spec{ gateSpec != nullptr ? gateSpec : "" };
+	if (spec.empty())
+	{
+#ifdef _WIN32
+		return std::make_unique<WindowsOutputGate>(static_cast<HWND>(ownWindow), VK_F7, VK_LMENU);
+#else
+		return std::make_unique<OpenOutputGate>();
+#endif
+	}
+	if (spec == "open")
+	{
+		return std::make_unique<OpenOutputGate>();
+	}
+	if (spec.compare(0, 7, "script:") == 0)
+	{
+		std::vector<GateInterval> intervals;
+		double repeatSeconds;
+		std::string error;
+		if (!ParseGateScript(spec.substr(7), intervals, repeatSeconds, error))
+		{
+			std::cerr << error << std::endl;
+			return nullptr;
+		}
+		return std::make_unique<ScriptedOutputGate>(intervals, repeatSeconds);
+	}
+
+	std::cerr << "Unknown output gate " << spec << std::endl;
+	return nullptr;
+}
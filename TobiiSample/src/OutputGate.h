@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include "windows.h"
+#endif
+
+// Reasons mouse output is held back. Output is allowed when none is set.
+enum GateReason : uint32_t
+{
+	GateCursorVisible = 1 << 0,	// the game shows a cursor: menu, map, chat
+	GateFocusLost = 1 << 1,		// our own console window is in the foreground
+	GatePaused = 1 << 2,			// paused with the hotkey
+};
+
+// Decides whether the mapping loop may move the mouse. Implementations keep an atomic flag up to
+// date from their own thread (or from Advance()), so the hot loop only does one relaxed load.
+class OutputGate
+{
+public:
+	virtual ~OutputGate() = default;
+
+	// Sets the initial reasons before returning, so start the gate before the threads that read it
+	virtual void Start() { }
+	virtual void Stop() { }
+	// Called by the mapping loop with the latest sample time. Only time-driven gates use it.
+	virtual void Advance(int64_t timeStampMicroSeconds) { }
+
+	bool IsOutputAllowed() const { return m_blockedReasons.load(std::memory_order_relaxed) == 0; }
+	uint32_t GetBlockedReasons() const { return m_blockedReasons.load(std::memory_order_relaxed); }
+	uint32_t GetTransitionCount() const { return m_transitionCount.load(std::memory_order_relaxed); }
+	// The hold strategy's key, sampled by the same watcher so the hot loop doesn't poll the keyboard.
+	// Never held for gates without a watcher.
+	bool IsModifierHeld() const { return m_isModifierHeld.load(std::memory_order_relaxed); }
+
+protected:
+	// Writer side, from one thread.
+	void SetReasons(uint32_t reasons);
+	void SetReason(GateReason reason, bool isSet);
+	void SetModifierHeld(bool isHeld) { m_isModifierHeld.store(isHeld, std::memory_order_relaxed); }
+
+private:
+	std::atomic<uint32_t> m_blockedReasons{ 0 };
+	std::atomic<uint32_t> m_transitionCount{ 0 };
+	std::atomic<bool> m_isModifierHeld{ false };
+};
+
+// Never blocks output, for platforms without cursor information.
+class OpenOutputGate : public OutputGate
+{
+};
+
+#ifdef _WIN32
+// Cursor show/hide and foreground changes arrive through WinEvent hooks on a watcher thread. Because
+// some games hide the cursor without an event, the cursor, the pause hotkey and the modifier key are
+// also polled every k_pollMilliseconds; the hot loop never calls GetCursorInfo() or GetAsyncKeyState().
+class WindowsOutputGate : public OutputGate
+{
+public:
+	static constexpr int k_pollMilliseconds = 20;
+
+	// ownWindow: output is held while it is in the foreground, nullptr to ignore focus.
+	// pauseKey: virtual key that toggles GatePaused, 0 for none.
+	// modifierKey: virtual key reported by IsModifierHeld(), 0 for none.
+	WindowsOutputGate(HWND ownWindow, int pauseKey, int modifierKey);
+	~WindowsOutputGate() override;
+
+	void Start() override;
+	void Stop() override;
+
+private:
+	void Run();
+	void PollCursor();
+	void OnForegroundChanged(HWND window);
+
+	static void CALLBACK WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND window, LONG objectId, LONG childId,
+		DWORD threadId, DWORD timeMs);
+
+	HWND m_ownWindow;
+	int m_pauseKey;
+	int m_modifierKey;
+	bool m_paused = false;
+	std::thread m_thread;
+	std::atomic<bool> m_running{ false };
+
+	static WindowsOutputGate* s_instance;	// WinEvent callbacks carry no user data
+};
+#endif
+
+// Time-driven stand-in for tests, replays and benchmarks: blocks output during scripted intervals of
+// sample time, measured from the first Advance().
+struct GateInterval
+{
+	double StartSeconds;
+	double EndSeconds;
+	GateReason Reason;
+};
+
+class ScriptedOutputGate : public OutputGate
+{
+public:
+	// repeatSeconds > 0 replays the script with that period.
+	ScriptedOutputGate(const std::vector<GateInterval>& intervals, double repeatSeconds);
+
+	void Advance(int64_t timeStampMicroSeconds) override;
+
+private:
+	std::vector<GateInterval> m_intervals;
+	double m_repeatSeconds;
+	int64_t m_startMicroSeconds = 0;
+	bool m_started = false;
+};
+
+// Script: comma separated "<reason>@<start>-<end>" in seconds plus an optional "repeat=<seconds>",
+// reasons are cursor, focus and pause. E.g. "cursor@2-3,pause@5-5.5,repeat=10"
+bool ParseGateScript(const std::string& script, std::vector<GateInterval>& intervals, double& repeatSeconds, std::string& error);
+
+// Creates the gate named by a spec string:
+//   ""                     the platform's watcher (Windows: cursor, focus of ownWindow, F7 pause, Left Alt
+//                          modifier), otherwise open
+//   "open"                 never blocks
+//   "script:<script>"      ScriptedOutputGate, see ParseGateScript()
+// Returns nullptr (and prints why) when the spec is invalid.
+std::unique_ptr<OutputGate> CreateOutputGate(const char* gateSpec, void* ownWindow);
@@ -0,0 +1,141 @@
+#include "PacedScheduler.h"
+#include "Clock.h"
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#else
+#include <cerrno>
+#include <ctime>
+#endif
+
+static int64_t PeriodMicroSeconds(double rateHz)
+{
+	return (std::max)(static_cast<int64_t>(1e6 / rateHz), int64_t{ 1 });
+}
+
+PacedScheduler::PacedScheduler(double rateHz, int64_t spinMicroSeconds)
+	: m_periodMicroSeconds{ PeriodMicroSeconds(rateHz) },
+	m_spinMicroSeconds{ (std::max)(spinMicroSeconds, int64_t{ 0 }) }
+{
+#ifdef _WIN32
+	// Windows 10 1803 and later; older systems get a normal timer at 1 ms resolution
+	m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (m_timer == nullptr)
+	{
+		m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+		m_raisedTimerResolution = timeBeginPeriod(1) == TIMERR_NOERROR;
+	}
+#endif
+}
+
+PacedScheduler::~PacedScheduler()
+{
+#ifdef _WIN32
+	if (m_timer != nullptr)
+	{
+		CloseHandle(m_timer);
+	}
+	if (m_raisedTimerResolution)
+	{
+		timeEndPeriod(1);
+	}
+#endif
+}
+
+void PacedScheduler::Reset()
+{
+	m_nextDeadline = -1;
+	m_lastWake = -1;
+}
+
+void PacedScheduler::SetRate(double rateHz)
+{
+	m_periodMicroSeconds = PeriodMicroSeconds(rateHz);
+	m_nextDeadline = -1;
+}
+
+void PacedScheduler::WaitUntil(int64_t deadlineMicroSeconds)
+{
+	const int64_t sleepUntil = deadlineMicroSeconds - m_spinMicroSeconds;
+	int64_t now = NowMicroSeconds();
+	if (now < sleepUntil)
+	{
+#ifdef _WIN32
+		// Negative due times are relative, in 100 ns units
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -(sleepUntil - now) * 10;
+		if (m_timer != nullptr && SetWaitableTimer(m_timer, &dueTime, 0, nullptr, nullptr, FALSE))
+		{
+			WaitForSingleObject(m_timer, INFINITE);
+		}
+		else
+		{
+			Sleep(static_cast<DWORD>((sleepUntil - now) / 1000));
+		}
+#else
+		// steady_clock, and so NowMicroSeconds(), is CLOCK_MONOTONIC
+		timespec deadline;
+		deadline.tv_sec = static_cast<time_t>(sleepUntil / 1'000'000);
+		deadline.tv_nsec = static_cast<long>(sleepUntil % 1'000'000) * 1000;
+		// Only a signal is worth retrying; any other error (it is returned, not set in errno) ends the sleep
+		// and the yield loop below covers the rest of the wait
+		int result;
+		do
+		{
+			result = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr);
+		} while (result == EINTR);
+#endif
+		now = NowMicroSeconds();
+	}
+	while (now < deadlineMicroSeconds)
+	{
+		std::this_thread::yield();
+		now = NowMicroSeconds();
+	}
+}
+
+void PacedScheduler::WaitForNextTick()
+{
+	if (m_nextDeadline < 0)
+	{
+		m_nextDeadline = NowMicroSeconds() + m_periodMicroSeconds;
+	}
+
+	const int64_t before = NowMicroSeconds();
+	if (before > m_nextDeadline)
+	{
+		m_missedCount++;
+		// Overran by a whole tick or more: drop the lost ticks rather than running them back to back
+		if (before >= m_nextDeadline + m_periodMicroSeconds)
+		{
+			m_nextDeadline = before;
+		}
+	}
+	else
+	{
+		WaitUntil(m_nextDeadline);
+	}
+
+	const int64_t wake = NowMicroSeconds();
+	m_lateness.Record(wake - m_nextDeadline);
+	if (m_lastWake >= 0)
+	{
+		m_period.Record(wake - m_lastWake);
+	}
+	m_lastWake = wake;
+	m_tickCount++;
+	m_nextDeadline += m_periodMicroSeconds;
+}
+
+void PacedScheduler::PrintStats(std::ostream& out, const char* title) const
+{
+	out << title << ": " << m_tickCount << " ticks of " << m_periodMicroSeconds << " us, " << m_missedCount << " missed deadlines" << std::endl;
+	m_period.Print(out, "  Tick period");
+	m_lateness.Print(out, "  Wake-up after deadline");
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+#include <cstdint>
+#include <ostream>
+
+#ifdef _WIN32
+#include "windows.h"
+#endif
+
+// Paces a loop at a fixed tick rate with absolute deadlines on the NowMicroSeconds() clock, replacing
+// Sleep(1) / Sleep(1000 / 60) whose real granularity is the OS timer resolution (up to 15.6 ms on
+// Windows). Sleeps on the best timer available, clock_nanosleep(TIMER_ABSTIME) on Linux and a
+// high-resolution waitable timer on Windows, then optionally spins for the last spinMicroSeconds
+// to absorb the wake-up jitter. Used from one thread.
+class PacedScheduler
+{
+public:
+	explicit PacedScheduler(double rateHz, int64_t spinMicroSeconds = 0);
+	~PacedScheduler();
+
+	PacedScheduler(const PacedScheduler&) = delete;
+	PacedScheduler& operator=(const PacedScheduler&) = delete;
+
+	// Waits for the next deadline. When the loop body overran the deadline it returns at once and counts
+	// a miss; after an overrun of a whole tick or more the grid restarts from now instead of catching
+	// up with a burst of ticks.
+	void WaitForNextTick();
+
+	// Waits until an absolute NowMicroSeconds() time without touching the tick statistics, for idle
+	// polling that isn't on the tick grid.
+	void WaitUntil(int64_t deadlineMicroSeconds);
+
+	// Starts the grid again from now, e.g. after a pause.
+	void Reset();
+	// Changes the tick rate; the next tick is one new period from now.
+	void SetRate(double rateHz);
+
+	int64_t GetPeriodMicroSeconds() const { return m_periodMicroSeconds; }
+	uint64_t GetTickCount() const { return m_tickCount; }
+	uint64_t GetMissedCount() const { return m_missedCount; }
+	const LatencyHistogram& GetPeriodHistogram() const { return m_period; }		// wake-up to wake-up
+	const LatencyHistogram& GetLatenessHistogram() const { return m_lateness; }	// wake-up after the deadline
+
+	void PrintStats(std::ostream& out, const char* title) const;
+
+private:
+	int64_t m_periodMicroSeconds;
+	int64_t m_spinMicroSeconds;
+	int64_t m_nextDeadline = -1;
+	int64_t m_lastWake = -1;
+	uint64_t m_tickCount = 0;
+	uint64_t m_missedCount = 0;
+	LatencyHistogram m_period;
+	LatencyHistogram m_lateness;
+#ifdef _WIN32
+	HANDLE m_timer = nullptr;
+	bool m_raisedTimerResolution = false;	// timeBeginPeriod(1) fallback when there is no high-resolution timer
+#endif
+};
@@ -0,0 +1,362 @@
+#include "ParameterSweep.h"
+#include "SquadTuning.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+using namespace TobiiGameIntegration;
+
+static constexpr int k_filterBatchSize = 64;	// as MyNewMain's mapping thread
+static constexpr int k_evaluateChunk = 256;
+
+void PrepareSweepSession(const std::vector<HeadPose>& headPoses, const AnalyticsSettings& restSettings, const TurnSettings& turnSettings,
+	const HeadPoseFilter& filter, SweepSession& session)
+{
+	session = SweepSession{};
+	if (headPoses.empty())
+	{
+		return;
+	}
+
+	std::vector<HeadPose> mappedPoses = headPoses;
+	HeadPoseFilter mappingFilter = filter;
+	mappingFilter.Reset();
+	for (size_t first = 0; mappingFilter.IsEnabled() && first < mappedPoses.size(); first += k_filterBatchSize)
+	{
+		mappingFilter.FilterHeadPoses(&mappedPoses[first], static_cast<int>((std::min)(mappedPoses.size() - first, static_cast<size_t>(k_filterBatchSize))));
+	}
+	session.Poses.Append(mappedPoses.data(), mappedPoses.size());
+
+	// Rest and turns on the raw poses, so every filter is scored on the same stretches
+	SessionAnalysis restNoise;
+	FindRestHeadPoses(headPoses, restSettings, session.IsAtRest, restNoise);
+	for (size_t i = 0; i + 1 < headPoses.size(); i++)
+	{
+		const int64_t interval = headPoses[i + 1].TimeStampMicroSeconds - headPoses[i].TimeStampMicroSeconds;
+		const double seconds = interval > 0 && interval <= HeadPoseFilter::k_maxGapMicroSeconds ? interval / 1e6 : 0.0;
+		session.Seconds += seconds;
+		session.RestSeconds += session.IsAtRest[i] ? seconds : 0.0;
+	}
+
+	// Fast poses: the head moved quickly over the last SpeedWindowSeconds
+	const int64_t windowMicroSeconds = static_cast<int64_t>(turnSettings.SpeedWindowSeconds * 1e6);
+	std::vector<size_t> windowStart(headPoses.size());
+	std::vector<uint8_t> isFast(headPoses.size(), 0);
+	for (size_t i = 0, back = 0; i < headPoses.size(); i++)
+	{
+		if (i > 0 && headPoses[i].TimeStampMicroSeconds - headPoses[i - 1].TimeStampMicroSeconds > HeadPoseFilter::k_maxGapMicroSeconds)
+		{
+			back = i;
+		}
+		while (headPoses[i].TimeStampMicroSeconds - headPoses[back].TimeStampMicroSeconds > windowMicroSeconds)
+		{
+			back++;
+		}
+		windowStart[i] = back;
+		const int64_t interval = headPoses[i].TimeStampMicroSeconds - headPoses[back].TimeStampMicroSeconds;
+		if (interval > 0)
+		{
+			const double yaw = headPoses[i].Rotation.YawDegrees - headPoses[back].Rotation.YawDegrees;
+			const double pitch = headPoses[i].Rotation.PitchDegrees - headPoses[back].Rotation.PitchDegrees;
+			isFast[i] = std::sqrt(yaw * yaw + pitch * pitch) * 1e6 / interval >= turnSettings.MinSpeedDegreesPerSecond;
+		}
+	}
+
+	// A turn starts where the speed window of its first fast pose starts and lasts until SettleSeconds
+	// after its last one
+	const int64_t settleMicroSeconds = static_cast<int64_t>(turnSettings.SettleSeconds * 1e6);
+	session.TurnStart.assign(headPoses.size(), -1);
+	size_t previousEnd = 0;
+	for (size_t i = 0; i < headPoses.size();)
+	{
+		if (!isFast[i])
+		{
+			i++;
+			continue;
+		}
+		const size_t start = (std::max)(windowStart[i], previousEnd);
+		size_t lastFast = i, end = i + 1;
+		while (end < headPoses.size() && headPoses[end].TimeStampMicroSeconds - headPoses[end - 1].TimeStampMicroSeconds <= HeadPoseFilter::k_maxGapMicroSeconds &&
+			(isFast[end] || headPoses[end].TimeStampMicroSeconds - headPoses[lastFast].TimeStampMicroSeconds <= settleMicroSeconds))
+		{
+			lastFast = isFast[end] ? end : lastFast;
+			end++;
+		}
+		float minYaw = headPoses[start].Rotation.YawDegrees, maxYaw = minYaw;
+		float minPitch = headPoses[start].Rotation.PitchDegrees, maxPitch = minPitch;
+		for (size_t p = start; p <= lastFast; p++)
+		{
+			minYaw = (std::min)(minYaw, headPoses[p].Rotation.YawDegrees);
+			maxYaw = (std::max)(maxYaw, headPoses[p].Rotation.YawDegrees);
+			minPitch = (std::min)(minPitch, headPoses[p].Rotation.PitchDegrees);
+			maxPitch = (std::max)(maxPitch, headPoses[p].Rotation.PitchDegrees);
+		}
+		if (maxYaw - minYaw >= turnSettings.MinDegrees || maxPitch - minPitch >= turnSettings.MinDegrees)
+		{
+			std::fill(session.TurnStart.begin() + start, session.TurnStart.begin() + end, static_cast<int32_t>(start));
+			session.TurnSeconds += (headPoses[end - 1].TimeStampMicroSeconds - headPoses[start].TimeStampMicroSeconds) / 1e6;
+			session.TurnCount++;
+		}
+		previousEnd = end;
+		i = end;
+	}
+}
+
+double SweepScore::GetEventsPerMinute(const SweepSession& session) const
+{
+	return session.Seconds > 0.0 ? MouseEvents * 60.0 / session.Seconds : 0.0;
+}
+
+double SweepScore::GetRestCountsPerMinute(const SweepSession& session) const
+{
+	return session.RestSeconds > 0.0 ? RestCounts * 60.0 / session.RestSeconds : 0.0;
+}
+
+double SweepScore::GetTurnErrorDegrees() const
+{
+	return TurnPoses > 0 ? std::sqrt(TurnErrorSquares / TurnPoses) : 0.0;
+}
+
+// static_cast<long>(std::round(value)) without the library call: halves away from zero. The fraction is
+// exact in float, and values too big for it to exist are integers already.
+static inline long RoundToCounts(float value)
+{
+	const long truncated = static_cast<long>(value);
+	const float fraction = value - static_cast<float>(truncated);
+	return truncated + (fraction >= 0.5f) - (fraction <= -0.5f);
+}
+
+// One pass over the session for Lanes candidates at once. Each candidate's position depends on its previous
+// delta, a chain of float/integer conversions that leaves the core mostly idle; interleaving independent
+// candidates fills it, and the pose columns are read once for all of them.
+template <int Lanes>
+static void EvaluatePass(const SweepSession& session, const MappingSettings* settings, SweepScore* scores, SimdLevel level)
+{
+	const size_t count = session.Poses.Size();
+	const float* yaw = session.Poses.Yaw.data();
+	const float* pitch = session.Poses.Pitch.data();
+	const uint8_t* isAtRest = session.IsAtRest.data();
+	const int32_t* turnStart = session.TurnStart.data();
+
+	float desiredYaw[Lanes][k_evaluateChunk], desiredPitch[Lanes][k_evaluateChunk];
+	float actualYaw[Lanes] = {}, actualPitch[Lanes] = {};
+	float turnActualYaw[Lanes] = {}, turnActualPitch[Lanes] = {};
+	double yawGain[Lanes], pitchGain[Lanes];
+	uint64_t mouseEvents[Lanes] = {}, restCounts[Lanes] = {}, turnPoses = 0;
+	double turnErrorSquares[Lanes] = {};
+	for (int lane = 0; lane < Lanes; lane++)
+	{
+		yawGain[lane] = settings[lane].Sens;
+		pitchGain[lane] = static_cast<double>(settings[lane].Sens) * settings[lane].YSensMult;
+	}
+
+	for (size_t first = 0; first < count; first += k_evaluateChunk)
+	{
+		const size_t chunk = (std::min)(count - first, static_cast<size_t>(k_evaluateChunk));
+		for (int lane = 0; lane < Lanes; lane++)
+		{
+			ComputeDesiredCounts(settings[lane], yaw + first, pitch + first, desiredYaw[lane], desiredPitch[lane], chunk, level);
+			if (first == 0)
+			{
+				// HeadMouseMapper::Resync(), as MyNewMain does before its first batch
+				actualYaw[lane] = std::round(desiredYaw[lane][0]);
+				actualPitch[lane] = std::round(desiredPitch[lane][0]);
+			}
+		}
+		for (size_t i = 0; i < chunk; i++)
+		{
+			const size_t pose = first + i;
+			const bool isPoseAtRest = isAtRest[pose] != 0;
+			for (int lane = 0; lane < Lanes; lane++)
+			{
+				// HeadMouseMapper::Advance()
+				const long dx = RoundToCounts(desiredYaw[lane][i] - actualYaw[lane]);
+				const long minusDy = RoundToCounts(desiredPitch[lane][i] - actualPitch[lane]);
+				actualYaw[lane] += static_cast<float>(dx);
+				actualPitch[lane] += static_cast<float>(minusDy);
+				mouseEvents[lane] += dx != 0 || minusDy != 0;
+				restCounts[lane] += isPoseAtRest ? std::abs(dx) + std::abs(minusDy) : 0;
+			}
+
+			const int32_t start = turnStart[pose];
+			if (start < 0)
+			{
+				continue;
+			}
+			turnPoses++;
+			const double headYaw = static_cast<double>(yaw[pose]) - yaw[start];
+			const double headPitch = static_cast<double>(pitch[pose]) - pitch[start];
+			for (int lane = 0; lane < Lanes; lane++)
+			{
+				if (static_cast<size_t>(start) == pose)
+				{
+					turnActualYaw[lane] = actualYaw[lane];
+					turnActualPitch[lane] = actualPitch[lane];
+				}
+				const double yawError = yawGain[lane] != 0.0 ?
+					(actualYaw[lane] - turnActualYaw[lane]) / yawGain[lane] - headYaw * settings[lane].HeadPoseYawScale : 0.0;
+				const double pitchError = pitchGain[lane] != 0.0 ?
+					(actualPitch[lane] - turnActualPitch[lane]) / pitchGain[lane] - headPitch * settings[lane].HeadPosePitchScale : 0.0;
+				turnErrorSquares[lane] += yawError * yawError + pitchError * pitchError;
+			}
+		}
+	}
+
+	for (int lane = 0; lane < Lanes; lane++)
+	{
+		scores[lane] = { mouseEvents[lane], restCounts[lane], turnErrorSquares[lane], turnPoses };
+	}
+}
+
+void EvaluateCandidates(const SweepSession& session, const MappingSettings* settings, int count, SweepScore* scores, SimdLevel level)
+{
+	int first = 0;
+	for (; first + k_candidatesPerPass <= count; first += k_candidatesPerPass)
+	{
+		EvaluatePass<k_candidatesPerPass>(session, settings + first, scores + first, level);
+	}
+	for (; first < count; first++)
+	{
+		EvaluatePass<1>(session, settings + first, scores + first, level);
+	}
+}
+
+SweepSpace::SweepSpace()
+{
+	const float values[] = { k_sens, k_ySensMult, k_deadYawIRL, k_deadPitchIRL, k_maxYawIRL, k_maxPitchIRL };
+	for (int parameter = 0; parameter < static_cast<int>(SweepParameter::Count); parameter++)
+	{
+		Ranges[parameter] = { values[parameter], values[parameter], 1 };
+	}
+}
+
+const char* GetSweepParameterName(SweepParameter parameter)
+{
+	switch (parameter)
+	{
+	case SweepParameter::Sens: return "sens";
+	case SweepParameter::YSensMult: return "ysensmult";
+	case SweepParameter::DeadYaw: return "deadyaw";
+	case SweepParameter::DeadPitch: return "deadpitch";
+	case SweepParameter::MaxYaw: return "maxyaw";
+	case SweepParameter::MaxPitch: return "maxpitch";
+	default: return "?";
+	}
+}
+
+bool ParseSweepSpace(const std::string& spec, SweepSpace& space, std::string& error)
+{
+	std::istringstream entries{ spec };
+	std::string entry;
+	while (std::getline(entries, entry, ','))
+	{
+		if (entry.empty())
+		{
+			continue;
+		}
+		const size_t equals = entry.find('=');
+		const std::string key = entry.substr(0, equals);
+		const std::string value = equals == std::string::npos ? "" : entry.substr(equals + 1);
+
+		int parameter = 0;
+		while (parameter < static_cast<int>(SweepParameter::Count) && key != GetSweepParameterName(static_cast<SweepParameter>(parameter)))
+		{
+			parameter++;
+		}
+		SweepRange range;
+		char colon1 = 0, colon2 = 0;
+		std::istringstream values{ value };
+		bool ok = parameter < static_cast<int>(SweepParameter::Count) && static_cast<bool>(values >> range.Min);
+		range.Max = range.Min;
+		if (ok && values >> colon1)
+		{
+			ok = colon1 == ':' && values >> range.Max >> colon2 >> range.Steps && colon2 == ':' && range.Steps >= 1 && range.Min <= range.Max &&
+				(values >> std::ws).eof();
+		}
+		// Sens divides the turn error and the derived clamps
+		ok = ok && range.Min >= 0.0f && (static_cast<SweepParameter>(parameter) != SweepParameter::Sens || range.Min > 0.0f);
+		if (!ok)
+		{
+			error = "bad sweep range '" + entry + "', expected <key>=<value> or <key>=<min>:<max>:<steps>";
+			return false;
+		}
+		space.Ranges[parameter] = range;
+		space.IsSet[parameter] = true;
+	}
+	return true;
+}
+
+uint64_t GetGridSize(const SweepSpace& space)
+{
+	uint64_t size = 1;
+	for (const SweepRange& range : space.Ranges)
+	{
+		size *= static_cast<uint64_t>(range.Steps);
+	}
+	return size;
+}
+
+static float GetGridValue(const SweepRange& range, int step)
+{
+	return range.Steps > 1 ? range.Min + (range.Max - range.Min) * step / (range.Steps - 1) : range.Min;
+}
+
+static MappingSettings MakeCandidate(const SweepSpace& space, const MappingSettings& baseSettings, const float (&values)[static_cast<int>(SweepParameter::Count)])
+{
+	MappingSettings settings = baseSettings;
+	settings.Sens = values[static_cast<int>(SweepParameter::Sens)];
+	settings.YSensMult = values[static_cast<int>(SweepParameter::YSensMult)];
+	settings.DeadYawIRL = values[static_cast<int>(SweepParameter::DeadYaw)];
+	settings.DeadPitchIRL = values[static_cast<int>(SweepParameter::DeadPitch)];
+	settings.MaxYawIRL = space.IsSet[static_cast<int>(SweepParameter::MaxYaw)] ? values[static_cast<int>(SweepParameter::MaxYaw)] :
+		k_maxYawCounts / settings.Sens + settings.DeadYawIRL;
+	const float pitchGain = settings.Sens * settings.YSensMult;
+	settings.MaxPitchIRL = space.IsSet[static_cast<int>(SweepParameter::MaxPitch)] ? values[static_cast<int>(SweepParameter::MaxPitch)] :
+		pitchGain > 0.0f ? k_maxPitchCounts / pitchGain + settings.DeadPitchIRL : 0.0f;
+	return settings;
+}
+
+void GetGridCandidates(const SweepSpace& space, const MappingSettings& baseSettings, std::vector<MappingSettings>& candidates)
+{
+	constexpr int k_parameterCount = static_cast<int>(SweepParameter::Count);
+	int steps[k_parameterCount] = {};
+	float values[k_parameterCount];
+	candidates.reserve(candidates.size() + GetGridSize(space));
+	while (true)
+	{
+		for (int parameter = 0; parameter < k_parameterCount; parameter++)
+		{
+			values[parameter] = GetGridValue(space.Ranges[parameter], steps[parameter]);
+		}
+		candidates.push_back(MakeCandidate(space, baseSettings, values));
+
+		// Odometer over the axes, the last one fastest
+		int parameter = k_parameterCount - 1;
+		while (parameter >= 0 && ++steps[parameter] == space.Ranges[parameter].Steps)
+		{
+			steps[parameter--] = 0;
+		}
+		if (parameter < 0)
+		{
+			return;
+		}
+	}
+}
+
+void GetRandomCandidates(const SweepSpace& space, const MappingSettings& baseSettings, int count, std::mt19937& random,
+	std::vector<MappingSettings>& candidates)
+{
+	constexpr int k_parameterCount = static_cast<int>(SweepParameter::Count);
+	float values[k_parameterCount];
+	std::uniform_real_distribution<float> unit{ 0.0f, 1.0f };
+	for (int candidate = 0; candidate < count; candidate++)
+	{
+		for (int parameter = 0; parameter < k_parameterCount; parameter++)
+		{
+			const SweepRange& range = space.Ranges[parameter];
+			values[parameter] = range.Min + (range.Max - range.Min) * unit(random);
+		}
+		candidates.push_back(MakeCandidate(space, baseSettings, values));
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "HeadMouseMapping.h"
+#include "HeadPoseFilter.h"
+#include "MappingKernel.h"
+#include "SessionAnalytics.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Scores candidate MappingSettings (the SquadTuning.h constants) against one recorded session, for
+// SweepMain.cpp. The session is prepared once: poses filtered like MyNewMain would, laid out as columns,
+// rest and deliberate turns marked. Evaluating a candidate then only streams over those columns with
+// fixed-size scratch on the stack, so thousands of candidates can run on a thread pool without
+// touching the allocator.
+
+struct TurnSettings
+{
+	float MinSpeedDegreesPerSecond = 30.0f;	// raw head speed, yaw and pitch combined
+	float SpeedWindowSeconds = 0.05f;		// measured over this much time back
+	float MinDegrees = 5.0f;				// raw yaw or pitch range, smaller fast motion is not a deliberate turn
+	float SettleSeconds = 0.25f;			// kept after the head slows down, so a mapping that lags is scored
+};
+
+struct SweepSession
+{
+	HeadPoseColumns Poses;				// after the filter
+	std::vector<uint8_t> IsAtRest;		// per pose, see FindRestHeadPoses()
+	std::vector<int32_t> TurnStart;		// per pose, the first pose of its turn or -1
+	double Seconds = 0.0;
+	double RestSeconds = 0.0;
+	double TurnSeconds = 0.0;
+	uint64_t TurnCount = 0;
+};
+
+void PrepareSweepSession(const std::vector<TobiiGameIntegration::HeadPose>& headPoses, const AnalyticsSettings& restSettings,
+	const TurnSettings& turnSettings, const HeadPoseFilter& filter, SweepSession& session);
+
+// Objectives, lower is better
+struct SweepScore
+{
+	uint64_t MouseEvents = 0;
+	uint64_t RestCounts = 0;			// |dx| + |dy| emitted while the head is at rest
+	double TurnErrorSquares = 0.0;		// over the turn poses, see EvaluateCandidates()
+	uint64_t TurnPoses = 0;
+
+	double GetEventsPerMinute(const SweepSession& session) const;
+	double GetRestCountsPerMinute(const SweepSession& session) const;
+	double GetTurnErrorDegrees() const;	// RMS
+};
+
+// Maps the whole session as HeadMouseMapper would (same SIMD kernel, same rounding, resynced on the
+// first pose) with each candidate, without response curves. Tracking error on turns: how far the cursor's
+// motion since the turn started, converted back to degrees through the candidate's own gain, is from the
+// head's motion on the Extended View scale. Deadzone entry, clamping and rounding show up there; the
+// sensitivity itself doesn't, it is a matter of taste.
+// Candidates are mapped k_candidatesPerPass at a time, so hand over groups of that size where possible.
+// Allocation-free, safe to call from any number of threads.
+static constexpr int k_candidatesPerPass = 8;
+void EvaluateCandidates(const SweepSession& session, const MappingSettings* settings, int count, SweepScore* scores,
+	SimdLevel level = GetSupportedSimdLevel());
+
+enum class SweepParameter
+{
+	Sens,
+	YSensMult,
+	DeadYaw,
+	DeadPitch,
+	MaxYaw,
+	MaxPitch,
+	Count
+};
+
+struct SweepRange
+{
+	float Min = 0.0f;
+	float Max = 0.0f;
+	int Steps = 1;				// grid points from Min to Max, 1 for a fixed value
+};
+
+// MaxYaw/MaxPitch left unset follow the other values the way SquadTuning.h derives them,
+// k_maxYawCounts / k_maxPitchCounts past the deadzone.
+struct SweepSpace
+{
+	SweepSpace();	// every range fixed at the SquadTuning.h value, MaxYaw/MaxPitch derived
+
+	SweepRange Ranges[static_cast<int>(SweepParameter::Count)];
+	bool IsSet[static_cast<int>(SweepParameter::Count)] = {};
+};
+
+// "sens=20:40:5,deadyaw=2:10:9,ysensmult=0.25", applied over the space as it is: min:max:steps for a
+// grid axis, a single number for a fixed value. Keys: sens, ysensmult, deadyaw, deadpitch, maxyaw,
+// maxpitch. Returns false and names the offending entry in error.
+bool ParseSweepSpace(const std::string& spec, SweepSpace& space, std::string& error);
+
+const char* GetSweepParameterName(SweepParameter parameter);
+uint64_t GetGridSize(const SweepSpace& space);
+// baseSettings supplies the HeadPose scales
+void GetGridCandidates(const SweepSpace& space, const MappingSettings& baseSettings, std::vector<MappingSettings>& candidates);
+void GetRandomCandidates(const SweepSpace& space, const MappingSettings& baseSettings, int count, std::mt19937& random,
+	std::vector<MappingSettings>& candidates);
@@ -0,0 +1,96 @@
+#include "PosePredictor.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace TobiiGameIntegration;
+
+PosePredictor::PosePredictor(const PredictionSettings& settings)
+	: m_settings{ settings }
+{ }
+
+void PosePredictor::Reset()
+{
+	m_hasState = false;
+}
+
+void PosePredictor::Update(const HeadPose& headPose)
+{
+	const Rotation& rotation = headPose.Rotation;
+	const int64_t elapsed = headPose.TimeStampMicroSeconds - m_lastTimeStamp;
+	if (m_hasState && elapsed <= 0)
+	{
+		return;
+	}
+
+	if (!m_hasState || elapsed > m_settings.MaxGapMicroSeconds)
+	{
+		m_yaw = { rotation.YawDegrees };
+		m_pitch = { rotation.PitchDegrees };
+		m_roll = { rotation.RollDegrees };
+	}
+	else
+	{
+		const float dt = elapsed * 1e-6f;
+		UpdateAxis(m_yaw, rotation.YawDegrees, dt);
+		UpdateAxis(m_pitch, rotation.PitchDegrees, dt);
+		UpdateAxis(m_roll, rotation.RollDegrees, dt);
+	}
+	m_lastTimeStamp = headPose.TimeStampMicroSeconds;
+	m_hasState = true;
+}
+
+void PosePredictor::UpdateAxis(AxisState& axis, float measured, float dt) const
+{
+	const float predictedAngle = axis.Angle + axis.Velocity * dt + 0.5f * axis.Acceleration * dt * dt;
+	const float predictedVelocity = axis.Velocity + axis.Acceleration * dt;
+	const float residual = measured - predictedAngle;
+
+	axis.Angle = predictedAngle + m_settings.Alpha * residual;
+	axis.Velocity = predictedVelocity + m_settings.Beta * residual / dt;
+	axis.Acceleration += 2.0f * m_settings.Gamma * residual / (dt * dt);
+}
+
+float PosePredictor::ExtrapolateAxis(const AxisState& axis, float horizon) const
+{
+	if (std::abs(axis.Velocity) < m_settings.MinSpeedDegreesPerSecond)
+	{
+		return axis.Angle;
+	}
+
+	const float velocityLead = axis.Velocity * horizon;
+	float lead = velocityLead + 0.5f * axis.Acceleration * horizon * horizon;
+	// A decelerating head stops, it doesn't turn around within the horizon
+	if (lead * velocityLead < 0.0f)
+	{
+		lead = 0.0f;
+	}
+	return axis.Angle + std::clamp(lead, -m_settings.MaxLeadDegrees, m_settings.MaxLeadDegrees);
+}
+
+Rotation PosePredictor::Extrapolate(int64_t targetMicroSeconds) const
+{
+	Rotation rotation;
+	if (!m_hasState)
+	{
+		return rotation;
+	}
+
+	const float horizon = (std::max)(targetMicroSeconds - m_lastTimeStamp, int64_t{ 0 }) * 1e-6f;
+	rotation.YawDegrees = ExtrapolateAxis(m_yaw, horizon);
+	rotation.PitchDegrees = ExtrapolateAxis(m_pitch, horizon);
+	rotation.RollDegrees = ExtrapolateAxis(m_roll, horizon);
+	return rotation;
+}
+
+void PosePredictor::PredictHeadPoses(HeadPose* headPoses, int count)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+	for (int i = 0; i < count; i++)
+	{
+		Update(headPoses[i]);
+		headPoses[i].Rotation = Extrapolate(headPoses[i].TimeStampMicroSeconds + m_settings.HorizonMicroSeconds);
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "TobiiPlatform.h"
+#include <cstdint>
+
+// Optional stage between GetHeadPoses() and HeadMouseMapper: per-axis alpha-beta-gamma filter on
+// the sample timestamps, extrapolated HorizonMicroSeconds ahead to cancel tracker and pipeline latency.
+struct PredictionSettings
+{
+	int64_t HorizonMicroSeconds = 0;	// 0 passes poses through untouched
+
+	// Critically damped gains for a discount factor of 0.7: 1-t^3, 1.5(1-t)^2(1+t), (1-t)^3
+	float Alpha = 0.657f;
+	float Beta = 0.2295f;
+	float Gamma = 0.027f;
+
+	// Overshoot guards
+	float MaxLeadDegrees = 3.0f;					// prediction never moves more than this from the filtered angle
+	float MinSpeedDegreesPerSecond = 5.0f;			// below this the head is treated as still, no lead at all
+	int64_t MaxGapMicroSeconds = 100'000;			// longer gaps (dropouts, presence loss) restart the filter
+};
+
+class PosePredictor
+{
+public:
+	explicit PosePredictor(const PredictionSettings& settings);
+
+	bool IsEnabled() const { return m_settings.HorizonMicroSeconds > 0; }
+
+	// Forgets the motion history, the next pose is passed through.
+	void Reset();
+
+	// Feeds one pose. Poses with a timestamp at or before the previous one are ignored.
+	void Update(const TobiiGameIntegration::HeadPose& headPose);
+
+	// Rotation expected at targetMicroSeconds, on the pose timestamp clock. Position is not predicted.
+	TobiiGameIntegration::Rotation Extrapolate(int64_t targetMicroSeconds) const;
+
+	// Feeds the poses in order and replaces each rotation by its prediction HorizonMicroSeconds ahead.
+	// Timestamps are left alone, so latency is still measured from the original sample.
+	void PredictHeadPoses(TobiiGameIntegration::HeadPose* headPoses, int count);
+
+	const PredictionSettings& GetSettings() const { return m_settings; }
+
+private:
+	struct AxisState
+	{
+		float Angle = 0.0f;
+		float Velocity = 0.0f;			// degrees per second
+		float Acceleration = 0.0f;		// degrees per second^2
+	};
+
+	void UpdateAxis(AxisState& axis, float measured, float dt) const;
+	float ExtrapolateAxis(const AxisState& axis, float horizon) const;
+
+	PredictionSettings m_settings;
+	AxisState m_yaw;
+	AxisState m_pitch;
+	AxisState m_roll;
+	int64_t m_lastTimeStamp = 0;
+	bool m_hasState = false;
+};
@@ -0,0 +1,97 @@
+// Example reader of the poses MyNewMain (or ReplayMain) publishes with --publish, and a benchmark of the read
+// side: what ReadLatest() costs, how old the latest frame is when a poller sees it, and whether a reader
+// polling at the given rate keeps up with the pose history.
+// Build it instead of MyNewMain.cpp, e.g. on Linux:
+//   g++ -std=c++20 -O2 -fpermissive -Ivendor/tobii/include src/PoseReaderMain.cpp src/PoseSharedMemory.cpp
+//       src/PacedScheduler.cpp src/LatencyHistogram.cpp -o pose-reader -lrt
+// Usage: pose-reader [name] [seconds] [poll rate Hz]
+#include "Clock.h"
+#include "LatencyHistogram.h"
+#include "PacedScheduler.h"
+#include "PoseSharedMemory.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace TobiiGameIntegration;
+
+static constexpr int k_readCostRepeats = 1'000'000;
+
+int main(int argc, char** argv)
+{
+	const std::string name = argc > 1 ? argv[1] : k_defaultSharedPoseName;
+	const int seconds = argc > 2 ? std::atoi(argv[2]) : 10;
+	const double pollRateHz = argc > 3 ? std::atof(argv[3]) : 100.0;
+
+	SharedPoseReader reader;
+	std::string error;
+	if (!reader.Open(name, error))
+	{
+		std::cout << "Can't read poses from " << name << ": " << error << std::endl;
+		return 1;
+	}
+
+	// Cost of one read while the publisher keeps writing, so it includes the retries
+	SharedPoseFrame frame{};
+	uint64_t checksum = 0, emptyReads = 0;
+	const int64_t costStart = NowNanoSeconds();
+	for (int i = 0; i < k_readCostRepeats; i++)
+	{
+		if (reader.ReadLatest(frame))
+		{
+			checksum += frame.FrameIndex;
+		}
+		else
+		{
+			emptyReads++;
+		}
+	}
+	const double readNanoSeconds = static_cast<double>(NowNanoSeconds() - costStart) / k_readCostRepeats;
+	std::cout << "ReadLatest(): " << readNanoSeconds << " ns/call (" << emptyReads << " empty, checksum " << checksum << ")" << std::endl;
+
+	LatencyHistogram frameAge;
+	HeadPose poses[k_sharedPoseHistoryCapacity];
+	uint64_t poseCount = 0, outOfOrder = 0, framesSeen = 0, lastFrameIndex = 0;
+	int64_t lastPoseTime = INT64_MIN;
+	reader.ReadHeadPoses(poses, 0);	// starts following the history here
+
+	PacedScheduler pacing{ pollRateHz };
+	const int64_t end = NowMicroSeconds() + seconds * int64_t{ 1'000'000 };
+	int64_t nextStatus = 0;
+	while (NowMicroSeconds() < end)
+	{
+		pacing.WaitForNextTick();
+		const int count = reader.ReadHeadPoses(poses, k_sharedPoseHistoryCapacity);
+		for (int i = 0; i < count; i++)
+		{
+			outOfOrder += poses[i].TimeStampMicroSeconds < lastPoseTime;
+			lastPoseTime = poses[i].TimeStampMicroSeconds;
+		}
+		poseCount += count;
+
+		if (reader.ReadLatest(frame) && frame.FrameIndex != lastFrameIndex)
+		{
+			frameAge.Record(NowMicroSeconds() - frame.PublishMicroSeconds);
+			framesSeen++;
+			lastFrameIndex = frame.FrameIndex;
+		}
+
+		const int64_t now = NowMicroSeconds();
+		if (now >= nextStatus && lastFrameIndex != 0)
+		{
+			std::cout << "frame " << frame.FrameIndex << (frame.Flags & SharedPosePresent ? " present" : " absent") <<
+				"  yaw " << frame.Transformation.Rotation.YawDegrees << "  pitch " << frame.Transformation.Rotation.PitchDegrees;
+			if (frame.Flags & SharedPoseHasGazePoint)
+			{
+				std::cout << "  gaze " << frame.GazePoint.X << ", " << frame.GazePoint.Y;
+			}
+			std::cout << "          \r" << std::flush;
+			nextStatus = now + 100'000;
+		}
+	}
+
+	std::cout << std::endl << "Head poses read: " << poseCount << ", lost: " << reader.GetLostCount() << ", out of order: " << outOfOrder <<
+		", frames seen: " << framesSeen << std::endl;
+	frameAge.Print(std::cout, "Latest frame age when polled");
+	pacing.PrintStats(std::cout, "Reader polling");
+}
@@ -0,0 +1,330 @@
+#include "PoseSharedMemory.h"
+#include "Clock.h"
+#include <new>
+
+#ifdef _WIN32
+#include "windows.h"
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace TobiiGameIntegration;
+
+// A reader retries this often while the writer is halfway through a store, then treats the data as
+// unavailable. Thousands of times longer than a store takes.
+static constexpr int k_maxReadAttempts = 10000;
+
+#ifdef _WIN32
+
+static std::wstring ToWide(const std::string& text)
+{
+	return std::wstring{ text.begin(), text.end() };
+}
+
+static std::string LastErrorText(const char* what)
+{
+	return std::string{ what } + " failed, error " + std::to_string(GetLastError());
+}
+
+bool SharedPoseMapping::Create(const std::string& name, std::string& error)
+{
+	Close();
+	m_handle = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(SharedPoseLayout), ToWide(name).c_str());
+	if (m_handle == nullptr)
+	{
+		error = LastErrorText("CreateFileMapping");
+		return false;
+	}
+	m_layout = static_cast<SharedPoseLayout*>(MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedPoseLayout)));
+	if (m_layout == nullptr)
+	{
+		error = LastErrorText("MapViewOfFile");
+		Close();
+		return false;
+	}
+	m_isOwner = true;
+	m_name = name;
+	return true;
+}
+
+bool SharedPoseMapping::Open(const std::string& name, std::string& error)
+{
+	Close();
+	m_handle = OpenFileMappingW(FILE_MAP_READ, FALSE, ToWide(name).c_str());
+	if (m_handle == nullptr)
+	{
+		error = LastErrorText("OpenFileMapping") + " (is the publisher running?)";
+		return false;
+	}
+	m_layout = static_cast<SharedPoseLayout*>(MapViewOfFile(m_handle, FILE_MAP_READ, 0, 0, sizeof(SharedPoseLayout)));
+	if (m_layout == nullptr)
+	{
+		error = LastErrorText("MapViewOfFile");
+		Close();
+		return false;
+	}
+	m_name = name;
+	return true;
+}
+
+void SharedPoseMapping::Close()
+{
+	if (m_layout != nullptr)
+	{
+		UnmapViewOfFile(m_layout);
+		m_layout = nullptr;
+	}
+	if (m_handle != nullptr)
+	{
+		CloseHandle(m_handle);
+		m_handle = nullptr;
+	}
+	m_isOwner = false;
+}
+
+static uint32_t CurrentProcessId()
+{
+	return GetCurrentProcessId();
+}
+
+#else
+
+// POSIX shared memory names are a single path component starting with '/'.
+static std::string ToShmName(const std::string& name)
+{
+	return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+static std::string LastErrorText(const char* what)
+{
+	return std::string{ what } + " failed: " + std::strerror(errno);
+}
+
+bool SharedPoseMapping::Create(const std::string& name, std::string& error)
+{
+	Close();
+	const std::string shmName = ToShmName(name);
+	const int fd = shm_open(shmName.c_str(), O_CREAT | O_RDWR, 0644);
+	if (fd < 0)
+	{
+		error = LastErrorText("shm_open");
+		return false;
+	}
+	if (ftruncate(fd, sizeof(SharedPoseLayout)) != 0)
+	{
+		error = LastErrorText("ftruncate");
+		close(fd);
+		return false;
+	}
+	void* address = mmap(nullptr, sizeof(SharedPoseLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (address == MAP_FAILED)
+	{
+		error = LastErrorText("mmap");
+		return false;
+	}
+	m_layout = static_cast<SharedPoseLayout*>(address);
+	m_isOwner = true;
+	m_name = shmName;
+	return true;
+}
+
+bool SharedPoseMapping::Open(const std::string& name, std::string& error)
+{
+	Close();
+	const std::string shmName = ToShmName(name);
+	const int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+	if (fd < 0)
+	{
+		error = LastErrorText("shm_open") + " (is the publisher running?)";
+		return false;
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(SharedPoseLayout)))
+	{
+		error = "shared memory " + shmName + " is too small for this layout version";
+		close(fd);
+		return false;
+	}
+	void* address = mmap(nullptr, sizeof(SharedPoseLayout), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (address == MAP_FAILED)
+	{
+		error = LastErrorText("mmap");
+		return false;
+	}
+	m_layout = static_cast<SharedPoseLayout*>(address);
+	m_name = shmName;
+	return true;
+}
+
+void SharedPoseMapping::Close()
+{
+	if (m_layout != nullptr)
+	{
+		munmap(m_layout, sizeof(SharedPoseLayout));
+		m_layout = nullptr;
+	}
+	if (m_isOwner)
+	{
+		// Readers that still have it mapped keep their view; new readers get "not running"
+		shm_unlink(m_name.c_str());
+		m_isOwner = false;
+	}
+}
+
+static uint32_t CurrentProcessId()
+{
+	return static_cast<uint32_t>(getpid());
+}
+
+#endif
+
+SharedPoseMapping::~SharedPoseMapping()
+{
+	Close();
+}
+
+bool SharedPosePublisher::Create(const std::string& name, std::string& error)
+{
+	if (!m_mapping.Create(name, error))
+	{
+		return false;
+	}
+
+	// The segment may be left over from a publisher that crashed: invalidate it before rebuilding, so
+	// readers still attached see a version mismatch rather than a half-built layout.
+	SharedPoseLayout* layout = m_mapping.Get();
+	reinterpret_cast<std::atomic<uint32_t>*>(layout)->store(0, std::memory_order_release);
+	layout = new (layout) SharedPoseLayout{};
+	layout->Version = k_sharedPoseVersion;
+	layout->LayoutSize = sizeof(SharedPoseLayout);
+	layout->HistoryCapacity = k_sharedPoseHistoryCapacity;
+	layout->WriterProcessId = CurrentProcessId();
+	layout->Magic.store(k_sharedPoseMagic, std::memory_order_release);
+	m_frameIndex = 0;
+	return true;
+}
+
+void SharedPosePublisher::PublishHeadPoses(const HeadPose* headPoses, int count)
+{
+	SharedPoseLayout* layout = m_mapping.Get();
+	if (layout == nullptr || count <= 0)
+	{
+		return;
+	}
+	uint64_t next = layout->HistoryCount.load(std::memory_order_relaxed);
+	for (int i = 0; i < count; i++, next++)
+	{
+		layout->History[next % k_sharedPoseHistoryCapacity].Pose.Store(headPoses[i]);
+	}
+	layout->HistoryCount.store(next, std::memory_order_release);
+}
+
+void SharedPosePublisher::PublishFrame(SharedPoseFrame frame)
+{
+	SharedPoseLayout* layout = m_mapping.Get();
+	if (layout == nullptr)
+	{
+		return;
+	}
+	frame.FrameIndex = ++m_frameIndex;
+	frame.PublishMicroSeconds = NowMicroSeconds();
+	layout->Latest.Store(frame);
+}
+
+void SharedPosePublisher::Publish(IStreamsProvider* streamsProvider, IExtendedView* extendedView, const HeadPose* headPoses, int headPoseCount)
+{
+	PublishHeadPoses(headPoses, headPoseCount);
+
+	SharedPoseFrame frame{};
+	frame.Transformation = extendedView->GetTransformation();
+	if (headPoseCount > 0)
+	{
+		frame.HeadPose = headPoses[headPoseCount - 1];
+		frame.Flags |= SharedPoseHasHeadPose;
+	}
+	if (streamsProvider->IsPresent())
+	{
+		frame.Flags |= SharedPosePresent;
+		// Not read while nobody is there, so the gaze stream can be unsubscribed like the head stream
+		if (streamsProvider->GetLatestGazePoint(frame.GazePoint))
+		{
+			frame.Flags |= SharedPoseHasGazePoint;
+		}
+	}
+	PublishFrame(frame);
+}
+
+bool SharedPoseReader::Open(const std::string& name, std::string& error)
+{
+	if (!m_mapping.Open(name, error))
+	{
+		return false;
+	}
+	const SharedPoseLayout* layout = m_mapping.Get();
+	const uint32_t magic = layout->Magic.load(std::memory_order_acquire);
+	if (magic != k_sharedPoseMagic || layout->Version != k_sharedPoseVersion || layout->LayoutSize != sizeof(SharedPoseLayout) ||
+		layout->HistoryCapacity != k_sharedPoseHistoryCapacity)
+	{
+		error = magic != k_sharedPoseMagic ? "the publisher hasn't finished setting up the shared memory" :
+			"the publisher uses shared memory layout version " + std::to_string(layout->Version) +
+			", this reader version " + std::to_string(k_sharedPoseVersion);
+		m_mapping.Close();
+		return false;
+	}
+	m_hasCursor = false;
+	m_lostCount = 0;
+	return true;
+}
+
+bool SharedPoseReader::ReadLatest(SharedPoseFrame& frame) const
+{
+	const SharedPoseLayout* layout = m_mapping.Get();
+	return layout != nullptr && layout->Latest.TryLoad(frame, k_maxReadAttempts) != 0;
+}
+
+int SharedPoseReader::ReadHeadPoses(HeadPose* headPoses, int maxCount)
+{
+	const SharedPoseLayout* layout = m_mapping.Get();
+	if (layout == nullptr)
+	{
+		return 0;
+	}
+	const uint64_t count = layout->HistoryCount.load(std::memory_order_acquire);
+	if (!m_hasCursor)
+	{
+		// Starts with what is published from now on
+		m_nextPose = count;
+		m_hasCursor = true;
+	}
+	if (count - m_nextPose > k_sharedPoseHistoryCapacity)
+	{
+		m_lostCount += count - m_nextPose - k_sharedPoseHistoryCapacity;
+		m_nextPose = count - k_sharedPoseHistoryCapacity;
+	}
+
+	int read = 0;
+	while (m_nextPose < count && read < maxCount)
+	{
+		// Pose n is the (n / capacity + 1)-th store into its slot, so the slot's sequence tells whether it
+		// still holds pose n or was overwritten by a newer lap in the meantime
+		const uint32_t expected = static_cast<uint32_t>(2 * (m_nextPose / k_sharedPoseHistoryCapacity + 1));
+		const uint32_t sequence = layout->History[m_nextPose % k_sharedPoseHistoryCapacity].Pose.TryLoad(headPoses[read], k_maxReadAttempts);
+		if (sequence == expected)
+		{
+			read++;
+		}
+		else
+		{
+			m_lostCount++;
+		}
+		m_nextPose++;
+	}
+	return read;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Seqlock.h"
+#include "TobiiPlatform.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Lets overlays, loggers and tuning tools on the same machine read the tracker data of the process that
+// owns the ITobiiGameIntegrationApi, without their own API connection and without system calls per read:
+// the owner publishes into a named shared-memory segment (POSIX shm on Linux, a pagefile-backed file
+// mapping on Windows), readers map it and poll seqlocks.
+//
+// Layout, version k_sharedPoseVersion. Readers must check Magic, Version and LayoutSize before use; the
+// writer sets Magic last. Any change to the structs below bumps the version.
+
+static constexpr uint32_t k_sharedPoseMagic = 0x50474954;	// "TIGP"
+static constexpr uint32_t k_sharedPoseVersion = 1;
+static constexpr uint32_t k_sharedPoseHistoryCapacity = 256;	// power of two
+static constexpr const char* k_defaultSharedPoseName = "TobiiHeadPose";
+
+enum SharedPoseFlags : uint32_t
+{
+	SharedPosePresent = 1 << 0,
+	SharedPoseHasHeadPose = 1 << 1,
+	SharedPoseHasGazePoint = 1 << 2,
+};
+
+// Latest state, replaced as a whole once per tracker Update().
+struct SharedPoseFrame
+{
+	uint64_t FrameIndex;
+	int64_t PublishMicroSeconds;							// NowMicroSeconds() of the publisher, a system-wide monotonic clock
+	TobiiGameIntegration::HeadPose HeadPose;				// newest raw head pose
+	TobiiGameIntegration::Transformation Transformation;	// Extended View's filtered transform
+	TobiiGameIntegration::GazePoint GazePoint;
+	uint32_t Flags;											// SharedPoseFlags
+	uint32_t Reserved;
+};
+
+struct alignas(k_cacheLineSize) SharedHeadPoseSlot
+{
+	Seqlock<TobiiGameIntegration::HeadPose> Pose;
+};
+
+struct SharedPoseLayout
+{
+	std::atomic<uint32_t> Magic;
+	uint32_t Version;
+	uint32_t LayoutSize;
+	uint32_t HistoryCapacity;
+	uint32_t WriterProcessId;
+
+	Seqlock<SharedPoseFrame> Latest;
+
+	// Every raw head pose, oldest overwritten first. HistoryCount poses have been written in total;
+	// pose n lives in History[n % HistoryCapacity].
+	alignas(k_cacheLineSize) std::atomic<uint64_t> HistoryCount;
+	SharedHeadPoseSlot History[k_sharedPoseHistoryCapacity];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+	"shared memory needs address-free atomics");
+
+// Platform mapping of a named segment holding one SharedPoseLayout.
+class SharedPoseMapping
+{
+public:
+	SharedPoseMapping() = default;
+	~SharedPoseMapping();
+
+	SharedPoseMapping(const SharedPoseMapping&) = delete;
+	SharedPoseMapping& operator=(const SharedPoseMapping&) = delete;
+
+	bool Create(const std::string& name, std::string& error);
+	bool Open(const std::string& name, std::string& error);
+	void Close();
+
+	SharedPoseLayout* Get() const { return m_layout; }
+
+private:
+	SharedPoseLayout* m_layout = nullptr;
+	bool m_isOwner = false;
+	std::string m_name;
+#ifdef _WIN32
+	void* m_handle = nullptr;
+#endif
+};
+
+// Writer side, used by the thread that owns the API.
+class SharedPosePublisher
+{
+public:
+	// Creates (or takes over) the segment. Returns false and says why on failure.
+	bool Create(const std::string& name, std::string& error);
+
+	// Appends raw head poses to the history, oldest first.
+	void PublishHeadPoses(const TobiiGameIntegration::HeadPose* headPoses, int count);
+	// Replaces the latest frame. FrameIndex and PublishMicroSeconds are filled in here.
+	void PublishFrame(SharedPoseFrame frame);
+
+	// Both of the above for one tracker Update(): headPoses are the poses read from GetHeadPoses(), if any.
+	// Reads the transform, presence and, while someone is present, the gaze point from the API.
+	void Publish(TobiiGameIntegration::IStreamsProvider* streamsProvider, TobiiGameIntegration::IExtendedView* extendedView,
+		const TobiiGameIntegration::HeadPose* headPoses, int headPoseCount);
+
+private:
+	SharedPoseMapping m_mapping;
+	uint64_t m_frameIndex = 0;
+};
+
+// Reader side, any process and any number of readers.
+class SharedPoseReader
+{
+public:
+	// Maps the segment and checks its layout version.
+	bool Open(const std::string& name, std::string& error);
+
+	// Copies the latest frame, false until the first one is published.
+	bool ReadLatest(SharedPoseFrame& frame) const;
+
+	// Copies the poses published since the previous call, oldest first, at most maxCount. Poses that were
+	// overwritten before this reader got to them are skipped and counted in GetLostCount().
+	int ReadHeadPoses(TobiiGameIntegration::HeadPose* headPoses, int maxCount);
+
+	uint64_t GetLostCount() const { return m_lostCount; }
+
+private:
+	SharedPoseMapping m_mapping;
+	uint64_t m_nextPose = 0;
+	uint64_t m_lostCount = 0;
+	bool m_hasCursor = false;
+};
@@ -0,0 +1,66 @@
+#include "PredictionScore.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace TobiiGameIntegration;
+
+static constexpr float k_millidegrees = 1000.0f;
+
+PredictionScore::PredictionScore(int64_t horizonMicroSeconds)
+	: m_horizonMicroSeconds{ horizonMicroSeconds }
+{ }
+
+void PredictionScore::AddPose(const HeadPose& raw, const Rotation& predicted)
+{
+	const int64_t timeStamp = raw.TimeStampMicroSeconds;
+	if (m_hasPrevious && timeStamp <= m_previous.TimeStampMicroSeconds)
+	{
+		return;
+	}
+
+	while (m_hasPrevious && !m_pending.empty() && m_pending.front().TargetMicroSeconds <= timeStamp)
+	{
+		const Pending& pending = m_pending.front();
+		const int64_t previousTimeStamp = m_previous.TimeStampMicroSeconds;
+		const float t = (std::max)(pending.TargetMicroSeconds - previousTimeStamp, int64_t{ 0 }) /
+			static_cast<float>(timeStamp - previousTimeStamp);
+		const float actualYaw = m_previous.Rotation.YawDegrees + t * (raw.Rotation.YawDegrees - m_previous.Rotation.YawDegrees);
+		const float actualPitch = m_previous.Rotation.PitchDegrees + t * (raw.Rotation.PitchDegrees - m_previous.Rotation.PitchDegrees);
+		Score(pending, actualYaw, actualPitch);
+		m_pending.pop_front();
+	}
+
+	m_pending.push_back({ timeStamp + m_horizonMicroSeconds,
+		raw.Rotation.YawDegrees, raw.Rotation.PitchDegrees, predicted.YawDegrees, predicted.PitchDegrees });
+	m_previous = raw;
+	m_hasPrevious = true;
+}
+
+void PredictionScore::Score(const Pending& pending, float actualYaw, float actualPitch)
+{
+	const float rawError = std::hypot(actualYaw - pending.RawYaw, actualPitch - pending.RawPitch);
+	const float errorYaw = pending.PredictedYaw - actualYaw;
+	const float errorPitch = pending.PredictedPitch - actualPitch;
+	const float predictedError = std::hypot(errorYaw, errorPitch);
+
+	float overshoot = 0.0f;
+	const float leadYaw = pending.PredictedYaw - pending.RawYaw;
+	const float leadPitch = pending.PredictedPitch - pending.RawPitch;
+	const float lead = std::hypot(leadYaw, leadPitch);
+	if (lead > 0.0f)
+	{
+		overshoot = (std::max)((errorYaw * leadYaw + errorPitch * leadPitch) / lead, 0.0f);
+	}
+
+	m_rawError.Record(std::lround(rawError * k_millidegrees));
+	m_predictedError.Record(std::lround(predictedError * k_millidegrees));
+	m_overshoot.Record(std::lround(overshoot * k_millidegrees));
+}
+
+void PredictionScore::Print(std::ostream& out) const
+{
+	out << "Prediction over " << m_horizonMicroSeconds / 1000.0 << " ms:" << std::endl;
+	m_rawError.Print(out, "Error without prediction", "mdeg");
+	m_predictedError.Print(out, "Error with prediction", "mdeg");
+	m_overshoot.Print(out, "Overshoot", "mdeg");
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+#include "TobiiPlatform.h"
+#include <cstdint>
+#include <deque>
+#include <ostream>
+
+// Scores a PosePredictor offline: each prediction is compared with the raw pose that actually
+// arrived HorizonMicroSeconds later (interpolated between samples). The raw error is what applying
+// the pose as-is costs, the predicted error what is left with prediction; overshoot is how far the
+// prediction went past the actual pose in the direction it led. Yaw and pitch only, in millidegrees.
+class PredictionScore
+{
+public:
+	explicit PredictionScore(int64_t horizonMicroSeconds);
+
+	// Poses in timestamp order: the raw sample and the prediction made from it.
+	void AddPose(const TobiiGameIntegration::HeadPose& raw, const TobiiGameIntegration::Rotation& predicted);
+
+	uint64_t GetCount() const { return m_rawError.GetCount(); }
+	void Print(std::ostream& out) const;
+
+private:
+	struct Pending
+	{
+		int64_t TargetMicroSeconds;
+		float RawYaw, RawPitch;
+		float PredictedYaw, PredictedPitch;
+	};
+
+	void Score(const Pending& pending, float actualYaw, float actualPitch);
+
+	int64_t m_horizonMicroSeconds;
+	std::deque<Pending> m_pending;
+	TobiiGameIntegration::HeadPose m_previous;
+	bool m_hasPrevious = false;
+
+	LatencyHistogram m_rawError;
+	LatencyHistogram m_predictedError;
+	LatencyHistogram m_overshoot;
+};
@@ -0,0 +1,122 @@
+#include "ProfileWatcher.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+ProfileWatcher::ProfileWatcher(const std::string& path, SnapshotSlot<ResponseCurves>& slot)
+	: m_path{ path }, m_slot{ slot }
+{ }
+
+ProfileWatcher::~ProfileWatcher()
+{
+	Stop();
+}
+
+void ProfileWatcher::Start()
+{
+	if (m_running)
+	{
+		return;
+	}
+	m_running = true;
+	m_thread = std::thread{ &ProfileWatcher::Run, this };
+}
+
+void ProfileWatcher::Stop()
+{
+	m_running = false;
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+void ProfileWatcher::Reload()
+{
+	ResponseProfile profile;
+	std::string error;
+	if (!LoadResponseProfile(m_path.c_str(), profile, error))
+	{
+		m_failedCount.fetch_add(1, std::memory_order_relaxed);
+		std::cout << std::endl << "Profile not reloaded: " << error << std::endl;
+		return;
+	}
+	// The strategy was fixed at startup; only the curves are swapped in
+	m_slot.Publish(profile.HasCurves ? std::make_unique<const ResponseCurves>(profile) : nullptr);
+	m_reloadCount.fetch_add(1, std::memory_order_relaxed);
+	std::cout << std::endl << "Profile reloaded: " << m_path << std::endl;
+}
+
+#ifdef __linux__
+void ProfileWatcher::Run()
+{
+	const std::filesystem::path path{ m_path };
+	const std::string fileName = path.filename().string();
+	const std::string directory = path.has_parent_path() ? path.parent_path().string() : ".";
+
+	// Saves in place and atomic renames, not IN_CREATE: that fires before the editor has written anything
+	const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0 || inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+	{
+		std::cout << "Can't watch " << directory << ", profile changes won't be picked up" << std::endl;
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return;
+	}
+
+	alignas(inotify_event) char buffer[4096];
+	while (m_running.load(std::memory_order_relaxed))
+	{
+		pollfd pending{ fd, POLLIN, 0 };
+		if (poll(&pending, 1, k_pollMilliseconds) <= 0)
+		{
+			m_slot.Reclaim();
+			continue;
+		}
+
+		bool changed = false;
+		ssize_t length;
+		while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+		{
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				changed |= event->len > 0 && fileName == event->name;
+				offset += sizeof(inotify_event) + event->len;
+			}
+		}
+		if (changed)
+		{
+			Reload();
+		}
+	}
+	close(fd);
+}
+#else
+void ProfileWatcher::Run()
+{
+	std::error_code error;
+	auto lastWrite = std::filesystem::last_write_time(m_path, error);
+	while (m_running.load(std::memory_order_relaxed))
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(k_pollMilliseconds));
+		m_slot.Reclaim();
+
+		const auto write = std::filesystem::last_write_time(m_path, error);
+		if (!error && write != lastWrite)
+		{
+			lastWrite = write;
+			Reload();
+		}
+	}
+}
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ResponseCurve.h"
+#include "SnapshotSlot.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+// Reloads a response profile whenever its file changes and publishes the compiled curves to a
+// SnapshotSlot. Parsing and table building happen on the watcher thread; a profile that fails to
+// parse is reported and the previous one stays in use.
+// Linux uses inotify on the file's directory, so editors that save by renaming are seen too.
+// Elsewhere the modification time is polled every k_pollMilliseconds.
+class ProfileWatcher
+{
+public:
+	static constexpr int k_pollMilliseconds = 250;
+
+	ProfileWatcher(const std::string& path, SnapshotSlot<ResponseCurves>& slot);
+	~ProfileWatcher();
+
+	void Start();
+	void Stop();
+
+	uint32_t GetReloadCount() const { return m_reloadCount.load(std::memory_order_relaxed); }
+	uint32_t GetFailedCount() const { return m_failedCount.load(std::memory_order_relaxed); }
+
+private:
+	void Run();
+	void Reload();
+
+	std::string m_path;
+	SnapshotSlot<ResponseCurves>& m_slot;
+	std::thread m_thread;
+	std::atomic<bool> m_running{ false };
+	std::atomic<uint32_t> m_reloadCount{ 0 };
+	std::atomic<uint32_t> m_failedCount{ 0 };
+};
@@ -0,0 +1,53 @@
+#include "RateIntegrator.h"
+#include <algorithm>
+#include <cmath>
+
+static constexpr int64_t k_one = int64_t{ 1 } << RateIntegrator::k_fractionBits;
+
+RateIntegrator::RateIntegrator(int64_t stepMicroSeconds, int64_t maxCatchUpMicroSeconds)
+	: m_stepMicroSeconds{ (std::max)(stepMicroSeconds, int64_t{ 1 }) },
+	m_maxCatchUpSteps{ (std::max)(maxCatchUpMicroSeconds / m_stepMicroSeconds, int64_t{ 1 }) }
+{ }
+
+MouseDelta RateIntegrator::Advance(float speedX, float speedMinusY, int64_t timeStampMicroSeconds)
+{
+	const int64_t step = timeStampMicroSeconds / m_stepMicroSeconds;
+	if (m_lastStep < 0)
+	{
+		m_lastStep = step;
+		return { 0, 0, timeStampMicroSeconds };
+	}
+	int64_t steps = step - m_lastStep;
+	if (steps <= 0)
+	{
+		// Still within the current step, or a timestamp going backwards: nothing completed
+		return { 0, 0, timeStampMicroSeconds };
+	}
+	m_lastStep = step;
+	if (steps > m_maxCatchUpSteps)
+	{
+		m_skippedStepCount += steps - m_maxCatchUpSteps;
+		steps = m_maxCatchUpSteps;
+	}
+	m_stepCount += steps;
+
+	// The motion of one step is quantized once, so every step at the same speed adds exactly the same amount
+	const double stepSeconds = static_cast<double>(m_stepMicroSeconds) * 1e-6;
+	m_accumulatedDx += std::llround(speedX * stepSeconds * k_one) * steps;
+	m_accumulatedMinusDy += std::llround(speedMinusY * stepSeconds * k_one) * steps;
+	return { TakeWholeCounts(m_accumulatedDx), TakeWholeCounts(m_accumulatedMinusDy), timeStampMicroSeconds };
+}
+
+void RateIntegrator::Reset(int64_t timeStampMicroSeconds)
+{
+	m_lastStep = timeStampMicroSeconds / m_stepMicroSeconds;
+	m_accumulatedDx = 0;
+	m_accumulatedMinusDy = 0;
+}
+
+long RateIntegrator::TakeWholeCounts(int64_t& accumulator)
+{
+	const int64_t whole = accumulator / k_one;
+	accumulator -= whole * k_one;
+	return static_cast<long>(whole);
+}
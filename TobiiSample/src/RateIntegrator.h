@@ -0,0 +1,44 @@
+#pragma once
+
+#include "HeadMouseMapping.h"
+#include <cstdint>
+
+// Turns a cursor speed into whole mouse counts on a fixed grid of time steps, driven by sample
+// timestamps rather than by when the loop happens to run. A sample at time t completes every step that
+// ends at or before t, each step moving by the sample's speed times the step length. Motion is summed in
+// 48.16 fixed point, so the remainder carries over exactly, and whole counts are taken towards zero, so
+// a speed that drops to zero never leaves a count in the opposite direction behind.
+// The output depends only on the samples, not on how they are batched or how often they are polled.
+// After a gap longer than the catch-up limit (dropout, stall) only the limit is made up; the rest of the
+// gap is skipped, the same way on every run.
+// Used from one thread.
+class RateIntegrator
+{
+public:
+	static constexpr int k_fractionBits = 16;
+
+	// maxCatchUpMicroSeconds below one step still allows one step per sample.
+	RateIntegrator(int64_t stepMicroSeconds, int64_t maxCatchUpMicroSeconds);
+
+	// Speeds in counts per second. The first sample after construction only sets the grid position.
+	MouseDelta Advance(float speedX, float speedMinusY, int64_t timeStampMicroSeconds);
+
+	// Drops the remainder and continues from the step that contains timeStampMicroSeconds, without
+	// making up the time in between.
+	void Reset(int64_t timeStampMicroSeconds);
+
+	int64_t GetStepMicroSeconds() const { return m_stepMicroSeconds; }
+	uint64_t GetStepCount() const { return m_stepCount; }
+	uint64_t GetSkippedStepCount() const { return m_skippedStepCount; }
+
+private:
+	static long TakeWholeCounts(int64_t& accumulator);
+
+	int64_t m_stepMicroSeconds;
+	int64_t m_maxCatchUpSteps;
+	int64_t m_lastStep = -1;
+	int64_t m_accumulatedDx = 0;
+	int64_t m_accumulatedMinusDy = 0;
+	uint64_t m_stepCount = 0;
+	uint64_t m_skippedStepCount = 0;
+};
@@ -0,0 +1,436 @@
+// Headless entry point: runs MyNewMain's mapping over a recorded session or a synthetic stream,
+// no tracker or Windows needed. Build it instead of MyNewMain.cpp, e.g. on Linux:
+//   g++ -std=c++20 -O2 -fpermissive -Ivendor/tobii/include src/ReplayMain.cpp src/ActivityGovernor.cpp src/HeadMouseMapping.cpp src/MappingKernel.cpp
+//       src/MappingEngine.cpp src/MappingStep.cpp src/RateIntegrator.cpp src/StrategySettings.cpp src/LatencyHistogram.cpp src/MouseOutput.cpp src/OutputCoalescer.cpp
+//       src/OfflineApi.cpp src/PacedScheduler.cpp src/PosePredictor.cpp src/PredictionScore.cpp src/PoseSharedMemory.cpp src/OpenTrackApi.cpp
+//       src/OpenTrackUdp.cpp src/HeadPoseFilter.cpp src/OutputGate.cpp src/ResponseCurve.cpp src/SessionRecording.cpp src/SyntheticApi.cpp
+//       src/Telemetry.cpp src/Trace.cpp src/ApiBackend.cpp -o replay
+// Usage: replay <session file> [--realtime] [options]
+//        replay synthetic:<settings> [options]     e.g. synthetic:rate=5000,fast=50,duration=60
+//        replay opentrack:<settings> [options]     e.g. opentrack:4242,timeout=5 --output uinput
+// --filter smooths the poses first (see ParseFilterChain()) and reports the cost of each stage.
+// --predict runs the poses through PosePredictor before mapping and scores it against the future poses.
+// --profile maps through the response curves in a profile file instead of SquadTuning.h, with its strategy.
+// --strategy absolute|rate|follow|hold overrides the profile's strategy; --hold <script> says when the hold
+// strategy's key is down, in the gate script format with any reason, e.g. pause@1-3,repeat=4.
+// --gate script:<script> holds output back like a visible cursor would, see ParseGateScript(); --resume catchup
+// emits the motion made meanwhile at once instead of resyncing.
+// --output sends the deltas somewhere other than the default in-memory capture, e.g. uinput.
+// --coalesce <hz>[:flush] combines the deltas into one move per period of sample time, see OutputCoalescer.
+// --telemetry <hz|inline> shows the status line like MyNewMain does, off by default.
+// --idle paces Update() like MyNewMain's tracker thread, through the ActivityGovernor, and reports the CPU time
+// per stage. Only meaningful for sources that follow the wall clock (--realtime, synthetic without fast=).
+// --opentrack-out [<address>:]<port> sends every raw head pose on as an OpenTrack packet.
+// --publish <name> shares the poses like MyNewMain does, so PoseReaderMain can be tried without a tracker.
+// --trace <file> writes the tracing zones of the whole run as Chrome trace JSON, with -DENABLE_TRACING=1 (Trace.h).
+#include "ActivityGovernor.h"
+#include "ApiBackend.h"
+#include "Clock.h"
+#include "HeadMouseMapping.h"
+#include "HeadPoseFilter.h"
+#include "LatencyHistogram.h"
+#include "MappingEngine.h"
+#include "MappingStep.h"
+#include "MouseOutput.h"
+#include "OutputCoalescer.h"
+#include "OutputGate.h"
+#include "OfflineApi.h"
+#include "OpenTrackApi.h"
+#include "PacedScheduler.h"
+#include "PosePredictor.h"
+#include "PoseSharedMemory.h"
+#include "PredictionScore.h"
+#include "SquadTuning.h"
+#include "Telemetry.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TobiiGameIntegration;
+
+static constexpr int k_deltaBatchSize = 64;
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: " << argv[0] << " <session file> [--realtime] | synthetic:<settings> | opentrack:<settings>  [--filter <chain>] [--predict <ms>] [--profile <file>] [--strategy <mode>] [--hold <script>] [--gate <spec>] [--resume catchup] [--output <spec>] [--coalesce <hz>[:flush]] [--telemetry <hz|inline>] [--idle] [--publish <name>] [--opentrack-out [<address>:]<port>] [--trace <file>]" << std::endl;
+		return 1;
+	}
+	const std::string source{ argv[1] };
+	bool realtime = false;
+	std::string outputSpec = "capture:0";
+	double coalesceRateHz = 0.0;
+	CoalescerGatePolicy coalescePolicy = CoalescerGatePolicy::Discard;
+	std::string gateSpec = "open";
+	bool resyncOnResume = true;
+	bool governed = false;
+	int telemetryRateHz = TelemetryRenderer::k_headless;
+	HeadPoseFilter filter;
+	PredictionSettings predictionSettings;
+	std::unique_ptr<ResponseCurves> curves;
+	StrategySettings strategy;
+	std::string strategyMode;
+	std::unique_ptr<OutputGate> holdScript;
+	std::unique_ptr<SharedPosePublisher> publisher;
+	std::unique_ptr<OpenTrackSender> openTrackSender;
+	std::string tracePath;
+	for (int i = 2; i < argc; i++)
+	{
+		const std::string arg{ argv[i] };
+		if (arg == "--realtime")
+		{
+			realtime = true;
+		}
+		else if (arg == "--idle")
+		{
+			governed = true;
+		}
+		else if (arg == "--filter" && i + 1 < argc)
+		{
+			std::string error;
+			if (!ParseFilterChain(argv[++i], filter, error))
+			{
+				std::cout << error << std::endl;
+				return 1;
+			}
+		}
+		else if (arg == "--predict" && i + 1 < argc)
+		{
+			predictionSettings.HorizonMicroSeconds = std::atoi(argv[++i]) * int64_t{ 1000 };
+		}
+		else if (arg == "--profile" && i + 1 < argc)
+		{
+			ResponseProfile profile;
+			std::string error;
+			if (!LoadResponseProfile(argv[++i], profile, error))
+			{
+				std::cout << error << std::endl;
+				return 1;
+			}
+			if (profile.HasCurves)
+			{
+				curves = std::make_unique<ResponseCurves>(profile);
+			}
+			strategy = profile.Strategy;
+		}
+		else if (arg == "--strategy" && i + 1 < argc)
+		{
+			strategyMode = argv[++i];
+		}
+		else if (arg == "--hold" && i + 1 < argc)
+		{
+			// Held while the script would block output
+			holdScript = CreateOutputGate((std::string{ "script:" } + argv[++i]).c_str(), nullptr);
+			if (holdScript == nullptr)
+			{
+				return 1;
+			}
+		}
+		else if (arg == "--gate" && i + 1 < argc)
+		{
+			gateSpec = argv[++i];
+		}
+		else if (arg == "--resume" && i + 1 < argc)
+		{
+			resyncOnResume = std::string{ argv[++i] } != "catchup";
+		}
+		else if (arg == "--output" && i + 1 < argc)
+		{
+			outputSpec = argv[++i];
+		}
+		else if (arg == "--coalesce" && i + 1 < argc && !ParseCoalescerSpec(argv[++i], coalesceRateHz, coalescePolicy))
+		{
+			std::cout << "Invalid --coalesce " << argv[i] << std::endl;
+			return 1;
+		}
+		else if (arg == "--publish" && i + 1 < argc)
+		{
+			std::string error;
+			publisher = std::make_unique<SharedPosePublisher>();
+			if (!publisher->Create(argv[++i], error))
+			{
+				std::cout << "Can't publish poses as " << argv[i] << ": " << error << std::endl;
+				return 1;
+			}
+		}
+		else if (arg == "--trace" && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+		}
+		else if (arg == "--opentrack-out" && i + 1 < argc)
+		{
+			std::string address = "127.0.0.1", error;
+			uint16_t port = k_defaultOpenTrackPort;
+			openTrackSender = std::make_unique<OpenTrackSender>();
+			if (!ParseOpenTrackEndpoint(argv[++i], address, port) || !openTrackSender->Open(address, port, error))
+			{
+				std::cout << "Can't send OpenTrack packets to " << argv[i] << " " << error << std::endl;
+				return 1;
+			}
+		}
+		else if (arg == "--telemetry" && i + 1 < argc && !ParseTelemetryRate(argv[++i], telemetryRateHz))
+		{
+			std::cout << "Invalid --telemetry " << argv[i] << std::endl;
+			return 1;
+		}
+	}
+	if (!strategyMode.empty() && !ParseStrategyEntry("mode", strategyMode, strategy))
+	{
+		std::cout << "Unknown strategy " << strategyMode << std::endl;
+		return 1;
+	}
+	const bool synthetic = source.rfind("synthetic", 0) == 0;
+	const bool network = source.rfind("opentrack", 0) == 0;
+	const std::string backendSpec = synthetic || network ? source : (realtime ? "replay:" : "replay-fast:") + source;
+	// Fast replay keeps the recorded timestamps, so sample age only means something for the other sources
+	const bool measureLatency = synthetic || network || realtime;
+
+	std::unique_ptr<MouseOutput> output = CreateMouseOutput(outputSpec.c_str());
+	std::unique_ptr<OutputGate> gate = CreateOutputGate(gateSpec.c_str(), nullptr);
+	if (output == nullptr || gate == nullptr)
+	{
+		return 1;
+	}
+	std::unique_ptr<OutputCoalescer> coalescer;
+	if (coalesceRateHz > 0.0)
+	{
+		coalescer = std::make_unique<OutputCoalescer>(*output, coalesceRateHz, coalescePolicy);
+	}
+
+	// Every backend that can run here is an OfflineApi, which knows when its source is exhausted
+	OfflineApi* api = dynamic_cast<OfflineApi*>(GetBackendApi("Replay", backendSpec.c_str()));
+	if (api == nullptr)
+	{
+		return 1;
+	}
+	IStreamsProvider* streamsProvider = api->GetStreamsProvider();
+	IExtendedView* extendedView = api->GetFeatures()->GetExtendedView();
+
+	ExtendedViewSettings extendedViewSettings;
+	extendedView->GetSettings(extendedViewSettings);
+
+	MappingSettings mappingSettings = SquadMappingSettings();
+	mappingSettings.HeadPoseYawScale = extendedViewSettings.HeadTracking.YawRightDegrees.SensitivityScaling;
+	mappingSettings.HeadPosePitchScale = extendedViewSettings.HeadTracking.PitchUpDegrees.SensitivityScaling;
+	std::unique_ptr<MappingEngine> mapper = CreateMappingEngine(strategy, mappingSettings);
+	mapper->SetCurves(curves.get());
+	MouseDelta deltas[k_deltaBatchSize];
+	PosePredictor predictor{ predictionSettings };
+	MappingStep step{ *mapper, filter, predictor, *gate, *output, coalescer.get(), resyncOnResume };
+	PredictionScore predictionScore{ predictionSettings.HorizonMicroSeconds };
+	std::vector<HeadPose> processedPoses;
+
+	LatencyHistogram sampleToMapped, updatePeriod, resumeJump;
+	uint64_t frames = 0, headPoses = 0, heldPoses = 0, reversals = 0;
+	long lastDx = 0;
+	int64_t mappingMicroSeconds = 0;
+	TelemetryRenderer telemetry{ telemetryRateHz };
+	telemetry.Start();
+	const int64_t start = NowMicroSeconds();
+	int64_t lastUpdate = -1;
+	PacedScheduler idle{ 1000.0 };
+	ActivitySettings activitySettings;
+	ActivityGovernor activity{ activitySettings };
+	PacedScheduler pacing{ activitySettings.ActiveRateHz };
+	if (governed)
+	{
+		activity.ConfigureStreams(streamsProvider);
+	}
+
+	TRACE_THREAD("replay");
+	while (!api->IsFinished())
+	{
+		if (governed)
+		{
+			TRACE_ZONE("WaitForNextTick");
+			pacing.WaitForNextTick();
+		}
+		TRACE_ZONE("Frame");
+		{
+			TRACE_ZONE("Update");
+			api->Update();
+		}
+		frames++;
+		if (measureLatency)
+		{
+			const int64_t now = NowMicroSeconds();
+			if (lastUpdate >= 0)
+			{
+				updatePeriod.Record(now - lastUpdate);
+			}
+			lastUpdate = now;
+		}
+
+		const HeadPose* rawPoses = nullptr;
+		const int poseCount = !governed || activity.ShouldReadHeadPoses() ? streamsProvider->GetHeadPoses(rawPoses) : 0;
+		headPoses += poseCount;
+		if (publisher != nullptr)
+		{
+			publisher->Publish(streamsProvider, extendedView, rawPoses, poseCount);
+		}
+		if (openTrackSender != nullptr)
+		{
+			openTrackSender->Send(rawPoses, poseCount);
+		}
+		if (governed && activity.Advance(NowMicroSeconds(), streamsProvider->IsPresent(), poseCount > 0 ? &rawPoses[poseCount - 1] : nullptr,
+			!gate->IsOutputAllowed()))
+		{
+			pacing.SetRate(activity.GetRateHz());
+		}
+
+		if (poseCount == 0)
+		{
+			// Poll like MyNewMain's tracker thread does rather than spinning on a realtime source
+			if (measureLatency && !governed)
+			{
+				idle.WaitUntil(NowMicroSeconds() + idle.GetPeriodMicroSeconds());
+			}
+			continue;
+		}
+
+		const int64_t mappingStart = NowMicroSeconds();
+		// Copied like MyNewMain's mapping thread copies them off the ring, the step filters and predicts in place
+		processedPoses.assign(rawPoses, rawPoses + poseCount);
+		const HeadPose* poses = processedPoses.data();
+		for (int first = 0; first < poseCount; first += k_deltaBatchSize)
+		{
+			const int count = (std::min)(k_deltaBatchSize, poseCount - first);
+			const int64_t sampleTime = rawPoses[first + count - 1].TimeStampMicroSeconds;
+			if (holdScript != nullptr)
+			{
+				holdScript->Advance(sampleTime);
+				mapper->SetModifierHeld(!holdScript->IsOutputAllowed());
+			}
+			TelemetrySnapshot snapshot;
+			const int deltaCount = step.MapBatch(processedPoses.data() + first, count, sampleTime, deltas, snapshot);
+			if (!snapshot.OutputActive)
+			{
+				heldPoses += count;
+			}
+			// Jitter shows up as horizontal deltas that keep changing direction
+			for (int i = 0; i < deltaCount; i++)
+			{
+				if (deltas[i].Dx != 0)
+				{
+					reversals += (deltas[i].Dx > 0) != (lastDx > 0) && lastDx != 0;
+					lastDx = deltas[i].Dx;
+				}
+			}
+			if (step.HasResumed() && frames > 1)
+			{
+				int64_t jump = 0;
+				for (int i = 0; i < deltaCount; i++)
+				{
+					jump += std::abs(deltas[i].Dx) + std::abs(deltas[i].MinusDy);
+				}
+				resumeJump.Record(jump);
+			}
+			telemetry.Publish(snapshot);
+		}
+		const int64_t mappingEnd = NowMicroSeconds();
+		mappingMicroSeconds += mappingEnd - mappingStart;
+		if (predictor.IsEnabled())
+		{
+			for (int i = 0; i < poseCount; i++)
+			{
+				predictionScore.AddPose(rawPoses[i], poses[i].Rotation);
+			}
+		}
+		if (measureLatency)
+		{
+			for (int i = 0; i < poseCount; i++)
+			{
+				sampleToMapped.Record(mappingEnd - poses[i].TimeStampMicroSeconds);
+			}
+		}
+	}
+
+	step.Flush(NowMicroSeconds());
+	const uint64_t mouseEvents = step.GetEmittedCount();
+	const double seconds = (NowMicroSeconds() - start) / 1e6;
+	telemetry.Stop();
+	if (telemetry.GetRenderedCount() > 0)
+	{
+		std::cout << std::endl << "Status lines rendered: " << telemetry.GetRenderedCount() << std::endl;
+	}
+	std::cout << "Strategy: " << GetStrategyName(mapper->GetKind()) << std::endl;
+	std::cout << "Frames: " << frames << ", head poses: " << headPoses << ", mouse events: " << mouseEvents << ", direction reversals: " << reversals << std::endl;
+	if (const CaptureMouseOutput* capture = dynamic_cast<const CaptureMouseOutput*>(output.get()))
+	{
+		std::cout << "Total counts: dx " << capture->GetTotalDx() << ", -dy " << capture->GetTotalMinusDy() << std::endl;
+	}
+	std::cout << "Wall time: " << seconds << " s, mapping and output: " << mappingMicroSeconds << " us";
+	if (headPoses > 0)
+	{
+		std::cout << " (" << (mappingMicroSeconds * 1000.0 / headPoses) << " ns/pose)";
+	}
+	std::cout << std::endl;
+	if (mappingMicroSeconds > 0)
+	{
+		std::cout << "Mapping throughput: " << (headPoses * 1e6 / mappingMicroSeconds) << " poses/s" << std::endl;
+	}
+
+	if (governed)
+	{
+		activity.Finish(NowMicroSeconds());
+		activity.Print(std::cout);
+	}
+	if (coalescer != nullptr)
+	{
+		std::cout << "Coalesced " << coalescer->GetAddedCount() << " deltas into " << coalescer->GetEmittedCount() << " moves of at most one per " <<
+			coalescer->GetPeriodMicroSeconds() << " us" << std::endl;
+	}
+	if (const OpenTrackApi* openTrack = dynamic_cast<const OpenTrackApi*>(api))
+	{
+		const OpenTrackReceiver& receiver = openTrack->GetReceiver();
+		std::cout << "OpenTrack packets received: " << receiver.GetReceivedCount() << ", malformed: " << receiver.GetMalformedCount() <<
+			", receive calls: " << receiver.GetSystemCallCount() << std::endl;
+	}
+	if (openTrackSender != nullptr)
+	{
+		std::cout << "OpenTrack packets sent: " << openTrackSender->GetSentCount() << ", dropped: " << openTrackSender->GetDroppedCount() << std::endl;
+	}
+	if (gate->GetTransitionCount() > 0)
+	{
+		std::cout << "Output gate: " << gate->GetTransitionCount() << " transitions, " << heldPoses << " poses held back" << std::endl;
+		resumeJump.Print(std::cout, resyncOnResume ? "First batch after resume (resync)" : "First batch after resume (catch up)", "counts");
+	}
+	for (int i = 0; i < filter.GetStageCount(); i++)
+	{
+		const FilterStageStats& stats = filter.GetStageStats(i);
+		std::cout << "Filter stage " << i << " (" << DescribeFilterStage(filter.GetStageSettings(i)) << "): " <<
+			(stats.Samples > 0 ? static_cast<double>(stats.NanoSeconds) / stats.Samples : 0.0) << " ns/pose" << std::endl;
+	}
+	if (predictor.IsEnabled())
+	{
+		predictionScore.Print(std::cout);
+	}
+	if (measureLatency)
+	{
+		sampleToMapped.Print(std::cout, "Head pose to mapped latency");
+		updatePeriod.Print(std::cout, "Update() period");
+	}
+	if (!tracePath.empty())
+	{
+		std::string traceError;
+		if (WriteChromeTrace(tracePath.c_str(), 0.0, traceError))
+		{
+			std::cout << "Trace written to " << tracePath << std::endl;
+		}
+		else
+		{
+			std::cout << "No trace written: " << traceError << std::endl;
+		}
+	}
+
+	api->Shutdown();
+	return 0;
+}
@@ -0,0 +1,263 @@
+#include "ResponseCurve.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+float CurveDefinition::Evaluate(float degrees) const
+{
+	const float magnitude = std::abs(degrees);
+	if (Shape == CurveShape::Off || magnitude < Deadzone)
+	{
+		return 0.0f;
+	}
+
+	const float x = (std::min)(magnitude, Limit) - Deadzone;
+	const float range = Limit - Deadzone;
+	float shaped = 0.0f;
+	switch (Shape)
+	{
+	case CurveShape::Linear:
+		shaped = x;
+		break;
+
+	case CurveShape::PiecewiseLinear:
+		if (!Points.empty())
+		{
+			auto next = std::upper_bound(Points.begin(), Points.end(), x,
+				[](float value, const std::pair<float, float>& point) { return value < point.first; });
+			if (next == Points.begin())
+			{
+				shaped = Points.front().second;
+			}
+			else if (next == Points.end())
+			{
+				shaped = Points.back().second;
+			}
+			else
+			{
+				const auto& previous = *(next - 1);
+				const float t = (x - previous.first) / (next->first - previous.first);
+				shaped = previous.second + t * (next->second - previous.second);
+			}
+		}
+		break;
+
+	case CurveShape::SCurve:
+		if (range > 0.0f)
+		{
+			const float t = x / range;
+			const float rising = std::pow(t, Steepness);
+			const float falling = std::pow(1.0f - t, Steepness);
+			shaped = range * rising / (rising + falling);
+		}
+		break;
+
+	case CurveShape::Exponential:
+		shaped = Rate > 0.0f ? std::expm1(Rate * x) / Rate : x;
+		break;
+
+	case CurveShape::Off:
+		break;
+	}
+
+	const float value = shaped * Gain;
+	return degrees < 0.0f ? -value : value;
+}
+
+ResponseCurve::ResponseCurve(const CurveDefinition& definition)
+{
+	if (definition.Shape == CurveShape::Off || definition.Limit <= 0.0f || definition.TableSize < 2)
+	{
+		return;
+	}
+
+	m_table.resize(definition.TableSize);
+	m_limit = definition.Limit;
+	m_lastIndex = static_cast<float>(definition.TableSize - 1);
+	m_entriesPerDegree = m_lastIndex / definition.Limit;
+	for (int i = 0; i < definition.TableSize; i++)
+	{
+		m_table[i] = definition.Evaluate(i / m_entriesPerDegree);
+	}
+}
+
+static std::string Trim(const std::string& text)
+{
+	const size_t first = text.find_first_not_of(" \t\r");
+	if (first == std::string::npos)
+	{
+		return "";
+	}
+	const size_t last = text.find_last_not_of(" \t\r");
+	return text.substr(first, last - first + 1);
+}
+
+static bool ParseShape(const std::string& value, CurveShape& shape)
+{
+	static const std::pair<const char*, CurveShape> k_shapes[] = {
+		{ "off", CurveShape::Off },
+		{ "linear", CurveShape::Linear },
+		{ "points", CurveShape::PiecewiseLinear },
+		{ "scurve", CurveShape::SCurve },
+		{ "exponential", CurveShape::Exponential },
+	};
+	for (const auto& [name, candidate] : k_shapes)
+	{
+		if (value == name)
+		{
+			shape = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool ParsePoints(const std::string& value, std::vector<std::pair<float, float>>& points)
+{
+	points.clear();
+	std::istringstream entries{ value };
+	std::string entry;
+	while (std::getline(entries, entry, ','))
+	{
+		const size_t colon = entry.find(':');
+		if (colon == std::string::npos)
+		{
+			return false;
+		}
+		const float x = std::stof(entry.substr(0, colon));
+		const float y = std::stof(entry.substr(colon + 1));
+		if (!points.empty() && x <= points.back().first)
+		{
+			return false;
+		}
+		points.emplace_back(x, y);
+	}
+	return !points.empty();
+}
+
+static bool ParseCurveEntry(const std::string& key, const std::string& value, CurveDefinition& curve)
+{
+	try
+	{
+		if (key == "shape")
+		{
+			return ParseShape(value, curve.Shape);
+		}
+		if (key == "deadzone")
+		{
+			curve.Deadzone = std::stof(value);
+			return curve.Deadzone >= 0.0f;
+		}
+		if (key == "limit")
+		{
+			curve.Limit = std::stof(value);
+			return curve.Limit >= 0.0f;
+		}
+		if (key == "gain")
+		{
+			curve.Gain = std::stof(value);
+			return true;
+		}
+		if (key == "points")
+		{
+			return ParsePoints(value, curve.Points);
+		}
+		if (key == "steepness")
+		{
+			curve.Steepness = std::stof(value);
+			return curve.Steepness > 0.0f;
+		}
+		if (key == "rate")
+		{
+			curve.Rate = std::stof(value);
+			return true;
+		}
+		if (key == "table")
+		{
+			curve.TableSize = std::stoi(value);
+			return curve.TableSize >= 2 && curve.TableSize <= 1 << 20;
+		}
+	}
+	catch (const std::exception&)
+	{
+	}
+	return false;
+}
+
+bool ParseResponseProfile(std::istream& input, ResponseProfile& profile, std::string& error)
+{
+	profile = ResponseProfile{};
+	CurveDefinition* curve = nullptr;
+	bool inStrategy = false;
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(input, line))
+	{
+		lineNumber++;
+		line = Trim(line.substr(0, line.find('#')));
+		if (line.empty())
+		{
+			continue;
+		}
+
+		if (line.front() == '[' && line.back() == ']')
+		{
+			const std::string section = Trim(line.substr(1, line.size() - 2));
+			curve = section == "yaw" ? &profile.Yaw : section == "pitch" ? &profile.Pitch : nullptr;
+			inStrategy = section == "strategy";
+			if (curve == nullptr && !inStrategy)
+			{
+				error = "line " + std::to_string(lineNumber) + ": unknown section '" + section + "'";
+				return false;
+			}
+			if (curve != nullptr)
+			{
+				*curve = CurveDefinition{};
+				profile.HasCurves = true;
+			}
+			continue;
+		}
+
+		const size_t equals = line.find('=');
+		const std::string key = Trim(line.substr(0, equals));
+		const std::string value = equals == std::string::npos ? "" : Trim(line.substr(equals + 1));
+		const bool parsed = inStrategy ? ParseStrategyEntry(key, value, profile.Strategy) : curve != nullptr && ParseCurveEntry(key, value, *curve);
+		if (equals == std::string::npos || !parsed)
+		{
+			error = "line " + std::to_string(lineNumber) + ": bad entry '" + line + "'";
+			return false;
+		}
+	}
+
+	for (const CurveDefinition* axis : { &profile.Yaw, &profile.Pitch })
+	{
+		if (axis->Shape == CurveShape::PiecewiseLinear && axis->Points.empty())
+		{
+			error = "a points curve needs a points entry";
+			return false;
+		}
+		if (axis->Shape != CurveShape::Off && axis->Limit < axis->Deadzone)
+		{
+			error = "limit is smaller than the deadzone";
+			return false;
+		}
+	}
+	return true;
+}
+
+bool LoadResponseProfile(const char* path, ResponseProfile& profile, std::string& error)
+{
+	std::ifstream file{ path };
+	if (!file)
+	{
+		error = std::string{ "can't open " } + path;
+		return false;
+	}
+	if (!ParseResponseProfile(file, profile, error))
+	{
+		error = std::string{ path } + ", " + error;
+		return false;
+	}
+	return true;
+}
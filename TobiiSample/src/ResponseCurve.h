@@ -0,0 +1,102 @@
+#pragma once
+
+#include "StrategySettings.h"
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class CurveShape
+{
+	Off,				// always 0
+	Linear,				// deadzone, then Gain counts per degree up to Limit: the original MyNewMain mapping
+	PiecewiseLinear,	// through Points, held flat after the last one
+	SCurve,				// slow near the deadzone and near Limit, fast in between
+	Exponential			// (e^(Rate*x) - 1) / Rate, keeps growing towards Limit
+};
+
+// One axis: head angle in degrees -> absolute cursor offset in mouse counts, odd-symmetric.
+// Every shape works on x = min(|angle|, Limit) - Deadzone, is 0 inside the deadzone,
+// and is scaled by Gain.
+struct CurveDefinition
+{
+	CurveShape Shape = CurveShape::Linear;
+	float Deadzone = 0.0f;		// degrees
+	float Limit = 30.0f;		// degrees, larger angles give the same output
+	float Gain = 1.0f;			// counts per unit of shape output
+	std::vector<std::pair<float, float>> Points;	// PiecewiseLinear: (x, output) in increasing x, before Gain
+	float Steepness = 2.0f;		// SCurve: 1 is linear, larger is more S-shaped
+	float Rate = 0.1f;			// Exponential: growth per degree
+	int TableSize = 1024;		// lookup table entries over [0, Limit]
+
+	// Exact value of the curve, used to build the table.
+	float Evaluate(float degrees) const;
+};
+
+// A CurveDefinition sampled into a dense table at load time: Evaluate() is one lookup and a lerp
+// whatever the shape.
+class ResponseCurve
+{
+public:
+	ResponseCurve() = default;
+	explicit ResponseCurve(const CurveDefinition& definition);
+
+	float Evaluate(float degrees) const
+	{
+		if (m_table.size() < 2)
+		{
+			return 0.0f;
+		}
+		const float magnitude = degrees < 0.0f ? -degrees : degrees;
+		const float position = magnitude < m_limit ? magnitude * m_entriesPerDegree : m_lastIndex;
+		const int index = static_cast<int>(position);
+		const float value = index < static_cast<int>(m_lastIndex)
+			? m_table[index] + (m_table[index + 1] - m_table[index]) * (position - index)
+			: m_table.back();
+		return degrees < 0.0f ? -value : value;
+	}
+
+private:
+	std::vector<float> m_table;
+	float m_limit = 0.0f;
+	float m_entriesPerDegree = 0.0f;
+	float m_lastIndex = 0.0f;
+};
+
+// Per-axis curves for the head mouse, read from a profile file:
+//   # comment
+//   [yaw]
+//   shape = linear | points | scurve | exponential | off
+//   deadzone = 7.5
+//   limit = 29.2
+//   gain = 30
+//   points = 0:0, 5:40, 20:650        (points only)
+//   steepness = 2                     (scurve only)
+//   rate = 0.1                        (exponential only)
+//   table = 1024
+//   [pitch]
+//   ...
+//   [strategy]
+//   mode = absolute                   (see ParseStrategyEntry() for the rest)
+// An axis without a section is Off. A profile with neither axis keeps the SquadTuning.h mapping and
+// only picks the strategy; the curves apply to the absolute strategy only.
+struct ResponseProfile
+{
+	CurveDefinition Yaw{ CurveShape::Off };
+	CurveDefinition Pitch{ CurveShape::Off };
+	bool HasCurves = false;		// a [yaw] or [pitch] section was present
+	StrategySettings Strategy;
+};
+
+bool ParseResponseProfile(std::istream& input, ResponseProfile& profile, std::string& error);
+bool LoadResponseProfile(const char* path, ResponseProfile& profile, std::string& error);
+
+// What HeadMouseMapper evaluates per sample.
+struct ResponseCurves
+{
+	ResponseCurves() = default;
+	explicit ResponseCurves(const ResponseProfile& profile) : Yaw{ profile.Yaw }, Pitch{ profile.Pitch } { }
+
+	ResponseCurve Yaw;
+	ResponseCurve Pitch;
+};
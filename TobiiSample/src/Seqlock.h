@@ -0,0 +1,93 @@
+#pragma once
+
+#include "SpscRing.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer slot holding the latest value of a small trivially copyable T.
+// Store() never waits and never allocates, so it is safe in the hot loop; readers copy the value out
+// and retry if a Store() overlapped the copy. The value is kept in relaxed atomic words rather than a
+// plain T so the overlapping copy is not a data race.
+template <typename T>
+class Seqlock
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Seqlock values are copied bytewise");
+
+public:
+	// Writer thread only.
+	void Store(const T& value)
+	{
+		uint64_t words[k_wordCount] = {};
+		std::memcpy(words, &value, sizeof(T));
+
+		const uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+		m_sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (size_t i = 0; i < k_wordCount; i++)
+		{
+			m_words[i].store(words[i], std::memory_order_relaxed);
+		}
+		m_sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	// Any thread. Returns the (even) sequence number of the value read, 0 if nothing was stored yet.
+	uint32_t Load(T& value) const
+	{
+		uint64_t words[k_wordCount];
+		for (;;)
+		{
+			const uint32_t before = m_sequence.load(std::memory_order_acquire);
+			if (before & 1)
+			{
+				continue;
+			}
+			for (size_t i = 0; i < k_wordCount; i++)
+			{
+				words[i] = m_words[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (m_sequence.load(std::memory_order_relaxed) == before)
+			{
+				std::memcpy(&value, words, sizeof(T));
+				return before;
+			}
+		}
+	}
+
+	// Like Load(), but gives up after maxAttempts overlapping Store()s and returns 0. For readers in other
+	// processes, which must not hang if the writer died halfway through a Store().
+	uint32_t TryLoad(T& value, int maxAttempts) const
+	{
+		uint64_t words[k_wordCount];
+		for (int attempt = 0; attempt < maxAttempts; attempt++)
+		{
+			const uint32_t before = m_sequence.load(std::memory_order_acquire);
+			if (before & 1)
+			{
+				continue;
+			}
+			for (size_t i = 0; i < k_wordCount; i++)
+			{
+				words[i] = m_words[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (m_sequence.load(std::memory_order_relaxed) == before)
+			{
+				std::memcpy(&value, words, sizeof(T));
+				return before;
+			}
+		}
+		return 0;
+	}
+
+	// Changes with every Store(), lets readers skip values they have already seen.
+	uint32_t GetSequence() const { return m_sequence.load(std::memory_order_acquire); }
+
+private:
+	static constexpr size_t k_wordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+	alignas(k_cacheLineSize) std::atomic<uint32_t> m_sequence{ 0 };
+	std::atomic<uint64_t> m_words[k_wordCount];
+};
@@ -0,0 +1,389 @@
+#include "SessionAnalytics.h"
+#include "MappingEngine.h"
+#include "SessionArchive.h"
+#include "SessionRecording.h"
+#include "SyntheticApi.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+using namespace TobiiGameIntegration;
+
+static constexpr int k_mappingBatchSize = 64;	// as MyNewMain's mapping thread
+static constexpr int k_minRestWindowPoses = 8;
+static constexpr int k_minSpectrumPoses = 32;
+static constexpr double k_pi = 3.14159265358979323846;
+
+const char* GetAnalyticsAxisName(int axis)
+{
+	static const char* const k_names[k_analyticsAxisCount] = { "yaw", "pitch", "roll", "x", "y", "z" };
+	return axis >= 0 && axis < k_analyticsAxisCount ? k_names[axis] : "?";
+}
+
+static float GetAxis(const HeadPose& headPose, int axis)
+{
+	switch (axis)
+	{
+	case 0: return headPose.Rotation.YawDegrees;
+	case 1: return headPose.Rotation.PitchDegrees;
+	case 2: return headPose.Rotation.RollDegrees;
+	case 3: return headPose.Position.X;
+	case 4: return headPose.Position.Y;
+	default: return headPose.Position.Z;
+	}
+}
+
+void SessionAnalysis::Add(const SessionAnalysis& other)
+{
+	HeadPoses += other.HeadPoses;
+	Seconds += other.Seconds;
+	RestSeconds += other.RestSeconds;
+	RestHeadPoses += other.RestHeadPoses;
+	for (int axis = 0; axis < k_analyticsAxisCount; axis++)
+	{
+		RestSumSquares[axis] += other.RestSumSquares[axis];
+		for (int band = 0; band < k_noiseBandCount; band++)
+		{
+			BandPower[axis][band] += other.BandPower[axis][band];
+		}
+	}
+	SpectrumSegments += other.SpectrumSegments;
+	DeadYawSeconds += other.DeadYawSeconds;
+	DeadPitchSeconds += other.DeadPitchSeconds;
+	DeadBothSeconds += other.DeadBothSeconds;
+	SaturatedYawSeconds += other.SaturatedYawSeconds;
+	SaturatedPitchSeconds += other.SaturatedPitchSeconds;
+	MouseEvents += other.MouseEvents;
+	Counts += other.Counts;
+	RestMouseEvents += other.RestMouseEvents;
+	RestCounts += other.RestCounts;
+	AnalysisSeconds += other.AnalysisSeconds;
+}
+
+double SessionAnalysis::GetRestStdDev(int axis) const
+{
+	return RestHeadPoses > 0 ? std::sqrt(RestSumSquares[axis] / RestHeadPoses) : 0.0;
+}
+
+double SessionAnalysis::GetBandRms(int axis, int band) const
+{
+	return SpectrumSegments > 0 ? std::sqrt(BandPower[axis][band] / SpectrumSegments) : 0.0;
+}
+
+static bool LoadRecording(const std::string& path, std::vector<HeadPose>& headPoses, std::string& error)
+{
+	SessionReader reader;
+	if (!reader.Open(path.c_str()))
+	{
+		error = "can't read " + path + " as a session recording";
+		return false;
+	}
+	RecordedFrame frame;
+	while (reader.ReadFrame(frame))
+	{
+		headPoses.insert(headPoses.end(), frame.HeadPoses.begin(), frame.HeadPoses.end());
+	}
+	return true;
+}
+
+static bool LoadArchive(const std::string& path, std::vector<HeadPose>& headPoses, std::string& error)
+{
+	SessionArchiveReader reader;
+	if (!reader.Open(path.c_str(), error))
+	{
+		return false;
+	}
+	return reader.ReadHeadPoses(INT64_MIN, INT64_MAX, headPoses, error);
+}
+
+static bool LoadSynthetic(const std::string& spec, std::vector<HeadPose>& headPoses, std::string& error)
+{
+	SyntheticSettings settings;
+	const size_t colon = spec.find(':');
+	if (colon != std::string::npos && !ParseSyntheticSettings(spec.substr(colon + 1), settings, error))
+	{
+		return false;
+	}
+	// Without them the stream would follow the wall clock, or never end
+	if (settings.SamplesPerUpdate <= 0 || settings.DurationSeconds <= 0.0f)
+	{
+		error = spec + " needs fast= and duration=";
+		return false;
+	}
+	SyntheticApi* api = new SyntheticApi{ settings };
+	while (!api->IsFinished())
+	{
+		api->Update();
+		const HeadPose* poses = nullptr;
+		const int count = api->GetHeadPoses(poses);
+		headPoses.insert(headPoses.end(), poses, poses + count);
+	}
+	api->Shutdown();
+	return true;
+}
+
+bool LoadSessionHeadPoses(const std::string& source, std::vector<HeadPose>& headPoses, std::string& error)
+{
+	headPoses.clear();
+	if (source.rfind("synthetic", 0) == 0)
+	{
+		return LoadSynthetic(source, headPoses, error);
+	}
+	char magic[4] = {};
+	std::ifstream file{ source, std::ios::binary };
+	if (!file.read(magic, sizeof(magic)))
+	{
+		error = "can't read " + source;
+		return false;
+	}
+	file.close();
+	return std::memcmp(magic, "THSA", sizeof(magic)) == 0 ? LoadArchive(source, headPoses, error) : LoadRecording(source, headPoses, error);
+}
+
+// In place, radix 2, size a power of two
+static void Fft(std::vector<std::complex<double>>& values)
+{
+	const size_t size = values.size();
+	for (size_t i = 1, j = 0; i < size; i++)
+	{
+		size_t bit = size >> 1;
+		for (; j & bit; bit >>= 1)
+		{
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j)
+		{
+			std::swap(values[i], values[j]);
+		}
+	}
+	for (size_t length = 2; length <= size; length <<= 1)
+	{
+		const std::complex<double> step = std::polar(1.0, -2.0 * k_pi / static_cast<double>(length));
+		for (size_t first = 0; first < size; first += length)
+		{
+			std::complex<double> twiddle = 1.0;
+			for (size_t k = 0; k < length / 2; k++)
+			{
+				const std::complex<double> even = values[first + k];
+				const std::complex<double> odd = values[first + k + length / 2] * twiddle;
+				values[first + k] = even + odd;
+				values[first + k + length / 2] = even - odd;
+				twiddle *= step;
+			}
+		}
+	}
+}
+
+static int GetNoiseBand(double frequencyHz)
+{
+	int band = 0;
+	while (band < k_noiseBandCount - 1 && frequencyHz >= k_noiseBandEdgesHz[band])
+	{
+		band++;
+	}
+	return band;
+}
+
+// Welch's method over one rest stretch: half-overlapping segments, each with its linear trend removed
+// and a Hann window, their one-sided periodograms scaled so the bins add up to the segment's variance.
+static void AddNoiseSpectrum(const HeadPose* headPoses, size_t count, const AnalyticsSettings& settings, SessionAnalysis& analysis)
+{
+	if (count < 2)
+	{
+		return;
+	}
+	const double seconds = (headPoses[count - 1].TimeStampMicroSeconds - headPoses[0].TimeStampMicroSeconds) / 1e6;
+	const double rateHz = seconds > 0.0 ? (count - 1) / seconds : 0.0;
+	size_t size = 1;
+	while (size * 2 <= rateHz * settings.SpectrumSeconds)
+	{
+		size *= 2;
+	}
+	if (size < k_minSpectrumPoses || size > count)
+	{
+		return;
+	}
+
+	std::vector<double> window(size);
+	double windowSquares = 0.0;
+	for (size_t i = 0; i < size; i++)
+	{
+		window[i] = 0.5 - 0.5 * std::cos(2.0 * k_pi * i / (size - 1));
+		windowSquares += window[i] * window[i];
+	}
+	const double scale = 1.0 / (static_cast<double>(size) * windowSquares);
+	std::vector<std::complex<double>> values(size);
+	for (size_t first = 0; first + size <= count; first += size / 2)
+	{
+		const HeadPose* segment = headPoses + first;
+		const double segmentSeconds = (segment[size - 1].TimeStampMicroSeconds - segment[0].TimeStampMicroSeconds) / 1e6;
+		const double binHz = segmentSeconds > 0.0 ? (size - 1) / segmentSeconds / size : 0.0;
+		for (int axis = 0; axis < k_analyticsAxisCount; axis++)
+		{
+			// Least squares line over the sample index
+			double sumY = 0.0, sumXY = 0.0;
+			for (size_t i = 0; i < size; i++)
+			{
+				sumY += GetAxis(segment[i], axis);
+				sumXY += (i - (size - 1) * 0.5) * GetAxis(segment[i], axis);
+			}
+			const double mean = sumY / size;
+			const double slope = sumXY / (static_cast<double>(size) * (static_cast<double>(size) * size - 1) / 12.0);
+			for (size_t i = 0; i < size; i++)
+			{
+				values[i] = (GetAxis(segment[i], axis) - mean - slope * (i - (size - 1) * 0.5)) * window[i];
+			}
+			Fft(values);
+			for (size_t bin = 1; bin <= size / 2; bin++)
+			{
+				const double power = std::norm(values[bin]) * scale * (bin == size / 2 ? 1.0 : 2.0);
+				analysis.BandPower[axis][GetNoiseBand(bin * binHz)] += power;
+			}
+		}
+		analysis.SpectrumSegments++;
+	}
+}
+
+struct RestWindow
+{
+	size_t First;
+	size_t End;
+	double MeanYaw;
+	double MeanPitch;
+};
+
+void FindRestHeadPoses(const std::vector<HeadPose>& headPoses, const AnalyticsSettings& settings, std::vector<uint8_t>& isAtRest,
+	SessionAnalysis& analysis)
+{
+	const int64_t windowMicroSeconds = static_cast<int64_t>(settings.RestWindowSeconds * 1e6);
+	isAtRest.assign(headPoses.size(), 0);
+	std::vector<RestWindow> windows;
+	size_t first = 0;
+	while (first < headPoses.size())
+	{
+		size_t end = first + 1;
+		float minYaw = headPoses[first].Rotation.YawDegrees, maxYaw = minYaw;
+		float minPitch = headPoses[first].Rotation.PitchDegrees, maxPitch = minPitch;
+		while (end < headPoses.size() && headPoses[end].TimeStampMicroSeconds - headPoses[first].TimeStampMicroSeconds < windowMicroSeconds &&
+			headPoses[end].TimeStampMicroSeconds - headPoses[end - 1].TimeStampMicroSeconds <= HeadPoseFilter::k_maxGapMicroSeconds)
+		{
+			minYaw = (std::min)(minYaw, headPoses[end].Rotation.YawDegrees);
+			maxYaw = (std::max)(maxYaw, headPoses[end].Rotation.YawDegrees);
+			minPitch = (std::min)(minPitch, headPoses[end].Rotation.PitchDegrees);
+			maxPitch = (std::max)(maxPitch, headPoses[end].Rotation.PitchDegrees);
+			end++;
+		}
+		if (end - first >= k_minRestWindowPoses && maxYaw - minYaw <= settings.RestRangeDegrees && maxPitch - minPitch <= settings.RestRangeDegrees)
+		{
+			std::fill(isAtRest.begin() + first, isAtRest.begin() + end, 1);
+			double means[k_analyticsAxisCount];
+			for (int axis = 0; axis < k_analyticsAxisCount; axis++)
+			{
+				double sum = 0.0;
+				for (size_t i = first; i < end; i++)
+				{
+					sum += GetAxis(headPoses[i], axis);
+				}
+				means[axis] = sum / (end - first);
+				for (size_t i = first; i < end; i++)
+				{
+					const double deviation = GetAxis(headPoses[i], axis) - means[axis];
+					analysis.RestSumSquares[axis] += deviation * deviation;
+				}
+			}
+			analysis.RestHeadPoses += end - first;
+			windows.push_back({ first, end, means[0], means[1] });
+		}
+		first = end;
+	}
+
+	// The spectrum runs over stretches of back-to-back rest windows. A window that moved away from the
+	// previous one (the head turned quickly between them) starts a new stretch, or the turn would show
+	// up as low frequency noise.
+	for (size_t w = 0; w < windows.size();)
+	{
+		size_t last = w;
+		while (last + 1 < windows.size() && windows[last + 1].First == windows[last].End &&
+			std::abs(windows[last + 1].MeanYaw - windows[last].MeanYaw) <= settings.RestRangeDegrees &&
+			std::abs(windows[last + 1].MeanPitch - windows[last].MeanPitch) <= settings.RestRangeDegrees &&
+			headPoses[windows[last + 1].First].TimeStampMicroSeconds - headPoses[windows[last].End - 1].TimeStampMicroSeconds <= HeadPoseFilter::k_maxGapMicroSeconds)
+		{
+			last++;
+		}
+		AddNoiseSpectrum(&headPoses[windows[w].First], windows[last].End - windows[w].First, settings, analysis);
+		w = last + 1;
+	}
+}
+
+SessionAnalysis AnalyzeHeadPoses(const std::vector<HeadPose>& headPoses, const AnalyticsSettings& settings, const StrategySettings& strategy,
+	const MappingSettings& mappingSettings, const ResponseCurves* curves, const HeadPoseFilter& filter)
+{
+	SessionAnalysis analysis;
+	analysis.HeadPoses = headPoses.size();
+	if (headPoses.empty())
+	{
+		return analysis;
+	}
+
+	std::vector<uint8_t> isAtRest;
+	FindRestHeadPoses(headPoses, settings, isAtRest, analysis);
+
+	// What the mapping thread would get
+	std::vector<HeadPose> mappedPoses = headPoses;
+	HeadPoseFilter mappingFilter = filter;
+	mappingFilter.Reset();
+	for (size_t first = 0; mappingFilter.IsEnabled() && first < mappedPoses.size(); first += k_mappingBatchSize)
+	{
+		mappingFilter.FilterHeadPoses(&mappedPoses[first], static_cast<int>((std::min)(mappedPoses.size() - first, static_cast<size_t>(k_mappingBatchSize))));
+	}
+
+	// Pitch is only clamped when it is mapped at all
+	const bool mapsPitch = mappingSettings.YSensMult != 0.0f && mappingSettings.MaxPitchIRL > 0.0f;
+	for (size_t i = 0; i < mappedPoses.size(); i++)
+	{
+		const int64_t interval = i + 1 < mappedPoses.size() ? mappedPoses[i + 1].TimeStampMicroSeconds - mappedPoses[i].TimeStampMicroSeconds : 0;
+		const double seconds = interval > 0 && interval <= HeadPoseFilter::k_maxGapMicroSeconds ? interval / 1e6 : 0.0;
+		const float yaw = std::abs(mappedPoses[i].Rotation.YawDegrees * mappingSettings.HeadPoseYawScale);
+		const float pitch = std::abs(mappedPoses[i].Rotation.PitchDegrees * mappingSettings.HeadPosePitchScale);
+		// Same comparisons as HeadMouseMapper::DesiredCounts()
+		const bool isDeadYaw = yaw < mappingSettings.DeadYawIRL;
+		const bool isDeadPitch = pitch < mappingSettings.DeadPitchIRL;
+		analysis.Seconds += seconds;
+		analysis.RestSeconds += isAtRest[i] ? seconds : 0.0;
+		analysis.DeadYawSeconds += isDeadYaw ? seconds : 0.0;
+		analysis.DeadPitchSeconds += isDeadPitch ? seconds : 0.0;
+		analysis.DeadBothSeconds += isDeadYaw && isDeadPitch ? seconds : 0.0;
+		analysis.SaturatedYawSeconds += yaw > mappingSettings.MaxYawIRL ? seconds : 0.0;
+		analysis.SaturatedPitchSeconds += mapsPitch && pitch > mappingSettings.MaxPitchIRL ? seconds : 0.0;
+	}
+
+	std::unique_ptr<MappingEngine> engine = CreateMappingEngine(strategy, mappingSettings);
+	engine->SetCurves(curves);
+	engine->ResyncHeadPose(mappedPoses[0]);
+	MouseDelta deltas[k_mappingBatchSize];
+	for (size_t first = 0; first < mappedPoses.size(); first += k_mappingBatchSize)
+	{
+		const int count = static_cast<int>((std::min)(mappedPoses.size() - first, static_cast<size_t>(k_mappingBatchSize)));
+		const int deltaCount = engine->MapHeadPoses(&mappedPoses[first], count, deltas);
+		// Deltas carry the timestamp of the pose that produced them, in order
+		size_t pose = first;
+		for (int i = 0; i < deltaCount; i++)
+		{
+			while (pose + 1 < first + count && mappedPoses[pose].TimeStampMicroSeconds < deltas[i].TimeStampMicroSeconds)
+			{
+				pose++;
+			}
+			const uint64_t counts = std::abs(deltas[i].Dx) + std::abs(deltas[i].MinusDy);
+			analysis.MouseEvents++;
+			analysis.Counts += counts;
+			analysis.RestMouseEvents += isAtRest[pose];
+			analysis.RestCounts += isAtRest[pose] ? counts : 0;
+		}
+	}
+	return analysis;
+}
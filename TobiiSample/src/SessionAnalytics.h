@@ -0,0 +1,80 @@
+#pragma once
+
+#include "HeadMouseMapping.h"
+#include "HeadPoseFilter.h"
+#include "StrategySettings.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Offline numbers for tuning the mapping: how noisy the tracker is while the head is still, how much of
+// a session sits inside the deadzone or against the clamp, and what the mapping emits for it, at rest
+// and overall. Sessions are analyzed independently (one per thread in AnalyticsMain.cpp) and the results
+// summed with SessionAnalysis::Add().
+
+struct AnalyticsSettings
+{
+	// The head is at rest in a window of this length when yaw and pitch each stay within the range.
+	// Raw HeadPose degrees, before any filter or HeadPose scale.
+	float RestWindowSeconds = 0.5f;
+	float RestRangeDegrees = 1.0f;
+	// Length of the noise spectrum segments, rounded down to a power of two samples at the session's
+	// rate. Only rest stretches at least this long contribute to the spectrum.
+	float SpectrumSeconds = 2.0f;
+};
+
+static constexpr int k_analyticsAxisCount = 6;	// yaw, pitch, roll, x, y, z as in HeadPoseFilter
+static constexpr int k_noiseBandCount = 6;
+// Upper edges of the noise spectrum bands, the last band goes up to half the sample rate
+static constexpr float k_noiseBandEdgesHz[k_noiseBandCount - 1] = { 1.0f, 2.0f, 5.0f, 10.0f, 20.0f };
+
+const char* GetAnalyticsAxisName(int axis);
+
+struct SessionAnalysis
+{
+	uint64_t HeadPoses = 0;
+	double Seconds = 0.0;		// covered by poses, gaps longer than HeadPoseFilter::k_maxGapMicroSeconds left out
+
+	// Noise, on the raw poses. Deviations are from the mean of each rest window.
+	double RestSeconds = 0.0;
+	uint64_t RestHeadPoses = 0;
+	double RestSumSquares[k_analyticsAxisCount] = {};
+	// Variance per band summed over the segments, the bands of one segment add up to its variance
+	double BandPower[k_analyticsAxisCount][k_noiseBandCount] = {};
+	uint64_t SpectrumSegments = 0;
+
+	// Where the mapped angles (after the filter and the HeadPose scales) sit against MappingSettings
+	double DeadYawSeconds = 0.0;
+	double DeadPitchSeconds = 0.0;
+	double DeadBothSeconds = 0.0;
+	double SaturatedYawSeconds = 0.0;
+	double SaturatedPitchSeconds = 0.0;
+
+	// What the mapping emits, and the part of it emitted while the head is at rest
+	uint64_t MouseEvents = 0;
+	uint64_t Counts = 0;		// sum of |dx| + |dy|
+	uint64_t RestMouseEvents = 0;
+	uint64_t RestCounts = 0;
+
+	double AnalysisSeconds = 0.0;	// spent loading and analyzing, wall clock
+
+	void Add(const SessionAnalysis& other);
+	// Degrees for the angles, millimeters for the position, 0 without rest
+	double GetRestStdDev(int axis) const;
+	double GetBandRms(int axis, int band) const;
+};
+
+// Reads every head pose of a session recording (SessionRecording.h), a session archive (SessionArchive.h,
+// told apart by its header) or a finite synthetic stream ("synthetic:<settings>" with fast= and duration=).
+bool LoadSessionHeadPoses(const std::string& source, std::vector<TobiiGameIntegration::HeadPose>& headPoses, std::string& error);
+
+// Marks the poses that belong to rest windows in isAtRest (one entry per pose) and adds the noise figures
+// of those windows to analysis.
+void FindRestHeadPoses(const std::vector<TobiiGameIntegration::HeadPose>& headPoses, const AnalyticsSettings& settings,
+	std::vector<uint8_t>& isAtRest, SessionAnalysis& analysis);
+
+// Runs the analysis over one session. The filter is copied, so one parsed chain can serve every thread;
+// the curves are only read. The mapping starts resynced on the first pose and maps in MyNewMain-sized
+// batches; the hold strategy's key is never held.
+SessionAnalysis AnalyzeHeadPoses(const std::vector<TobiiGameIntegration::HeadPose>& headPoses, const AnalyticsSettings& settings,
+	const StrategySettings& strategy, const MappingSettings& mappingSettings, const ResponseCurves* curves, const HeadPoseFilter& filter);
@@ -0,0 +1,635 @@
+#include "SessionArchive.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if SESSION_ARCHIVE_ZLIB
+#include <zlib.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "zlib.lib")
+#endif
+#endif
+
+#ifdef _WIN32
+#include "windows.h"
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace TobiiGameIntegration;
+
+static constexpr char k_archiveMagic[4] = { 'T', 'H', 'S', 'A' };
+static constexpr char k_indexMagic[4] = { 'T', 'H', 'S', 'I' };
+static constexpr uint32_t k_archiveVersion = 1;
+static constexpr size_t k_headerBytes = 4 + 4 + 3 * 8;
+static constexpr size_t k_blockHeaderBytes = 1 + 1 + 2 + 4 + 8 + 8 + 4 + 4;
+static constexpr size_t k_indexEntryBytes = k_blockHeaderBytes + 8;
+static constexpr size_t k_indexTrailerBytes = 8 + 4 + 4;
+// What SessionRecorder writes per sample: the timestamp and the floats
+static constexpr uint64_t k_rawHeadPoseBytes = 8 + 6 * 4;
+static constexpr uint64_t k_rawGazePointBytes = 8 + 2 * 4;
+static constexpr uint64_t k_headPoseColumns = 7;
+static constexpr uint64_t k_gazePointColumns = 3;
+static constexpr uint64_t k_maxVarintBytes = 10;
+static constexpr uint64_t k_maxDeflateRatio = 1032;	// zlib's limit for inflated/deflated size
+
+template <typename T>
+static void Write(std::ofstream& file, T value)
+{
+	file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static T Load(const uint8_t* data)
+{
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+static uint64_t ZigZag(int64_t value)
+{
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t UnZigZag(uint64_t value)
+{
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static int64_t Quantize(float value, double quantum)
+{
+	return std::llround(static_cast<double>(value) / quantum);
+}
+
+static void PutVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+// Returns nullptr if the varint runs past end.
+static const uint8_t* GetVarint(const uint8_t* data, const uint8_t* end, uint64_t& value)
+{
+	// Deltas of samples at tracker rates mostly fit in one byte
+	if (data < end && *data < 0x80)
+	{
+		value = *data;
+		return data + 1;
+	}
+	uint64_t result = 0;
+	for (int shift = 0; data < end && shift < 64; shift += 7)
+	{
+		const uint8_t byte = *data++;
+		result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		if (byte < 0x80)
+		{
+			value = result;
+			return data;
+		}
+	}
+	return nullptr;
+}
+
+// One column: the first value as a delta from 0, then the deltas between successive values.
+template <typename Sample, typename GetValue>
+static void PutDeltaColumn(std::vector<uint8_t>& out, const std::vector<Sample>& samples, GetValue getValue)
+{
+	int64_t previous = 0;
+	for (const Sample& sample : samples)
+	{
+		const int64_t value = getValue(sample);
+		PutVarint(out, ZigZag(value - previous));
+		previous = value;
+	}
+}
+
+template <typename Sample, typename SetValue>
+static const uint8_t* GetDeltaColumn(const uint8_t* data, const uint8_t* end, std::vector<Sample>& samples, SetValue setValue)
+{
+	int64_t value = 0;
+	for (Sample& sample : samples)
+	{
+		uint64_t coded;
+		data = GetVarint(data, end, coded);
+		if (data == nullptr)
+		{
+			return nullptr;
+		}
+		value += UnZigZag(coded);
+		setValue(sample, value);
+	}
+	return data;
+}
+
+SessionArchiveWriter::~SessionArchiveWriter()
+{
+	if (IsOpen())
+	{
+		Close();
+	}
+}
+
+bool SessionArchiveWriter::Open(const char* path, const ArchiveSettings& settings, std::string& error)
+{
+	m_file.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_file)
+	{
+		error = std::string{ "Can't create " } + path;
+		return false;
+	}
+	m_settings = settings;
+	m_settings.SamplesPerBlock = (std::max)(m_settings.SamplesPerBlock, 1);
+#if !SESSION_ARCHIVE_ZLIB
+	m_settings.Deflate = false;
+#endif
+	m_headPoses.clear();
+	m_gazePoints.clear();
+	m_index.clear();
+	m_sampleCount = 0;
+	m_rawBytes = 0;
+
+	m_file.write(k_archiveMagic, sizeof(k_archiveMagic));
+	Write(m_file, k_archiveVersion);
+	Write(m_file, m_settings.AngleQuantumDegrees);
+	Write(m_file, m_settings.PositionQuantumMM);
+	Write(m_file, m_settings.GazeQuantum);
+	m_offset = k_headerBytes;
+	return static_cast<bool>(m_file);
+}
+
+bool SessionArchiveWriter::Close()
+{
+	FlushHeadPoses();
+	FlushGazePoints();
+
+	const uint64_t indexOffset = m_offset;
+	for (const ArchiveBlockInfo& block : m_index)
+	{
+		Write(m_file, static_cast<uint8_t>(block.Stream));
+		Write(m_file, static_cast<uint8_t>(block.Codec));
+		Write(m_file, uint16_t{ 0 });
+		Write(m_file, block.SampleCount);
+		Write(m_file, block.FirstMicroSeconds);
+		Write(m_file, block.LastMicroSeconds);
+		Write(m_file, block.StoredBytes);
+		Write(m_file, block.ColumnBytes);
+		Write(m_file, block.Offset);
+	}
+	Write(m_file, indexOffset);
+	Write(m_file, static_cast<uint32_t>(m_index.size()));
+	m_file.write(k_indexMagic, sizeof(k_indexMagic));
+	m_offset += m_index.size() * k_indexEntryBytes + k_indexTrailerBytes;
+
+	const bool ok = static_cast<bool>(m_file);
+	m_file.close();
+	return ok;
+}
+
+void SessionArchiveWriter::AddHeadPoses(const HeadPose* headPoses, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		m_headPoses.push_back(headPoses[i]);
+		if (static_cast<int>(m_headPoses.size()) >= m_settings.SamplesPerBlock)
+		{
+			FlushHeadPoses();
+		}
+	}
+	m_sampleCount += (std::max)(count, 0);
+	m_rawBytes += (std::max)(count, 0) * k_rawHeadPoseBytes;
+}
+
+void SessionArchiveWriter::AddGazePoints(const GazePoint* gazePoints, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		m_gazePoints.push_back(gazePoints[i]);
+		if (static_cast<int>(m_gazePoints.size()) >= m_settings.SamplesPerBlock)
+		{
+			FlushGazePoints();
+		}
+	}
+	m_sampleCount += (std::max)(count, 0);
+	m_rawBytes += (std::max)(count, 0) * k_rawGazePointBytes;
+}
+
+void SessionArchiveWriter::FlushHeadPoses()
+{
+	if (m_headPoses.empty())
+	{
+		return;
+	}
+	const double angle = m_settings.AngleQuantumDegrees;
+	const double position = m_settings.PositionQuantumMM;
+	m_columns.clear();
+	PutDeltaColumn(m_columns, m_headPoses, [](const HeadPose& pose) { return pose.TimeStampMicroSeconds; });
+	PutDeltaColumn(m_columns, m_headPoses, [angle](const HeadPose& pose) { return Quantize(pose.Rotation.YawDegrees, angle); });
+	PutDeltaColumn(m_columns, m_headPoses, [angle](const HeadPose& pose) { return Quantize(pose.Rotation.PitchDegrees, angle); });
+	PutDeltaColumn(m_columns, m_headPoses, [angle](const HeadPose& pose) { return Quantize(pose.Rotation.RollDegrees, angle); });
+	PutDeltaColumn(m_columns, m_headPoses, [position](const HeadPose& pose) { return Quantize(pose.Position.X, position); });
+	PutDeltaColumn(m_columns, m_headPoses, [position](const HeadPose& pose) { return Quantize(pose.Position.Y, position); });
+	PutDeltaColumn(m_columns, m_headPoses, [position](const HeadPose& pose) { return Quantize(pose.Position.Z, position); });
+
+	const auto [first, last] = std::minmax_element(m_headPoses.begin(), m_headPoses.end(),
+		[](const HeadPose& a, const HeadPose& b) { return a.TimeStampMicroSeconds < b.TimeStampMicroSeconds; });
+	WriteBlock(ArchiveStream::HeadPoses, static_cast<uint32_t>(m_headPoses.size()), first->TimeStampMicroSeconds, last->TimeStampMicroSeconds);
+	m_headPoses.clear();
+}
+
+void SessionArchiveWriter::FlushGazePoints()
+{
+	if (m_gazePoints.empty())
+	{
+		return;
+	}
+	const double gaze = m_settings.GazeQuantum;
+	m_columns.clear();
+	PutDeltaColumn(m_columns, m_gazePoints, [](const GazePoint& point) { return point.TimeStampMicroSeconds; });
+	PutDeltaColumn(m_columns, m_gazePoints, [gaze](const GazePoint& point) { return Quantize(point.X, gaze); });
+	PutDeltaColumn(m_columns, m_gazePoints, [gaze](const GazePoint& point) { return Quantize(point.Y, gaze); });
+
+	const auto [first, last] = std::minmax_element(m_gazePoints.begin(), m_gazePoints.end(),
+		[](const GazePoint& a, const GazePoint& b) { return a.TimeStampMicroSeconds < b.TimeStampMicroSeconds; });
+	WriteBlock(ArchiveStream::GazePoints, static_cast<uint32_t>(m_gazePoints.size()), first->TimeStampMicroSeconds, last->TimeStampMicroSeconds);
+	m_gazePoints.clear();
+}
+
+void SessionArchiveWriter::WriteBlock(ArchiveStream stream, uint32_t sampleCount, int64_t firstMicroSeconds, int64_t lastMicroSeconds)
+{
+	ArchiveBlockInfo block;
+	block.Stream = stream;
+	block.SampleCount = sampleCount;
+	block.FirstMicroSeconds = firstMicroSeconds;
+	block.LastMicroSeconds = lastMicroSeconds;
+	block.ColumnBytes = static_cast<uint32_t>(m_columns.size());
+	block.StoredBytes = block.ColumnBytes;
+	const uint8_t* stored = m_columns.data();
+#if SESSION_ARCHIVE_ZLIB
+	if (m_settings.Deflate)
+	{
+		uLongf deflatedBytes = compressBound(static_cast<uLong>(m_columns.size()));
+		m_deflated.resize(deflatedBytes);
+		// Kept only if it saves something, small blocks of noisy samples may not shrink
+		if (compress2(m_deflated.data(), &deflatedBytes, m_columns.data(), static_cast<uLong>(m_columns.size()), Z_DEFAULT_COMPRESSION) == Z_OK &&
+			deflatedBytes < m_columns.size())
+		{
+			block.Codec = ArchiveCodec::DeflatedColumns;
+			block.StoredBytes = static_cast<uint32_t>(deflatedBytes);
+			stored = m_deflated.data();
+		}
+	}
+#endif
+	block.Offset = m_offset + k_blockHeaderBytes;
+
+	Write(m_file, static_cast<uint8_t>(block.Stream));
+	Write(m_file, static_cast<uint8_t>(block.Codec));
+	Write(m_file, uint16_t{ 0 });
+	Write(m_file, block.SampleCount);
+	Write(m_file, block.FirstMicroSeconds);
+	Write(m_file, block.LastMicroSeconds);
+	Write(m_file, block.StoredBytes);
+	Write(m_file, block.ColumnBytes);
+	m_file.write(reinterpret_cast<const char*>(stored), block.StoredBytes);
+	// A crash mid-session still leaves every finished block readable
+	m_file.flush();
+
+	m_offset += k_blockHeaderBytes + block.StoredBytes;
+	m_index.push_back(block);
+}
+
+#ifdef _WIN32
+MappedFile::~MappedFile()
+{
+	if (m_data != nullptr)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mappingHandle != nullptr)
+	{
+		CloseHandle(m_mappingHandle);
+	}
+	if (m_fileHandle != nullptr && m_fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_fileHandle);
+	}
+}
+
+bool MappedFile::Open(const char* path, std::string& error)
+{
+	m_fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	LARGE_INTEGER size;
+	if (m_fileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_fileHandle, &size))
+	{
+		error = std::string{ "Can't open " } + path + ", error " + std::to_string(GetLastError());
+		return false;
+	}
+	m_size = static_cast<size_t>(size.QuadPart);
+	if (m_size == 0)
+	{
+		return true;
+	}
+	m_mappingHandle = CreateFileMappingW(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	m_data = m_mappingHandle != nullptr ? static_cast<const uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+	if (m_data == nullptr)
+	{
+		error = std::string{ "Can't map " } + path + ", error " + std::to_string(GetLastError());
+		return false;
+	}
+	return true;
+}
+#else
+MappedFile::~MappedFile()
+{
+	if (m_data != nullptr)
+	{
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+	}
+}
+
+bool MappedFile::Open(const char* path, std::string& error)
+{
+	const int fd = open(path, O_RDONLY);
+	struct stat status;
+	if (fd < 0 || fstat(fd, &status) != 0)
+	{
+		error = std::string{ "Can't open " } + path + ": " + std::strerror(errno);
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return false;
+	}
+	m_size = static_cast<size_t>(status.st_size);
+	void* address = m_size > 0 ? mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+	close(fd);
+	if (address == MAP_FAILED)
+	{
+		error = std::string{ "Can't map " } + path + ": " + std::strerror(errno);
+		m_size = 0;
+		return false;
+	}
+	m_data = static_cast<const uint8_t*>(address);
+	return true;
+}
+#endif
+
+static bool ParseBlockHeader(const uint8_t* data, ArchiveBlockInfo& block)
+{
+	const uint8_t stream = data[0];
+	const uint8_t codec = data[1];
+	if (stream > static_cast<uint8_t>(ArchiveStream::GazePoints) || codec > static_cast<uint8_t>(ArchiveCodec::DeflatedColumns))
+	{
+		return false;
+	}
+	block.Stream = static_cast<ArchiveStream>(stream);
+	block.Codec = static_cast<ArchiveCodec>(codec);
+	block.SampleCount = Load<uint32_t>(data + 4);
+	block.FirstMicroSeconds = Load<int64_t>(data + 8);
+	block.LastMicroSeconds = Load<int64_t>(data + 16);
+	block.StoredBytes = Load<uint32_t>(data + 24);
+	block.ColumnBytes = Load<uint32_t>(data + 28);
+	return block.Codec != ArchiveCodec::Columns || block.StoredBytes == block.ColumnBytes;
+}
+
+bool SessionArchiveReader::Open(const char* path, std::string& error)
+{
+	m_blocks.clear();
+	if (!m_file.Open(path, error))
+	{
+		return false;
+	}
+	const uint8_t* data = m_file.GetData();
+	if (m_file.GetSize() < k_headerBytes || std::memcmp(data, k_archiveMagic, sizeof(k_archiveMagic)) != 0 ||
+		Load<uint32_t>(data + 4) != k_archiveVersion)
+	{
+		error = std::string{ path } + " is not a session archive";
+		return false;
+	}
+	m_settings.AngleQuantumDegrees = Load<double>(data + 8);
+	m_settings.PositionQuantumMM = Load<double>(data + 16);
+	m_settings.GazeQuantum = Load<double>(data + 24);
+
+	m_hasIndex = ReadIndex();
+	if (!m_hasIndex)
+	{
+		ScanBlocks();
+	}
+	for (std::vector<uint32_t>& streamBlocks : m_streamBlocks)
+	{
+		streamBlocks.clear();
+	}
+	for (uint32_t i = 0; i < m_blocks.size(); i++)
+	{
+		m_streamBlocks[static_cast<int>(m_blocks[i].Stream)].push_back(i);
+	}
+	for (std::vector<uint32_t>& streamBlocks : m_streamBlocks)
+	{
+		std::stable_sort(streamBlocks.begin(), streamBlocks.end(),
+			[this](uint32_t a, uint32_t b) { return m_blocks[a].FirstMicroSeconds < m_blocks[b].FirstMicroSeconds; });
+	}
+	return true;
+}
+
+bool SessionArchiveReader::ReadIndex()
+{
+	const uint8_t* data = m_file.GetData();
+	const size_t size = m_file.GetSize();
+	if (size < k_headerBytes + k_indexTrailerBytes || std::memcmp(data + size - 4, k_indexMagic, sizeof(k_indexMagic)) != 0)
+	{
+		return false;
+	}
+	const uint64_t indexOffset = Load<uint64_t>(data + size - k_indexTrailerBytes);
+	const uint32_t blockCount = Load<uint32_t>(data + size - 8);
+	if (indexOffset < k_headerBytes || indexOffset + uint64_t{ blockCount } * k_indexEntryBytes + k_indexTrailerBytes != size)
+	{
+		return false;
+	}
+	m_blocks.resize(blockCount);
+	for (uint32_t i = 0; i < blockCount; i++)
+	{
+		const uint8_t* entry = data + indexOffset + i * k_indexEntryBytes;
+		ArchiveBlockInfo& block = m_blocks[i];
+		block.Offset = Load<uint64_t>(entry + k_blockHeaderBytes);
+		// Offset comes from the file too: no wrap-around past indexOffset, and room for the block header before it
+		if (!ParseBlockHeader(entry, block) || block.Offset < k_headerBytes + k_blockHeaderBytes || block.Offset > indexOffset ||
+			block.StoredBytes > indexOffset - block.Offset)
+		{
+			m_blocks.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+void SessionArchiveReader::ScanBlocks()
+{
+	const uint8_t* data = m_file.GetData();
+	const size_t size = m_file.GetSize();
+	uint64_t offset = k_headerBytes;
+	ArchiveBlockInfo block;
+	// Stops at the first block that is cut off or doesn't parse, like the one being written at a crash
+	while (offset + k_blockHeaderBytes <= size && ParseBlockHeader(data + offset, block) &&
+		offset + k_blockHeaderBytes + block.StoredBytes <= size)
+	{
+		block.Offset = offset + k_blockHeaderBytes;
+		m_blocks.push_back(block);
+		offset = block.Offset + block.StoredBytes;
+	}
+}
+
+const uint8_t* SessionArchiveReader::GetColumns(const ArchiveBlockInfo& block, std::string& error)
+{
+	const uint8_t* stored = m_file.GetData() + block.Offset;
+	if (block.Codec == ArchiveCodec::Columns)
+	{
+		return stored;
+	}
+#if SESSION_ARCHIVE_ZLIB
+	m_inflated.resize(block.ColumnBytes);
+	uLongf inflatedBytes = block.ColumnBytes;
+	if (uncompress(m_inflated.data(), &inflatedBytes, stored, block.StoredBytes) != Z_OK || inflatedBytes != block.ColumnBytes)
+	{
+		error = "Corrupt deflated block at offset " + std::to_string(block.Offset);
+		return nullptr;
+	}
+	return m_inflated.data();
+#else
+	error = "The archive has deflated blocks, build with SESSION_ARCHIVE_ZLIB 1 to read it";
+	return nullptr;
+#endif
+}
+
+// The sizes come from the file; checked before anything is allocated for them. Every sample takes
+// 1 to k_maxVarintBytes in each column, and deflate can't expand more than k_maxDeflateRatio.
+static bool HasPlausibleSizes(const ArchiveBlockInfo& block, uint64_t columns)
+{
+	const uint64_t minColumnBytes = uint64_t{ block.SampleCount } * columns;
+	return block.ColumnBytes >= minColumnBytes && block.ColumnBytes <= minColumnBytes * k_maxVarintBytes &&
+		(block.Codec != ArchiveCodec::DeflatedColumns || block.ColumnBytes <= uint64_t{ block.StoredBytes } * k_maxDeflateRatio);
+}
+
+bool SessionArchiveReader::DecodeHeadPoses(const ArchiveBlockInfo& block, std::vector<HeadPose>& headPoses, std::string& error)
+{
+	if (!HasPlausibleSizes(block, k_headPoseColumns))
+	{
+		error = "Corrupt head pose block at offset " + std::to_string(block.Offset);
+		headPoses.clear();
+		return false;
+	}
+	const uint8_t* data = GetColumns(block, error);
+	if (data == nullptr)
+	{
+		return false;
+	}
+	const uint8_t* end = data + block.ColumnBytes;
+	const double angle = m_settings.AngleQuantumDegrees;
+	const double position = m_settings.PositionQuantumMM;
+	headPoses.resize(block.SampleCount);
+	data = GetDeltaColumn(data, end, headPoses, [](HeadPose& pose, int64_t value) { pose.TimeStampMicroSeconds = value; });
+	data = data ? GetDeltaColumn(data, end, headPoses, [angle](HeadPose& pose, int64_t value) { pose.Rotation.YawDegrees = static_cast<float>(value * angle); }) : nullptr;
+	data = data ? GetDeltaColumn(data, end, headPoses, [angle](HeadPose& pose, int64_t value) { pose.Rotation.PitchDegrees = static_cast<float>(value * angle); }) : nullptr;
+	data = data ? GetDeltaColumn(data, end, headPoses, [angle](HeadPose& pose, int64_t value) { pose.Rotation.RollDegrees = static_cast<float>(value * angle); }) : nullptr;
+	data = data ? GetDeltaColumn(data, end, headPoses, [position](HeadPose& pose, int64_t value) { pose.Position.X = static_cast<float>(value * position); }) : nullptr;
+	data = data ? GetDeltaColumn(data, end, headPoses, [position](HeadPose& pose, int64_t value) { pose.Position.Y = static_cast<float>(value * position); }) : nullptr;
+	data = data ? GetDeltaColumn(data, end, headPoses, [position](HeadPose& pose, int64_t value) { pose.Position.Z = static_cast<float>(value * position); }) : nullptr;
+	if (data != end)
+	{
+		error = "Corrupt head pose block at offset " + std::to_string(block.Offset);
+		headPoses.clear();
+		return false;
+	}
+	return true;
+}
+
+bool SessionArchiveReader::DecodeGazePoints(const ArchiveBlockInfo& block, std::vector<GazePoint>& gazePoints, std::string& error)
+{
+	if (!HasPlausibleSizes(block, k_gazePointColumns))
+	{
+		error = "Corrupt gaze point block at offset " + std::to_string(block.Offset);
+		gazePoints.clear();
+		return false;
+	}
+	const uint8_t* data = GetColumns(block, error);
+	if (data == nullptr)
+	{
+		return false;
+	}
+	const uint8_t* end = data + block.ColumnBytes;
+	const double gaze = m_settings.GazeQuantum;
+	gazePoints.resize(block.SampleCount);
+	data = GetDeltaColumn(data, end, gazePoints, [](GazePoint& point, int64_t value) { point.TimeStampMicroSeconds = value; });
+	data = data ? GetDeltaColumn(data, end, gazePoints, [gaze](GazePoint& point, int64_t value) { point.X = static_cast<float>(value * gaze); }) : nullptr;
+	data = data ? GetDeltaColumn(data, end, gazePoints, [gaze](GazePoint& point, int64_t value) { point.Y = static_cast<float>(value * gaze); }) : nullptr;
+	if (data != end)
+	{
+		error = "Corrupt gaze point block at offset " + std::to_string(block.Offset);
+		gazePoints.clear();
+		return false;
+	}
+	return true;
+}
+
+void SessionArchiveReader::FindBlocks(ArchiveStream stream, int64_t fromMicroSeconds, int64_t toMicroSeconds,
+	std::vector<const ArchiveBlockInfo*>& blocks) const
+{
+	blocks.clear();
+	const std::vector<uint32_t>& streamBlocks = m_streamBlocks[static_cast<int>(stream)];
+	// Samples come in time order, so blocks that start later also end later
+	auto it = std::lower_bound(streamBlocks.begin(), streamBlocks.end(), fromMicroSeconds,
+		[this](uint32_t block, int64_t from) { return m_blocks[block].LastMicroSeconds < from; });
+	for (; it != streamBlocks.end() && m_blocks[*it].FirstMicroSeconds <= toMicroSeconds; ++it)
+	{
+		blocks.push_back(&m_blocks[*it]);
+	}
+}
+
+bool SessionArchiveReader::ReadHeadPoses(int64_t fromMicroSeconds, int64_t toMicroSeconds, std::vector<HeadPose>& headPoses, std::string& error)
+{
+	std::vector<const ArchiveBlockInfo*> blocks;
+	FindBlocks(ArchiveStream::HeadPoses, fromMicroSeconds, toMicroSeconds, blocks);
+	for (const ArchiveBlockInfo* block : blocks)
+	{
+		if (!DecodeHeadPoses(*block, m_headPoseScratch, error))
+		{
+			return false;
+		}
+		for (const HeadPose& headPose : m_headPoseScratch)
+		{
+			if (headPose.TimeStampMicroSeconds >= fromMicroSeconds && headPose.TimeStampMicroSeconds <= toMicroSeconds)
+			{
+				headPoses.push_back(headPose);
+			}
+		}
+	}
+	return true;
+}
+
+bool SessionArchiveReader::ReadGazePoints(int64_t fromMicroSeconds, int64_t toMicroSeconds, std::vector<GazePoint>& gazePoints, std::string& error)
+{
+	std::vector<const ArchiveBlockInfo*> blocks;
+	FindBlocks(ArchiveStream::GazePoints, fromMicroSeconds, toMicroSeconds, blocks);
+	for (const ArchiveBlockInfo* block : blocks)
+	{
+		if (!DecodeGazePoints(*block, m_gazePointScratch, error))
+		{
+			return false;
+		}
+		for (const GazePoint& gazePoint : m_gazePointScratch)
+		{
+			if (gazePoint.TimeStampMicroSeconds >= fromMicroSeconds && gazePoint.TimeStampMicroSeconds <= toMicroSeconds)
+			{
+				gazePoints.push_back(gazePoint);
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "TobiiPlatform.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Deflates every block with zlib when it comes out smaller. Off by default because the Windows project
+// doesn't link zlib; archives written with it need it to be read back.
+#ifndef SESSION_ARCHIVE_ZLIB
+#define SESSION_ARCHIVE_ZLIB 0
+#endif
+
+// Long-term storage for the head pose and gaze point streams of whole play sessions, several times
+// smaller than a session recording (SessionRecording.h). Each stream is cut into blocks of samples
+// stored as columns: timestamps as deltas, angles, positions and gaze coordinates quantized to a fixed
+// step and stored as deltas, all zigzag varint coded, then optionally deflated. A block index at the
+// end of the file lets a reader decode one time range without touching the rest.
+//
+// File layout (little endian, no padding):
+//   header: "THSA", uint32 version, float64 angle, position and gaze quanta
+//   blocks: uint8 stream, uint8 codec, uint16 0, uint32 sample count, int64 first and last timestamp,
+//           uint32 stored bytes, uint32 column bytes, then the stored bytes
+//   index:  per block the same fields plus its uint64 file offset, then uint64 index offset,
+//           uint32 block count, "THSI"
+// An archive without an index (the writer didn't get to Close()) is still readable: the reader then
+// walks the block headers instead.
+
+enum class ArchiveStream : uint8_t
+{
+	HeadPoses,	// timestamp, yaw, pitch, roll, x, y, z
+	GazePoints,	// timestamp, x, y
+};
+
+enum class ArchiveCodec : uint8_t
+{
+	Columns,		// varint columns as they are
+	DeflatedColumns,
+};
+
+struct ArchiveSettings
+{
+	double AngleQuantumDegrees = 0.001;		// far below tracker noise
+	double PositionQuantumMM = 0.01;
+	double GazeQuantum = 0.00001;			// of the normalized -1..1 gaze coordinates
+	int SamplesPerBlock = 4096;				// writer only: a few seconds of head poses at tracker rates
+	bool Deflate = SESSION_ARCHIVE_ZLIB != 0;	// writer only, ignored without SESSION_ARCHIVE_ZLIB
+};
+
+struct ArchiveBlockInfo
+{
+	ArchiveStream Stream = ArchiveStream::HeadPoses;
+	ArchiveCodec Codec = ArchiveCodec::Columns;
+	uint32_t SampleCount = 0;
+	int64_t FirstMicroSeconds = 0;
+	int64_t LastMicroSeconds = 0;
+	uint64_t Offset = 0;			// of the stored bytes in the file
+	uint32_t StoredBytes = 0;
+	uint32_t ColumnBytes = 0;		// before deflating
+};
+
+// Writes one archive. Samples of each stream must come in timestamp order, as the streams provide them.
+class SessionArchiveWriter
+{
+public:
+	~SessionArchiveWriter();
+
+	bool Open(const char* path, const ArchiveSettings& settings, std::string& error);
+	// Writes the pending samples and the index. Returns false if any write failed.
+	bool Close();
+	bool IsOpen() const { return m_file.is_open(); }
+
+	void AddHeadPoses(const TobiiGameIntegration::HeadPose* headPoses, int count);
+	void AddGazePoints(const TobiiGameIntegration::GazePoint* gazePoints, int count);
+
+	uint64_t GetSampleCount() const { return m_sampleCount; }
+	// What the same samples take in a session recording, and in this archive so far
+	uint64_t GetRawBytes() const { return m_rawBytes; }
+	uint64_t GetArchiveBytes() const { return m_offset; }
+
+private:
+	void FlushHeadPoses();
+	void FlushGazePoints();
+	void WriteBlock(ArchiveStream stream, uint32_t sampleCount, int64_t firstMicroSeconds, int64_t lastMicroSeconds);
+
+	std::ofstream m_file;
+	ArchiveSettings m_settings;
+	std::vector<TobiiGameIntegration::HeadPose> m_headPoses;
+	std::vector<TobiiGameIntegration::GazePoint> m_gazePoints;
+	std::vector<uint8_t> m_columns;
+	std::vector<uint8_t> m_deflated;
+	std::vector<ArchiveBlockInfo> m_index;
+	uint64_t m_offset = 0;
+	uint64_t m_sampleCount = 0;
+	uint64_t m_rawBytes = 0;
+};
+
+// Read-only view of a whole file, mapped rather than read so that only the pages of the blocks that get
+// decoded are ever loaded.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const char* path, std::string& error);
+	const uint8_t* GetData() const { return m_data; }
+	size_t GetSize() const { return m_size; }
+
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+#endif
+};
+
+// Reads an archive. Decoding functions reuse the output vectors and scratch space, so a reader is used
+// from one thread; open several readers on the same file to decode in parallel.
+class SessionArchiveReader
+{
+public:
+	bool Open(const char* path, std::string& error);
+
+	const ArchiveSettings& GetSettings() const { return m_settings; }
+	const std::vector<ArchiveBlockInfo>& GetBlocks() const { return m_blocks; }
+	bool HasIndex() const { return m_hasIndex; }
+	uint64_t GetFileBytes() const { return m_file.GetSize(); }
+
+	// Replaces the contents of the vector with the block's samples.
+	bool DecodeHeadPoses(const ArchiveBlockInfo& block, std::vector<TobiiGameIntegration::HeadPose>& headPoses, std::string& error);
+	bool DecodeGazePoints(const ArchiveBlockInfo& block, std::vector<TobiiGameIntegration::GazePoint>& gazePoints, std::string& error);
+
+	// Appends the samples with fromMicroSeconds <= timestamp <= toMicroSeconds, decoding only the blocks
+	// that overlap the range.
+	bool ReadHeadPoses(int64_t fromMicroSeconds, int64_t toMicroSeconds, std::vector<TobiiGameIntegration::HeadPose>& headPoses,
+		std::string& error);
+	bool ReadGazePoints(int64_t fromMicroSeconds, int64_t toMicroSeconds, std::vector<TobiiGameIntegration::GazePoint>& gazePoints,
+		std::string& error);
+
+	// Blocks of the stream that overlap the range, in time order.
+	void FindBlocks(ArchiveStream stream, int64_t fromMicroSeconds, int64_t toMicroSeconds, std::vector<const ArchiveBlockInfo*>& blocks) const;
+
+private:
+	bool ReadIndex();
+	void ScanBlocks();
+	const uint8_t* GetColumns(const ArchiveBlockInfo& block, std::string& error);
+
+	MappedFile m_file;
+	ArchiveSettings m_settings;
+	std::vector<ArchiveBlockInfo> m_blocks;
+	std::vector<uint32_t> m_streamBlocks[2];	// indices into m_blocks per stream, in time order
+	bool m_hasIndex = false;
+	std::vector<uint8_t> m_inflated;
+	std::vector<TobiiGameIntegration::HeadPose> m_headPoseScratch;
+	std::vector<TobiiGameIntegration::GazePoint> m_gazePointScratch;
+};
@@ -0,0 +1,299 @@
+#include "SessionRecording.h"
+#include "Clock.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace TobiiGameIntegration;
+
+static constexpr char k_sessionMagic[4] = { 'T', 'H', 'S', 'R' };
+static constexpr uint32_t k_sessionVersion = 1;
+// Bytes on file, see the layout in SessionRecording.h
+static constexpr uint64_t k_sessionHeaderBytes = 4 + 4;
+static constexpr uint64_t k_frameHeaderBytes = 8 + 1 + 6 * 4 + 3 * 4;
+static constexpr uint64_t k_headPoseBytes = 8 + 6 * 4;
+static constexpr uint64_t k_gazePointBytes = 8 + 2 * 4;
+static constexpr uint64_t k_hmdGazeBytes = 8 + 4 + 2 * 9 * 4;
+
+template <typename T>
+static void Write(std::ofstream& file, T value)
+{
+	file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool Read(std::ifstream& file, T& value)
+{
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+static void WriteTransformation(std::ofstream& file, const Transformation& trans)
+{
+	Write(file, trans.Rotation.YawDegrees);
+	Write(file, trans.Rotation.PitchDegrees);
+	Write(file, trans.Rotation.RollDegrees);
+	Write(file, trans.Position.X);
+	Write(file, trans.Position.Y);
+	Write(file, trans.Position.Z);
+}
+
+static bool ReadTransformation(std::ifstream& file, Transformation& trans)
+{
+	return Read(file, trans.Rotation.YawDegrees) && Read(file, trans.Rotation.PitchDegrees) && Read(file, trans.Rotation.RollDegrees) &&
+		Read(file, trans.Position.X) && Read(file, trans.Position.Y) && Read(file, trans.Position.Z);
+}
+
+static void WriteEyeInfo(std::ofstream& file, const EyeInfo& eye)
+{
+	Write(file, eye.GazeOriginMM.X);
+	Write(file, eye.GazeOriginMM.Y);
+	Write(file, eye.GazeOriginMM.Z);
+	Write(file, eye.GazeDirection.X);
+	Write(file, eye.GazeDirection.Y);
+	Write(file, eye.GazeDirection.Z);
+	Write(file, eye.PupilPosition.X);
+	Write(file, eye.PupilPosition.Y);
+	Write(file, eye.EyeOpenness);
+}
+
+static bool ReadEyeInfo(std::ifstream& file, EyeInfo& eye)
+{
+	return Read(file, eye.GazeOriginMM.X) && Read(file, eye.GazeOriginMM.Y) && Read(file, eye.GazeOriginMM.Z) &&
+		Read(file, eye.GazeDirection.X) && Read(file, eye.GazeDirection.Y) && Read(file, eye.GazeDirection.Z) &&
+		Read(file, eye.PupilPosition.X) && Read(file, eye.PupilPosition.Y) && Read(file, eye.EyeOpenness);
+}
+
+bool SessionRecorder::Open(const char* path)
+{
+	m_file.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_file)
+	{
+		return false;
+	}
+
+	m_file.write(k_sessionMagic, sizeof(k_sessionMagic));
+	Write(m_file, k_sessionVersion);
+	m_startMicroSeconds = NowMicroSeconds();
+	m_framesWritten = 0;
+	return static_cast<bool>(m_file);
+}
+
+void SessionRecorder::Close()
+{
+	m_file.close();
+}
+
+void SessionRecorder::RecordFrame(ITobiiGameIntegrationApi* api, const HeadPose* headPoses, int headPoseCount, bool readGaze)
+{
+	IStreamsProvider* streamsProvider = api->GetStreamsProvider();
+
+	m_frame.UpdateMicroSeconds = NowMicroSeconds() - m_startMicroSeconds;
+	m_frame.IsPresent = streamsProvider->IsPresent();
+	m_frame.ExtendedView = api->GetFeatures()->GetExtendedView()->GetTransformation();
+
+	m_frame.HeadPoses.assign(headPoses, headPoses + (std::max)(headPoseCount, 0));
+
+	m_frame.GazePoints.clear();
+	m_frame.HMDGazes.clear();
+	if (readGaze)
+	{
+		const GazePoint* gazePoints = nullptr;
+		const int gazePointCount = streamsProvider->GetGazePoints(gazePoints);
+		m_frame.GazePoints.assign(gazePoints, gazePoints + (std::max)(gazePointCount, 0));
+
+		const HMDGaze* hmdGazes = nullptr;
+		const int hmdGazeCount = streamsProvider->GetHMDGaze(hmdGazes);
+		m_frame.HMDGazes.assign(hmdGazes, hmdGazes + (std::max)(hmdGazeCount, 0));
+	}
+
+	WriteFrame(m_frame);
+}
+
+void SessionRecorder::WriteFrame(const RecordedFrame& frame)
+{
+	Write(m_file, frame.UpdateMicroSeconds);
+	Write(m_file, static_cast<uint8_t>(frame.IsPresent ? 1 : 0));
+	WriteTransformation(m_file, frame.ExtendedView);
+	Write(m_file, static_cast<uint32_t>(frame.HeadPoses.size()));
+	Write(m_file, static_cast<uint32_t>(frame.GazePoints.size()));
+	Write(m_file, static_cast<uint32_t>(frame.HMDGazes.size()));
+
+	for (const HeadPose& headPose : frame.HeadPoses)
+	{
+		Write(m_file, headPose.TimeStampMicroSeconds);
+		WriteTransformation(m_file, headPose);
+	}
+	for (const GazePoint& gazePoint : frame.GazePoints)
+	{
+		Write(m_file, gazePoint.TimeStampMicroSeconds);
+		Write(m_file, gazePoint.X);
+		Write(m_file, gazePoint.Y);
+	}
+	for (const HMDGaze& hmdGaze : frame.HMDGazes)
+	{
+		Write(m_file, hmdGaze.Timestamp);
+		Write(m_file, static_cast<uint32_t>(hmdGaze.Validity));
+		WriteEyeInfo(m_file, hmdGaze.LeftEyeInfo);
+		WriteEyeInfo(m_file, hmdGaze.RightEyeInfo);
+	}
+	m_framesWritten++;
+}
+
+bool SessionReader::Open(const char* path)
+{
+	m_file.open(path, std::ios::binary);
+	if (!m_file)
+	{
+		return false;
+	}
+
+	char magic[sizeof(k_sessionMagic)];
+	uint32_t version = 0;
+	if (!m_file.read(magic, sizeof(magic)) || std::memcmp(magic, k_sessionMagic, sizeof(magic)) != 0 ||
+		!Read(m_file, version) || version != k_sessionVersion)
+	{
+		m_file.close();
+		return false;
+	}
+	m_file.seekg(0, std::ios::end);
+	m_bytesLeft = static_cast<uint64_t>(m_file.tellg()) - k_sessionHeaderBytes;
+	m_file.seekg(k_sessionHeaderBytes);
+	return true;
+}
+
+bool SessionReader::ReadFrame(RecordedFrame& frame)
+{
+	uint8_t isPresent = 0;
+	uint32_t headPoseCount = 0, gazePointCount = 0, hmdGazeCount = 0;
+	if (!Read(m_file, frame.UpdateMicroSeconds) || !Read(m_file, isPresent) || !ReadTransformation(m_file, frame.ExtendedView) ||
+		!Read(m_file, headPoseCount) || !Read(m_file, gazePointCount) || !Read(m_file, hmdGazeCount))
+	{
+		return false;
+	}
+	frame.IsPresent = isPresent != 0;
+	// The counts come from the file; a corrupt or cut-off frame must not get to size the vectors
+	m_bytesLeft -= (std::min)(m_bytesLeft, k_frameHeaderBytes);
+	const uint64_t sampleBytes = headPoseCount * k_headPoseBytes + gazePointCount * k_gazePointBytes + hmdGazeCount * k_hmdGazeBytes;
+	if (sampleBytes > m_bytesLeft)
+	{
+		return false;
+	}
+	m_bytesLeft -= sampleBytes;
+
+	frame.HeadPoses.resize(headPoseCount);
+	for (HeadPose& headPose : frame.HeadPoses)
+	{
+		if (!Read(m_file, headPose.TimeStampMicroSeconds) || !ReadTransformation(m_file, headPose))
+		{
+			return false;
+		}
+	}
+	frame.GazePoints.resize(gazePointCount);
+	for (GazePoint& gazePoint : frame.GazePoints)
+	{
+		if (!Read(m_file, gazePoint.TimeStampMicroSeconds) || !Read(m_file, gazePoint.X) || !Read(m_file, gazePoint.Y))
+		{
+			return false;
+		}
+	}
+	frame.HMDGazes.resize(hmdGazeCount);
+	for (HMDGaze& hmdGaze : frame.HMDGazes)
+	{
+		uint32_t validity = 0;
+		if (!Read(m_file, hmdGaze.Timestamp) || !Read(m_file, validity) ||
+			!ReadEyeInfo(m_file, hmdGaze.LeftEyeInfo) || !ReadEyeInfo(m_file, hmdGaze.RightEyeInfo))
+		{
+			return false;
+		}
+		hmdGaze.Validity = static_cast<HMDValidityFlags>(validity);
+	}
+	return true;
+}
+
+ReplayApi::ReplayApi(const char* path, ReplayTiming timing)
+	: OfflineApi("replay"), m_timing{ timing }
+{
+	m_reader.Open(path);
+}
+
+void ReplayApi::Update()
+{
+	BeginFrame();
+	if (m_isFinished || !m_reader.IsOpen())
+	{
+		m_isFinished = true;
+		return;
+	}
+
+	if (m_timing == ReplayTiming::AsFastAsPossible)
+	{
+		if (m_reader.ReadFrame(m_pendingFrame))
+		{
+			ApplyFrame(m_pendingFrame);
+		}
+		else
+		{
+			m_isFinished = true;
+		}
+		return;
+	}
+
+	const int64_t now = NowMicroSeconds();
+	if (m_replayStartMicroSeconds < 0)
+	{
+		m_replayStartMicroSeconds = now;
+	}
+	const int64_t elapsed = now - m_replayStartMicroSeconds;
+
+	// Several recorded frames can be due at once when we are polled slower than the recording was
+	while (true)
+	{
+		if (!m_hasPendingFrame)
+		{
+			m_hasPendingFrame = m_reader.ReadFrame(m_pendingFrame);
+			if (!m_hasPendingFrame)
+			{
+				m_isFinished = true;
+				return;
+			}
+		}
+		if (m_pendingFrame.UpdateMicroSeconds > elapsed)
+		{
+			return;
+		}
+		ApplyFrame(m_pendingFrame);
+		m_hasPendingFrame = false;
+	}
+}
+
+void ReplayApi::ApplyFrame(const RecordedFrame& frame)
+{
+	if (m_timing == ReplayTiming::Original && !m_hasTimeStampOffset && (!frame.HeadPoses.empty() || !frame.GazePoints.empty()))
+	{
+		// The first frame with samples of either stream counts as having arrived when it is replayed, everything
+		// later keeps the recorded spacing. Both streams share the offset so they stay aligned with each other.
+		int64_t newest = frame.HeadPoses.empty() ? frame.GazePoints.back().TimeStampMicroSeconds : frame.HeadPoses.back().TimeStampMicroSeconds;
+		if (!frame.GazePoints.empty())
+		{
+			newest = (std::max)(newest, frame.GazePoints.back().TimeStampMicroSeconds);
+		}
+		m_timeStampOffset = m_replayStartMicroSeconds + frame.UpdateMicroSeconds - newest;
+		m_hasTimeStampOffset = true;
+	}
+
+	for (HeadPose headPose : frame.HeadPoses)
+	{
+		headPose.TimeStampMicroSeconds += m_timeStampOffset;
+		AddHeadPose(headPose);
+	}
+	for (GazePoint gazePoint : frame.GazePoints)
+	{
+		gazePoint.TimeStampMicroSeconds += m_timeStampOffset;
+		AddGazePoint(gazePoint);
+	}
+	for (const HMDGaze& hmdGaze : frame.HMDGazes)
+	{
+		AddHMDGaze(hmdGaze);
+	}
+	SetPresent(frame.IsPresent);
+	SetTransformation(frame.ExtendedView);
+}
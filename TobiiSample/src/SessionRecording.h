@@ -0,0 +1,91 @@
+#pragma once
+
+#include "OfflineApi.h"
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+// Everything one ITobiiGameIntegrationApi::Update() produced.
+struct RecordedFrame
+{
+	int64_t UpdateMicroSeconds = 0;		// when Update() was called, relative to the start of the recording
+	bool IsPresent = false;
+	TobiiGameIntegration::Transformation ExtendedView;
+	std::vector<TobiiGameIntegration::HeadPose> HeadPoses;
+	std::vector<TobiiGameIntegration::GazePoint> GazePoints;
+	std::vector<TobiiGameIntegration::HMDGaze> HMDGazes;
+};
+
+// Session file layout (little endian, no padding):
+//   header: "THSR", uint32 version
+//   frames: int64 update time, uint8 presence, 6 x float Extended View transformation,
+//           uint32 head pose count, uint32 gaze point count, uint32 HMD gaze count,
+//           then the samples of each stream in that order.
+class SessionRecorder
+{
+public:
+	bool Open(const char* path);
+	void Close();
+	bool IsOpen() const { return m_file.is_open(); }
+
+	// Call after api->Update(), records what Update() produced. The head poses are the ones the caller
+	// already read this frame; the gaze streams are only read when readGaze, so streams the caller leaves
+	// unread (see ActivityGovernor) still get unsubscribed while recording.
+	void RecordFrame(TobiiGameIntegration::ITobiiGameIntegrationApi* api, const TobiiGameIntegration::HeadPose* headPoses,
+		int headPoseCount, bool readGaze);
+	void WriteFrame(const RecordedFrame& frame);
+
+	uint64_t GetFramesWritten() const { return m_framesWritten; }
+
+private:
+	std::ofstream m_file;
+	int64_t m_startMicroSeconds = 0;
+	uint64_t m_framesWritten = 0;
+	RecordedFrame m_frame;
+};
+
+class SessionReader
+{
+public:
+	bool Open(const char* path);
+	bool IsOpen() const { return m_file.is_open(); }
+
+	// Reuses the vectors in frame. Returns false at the end of the file or on a truncated or corrupt frame.
+	bool ReadFrame(RecordedFrame& frame);
+
+private:
+	std::ifstream m_file;
+	uint64_t m_bytesLeft = 0;	// after the frames read so far
+};
+
+enum class ReplayTiming
+{
+	Original,			// Update() returns the frames that were due by now, relative to the first Update().
+						// Sample timestamps are moved onto NowMicroSeconds() so latency can be measured against them.
+	AsFastAsPossible	// every Update() returns exactly one recorded frame
+};
+
+// Serves a recorded session through the ITobiiGameIntegrationApi interfaces.
+// GetTransformation() returns the recorded Extended View output, settings changes are accepted but not applied.
+class ReplayApi : public OfflineApi
+{
+public:
+	ReplayApi(const char* path, ReplayTiming timing);
+
+	bool IsInitialized() override { return m_reader.IsOpen(); }
+	void Update() override;
+
+	bool IsFinished() const override { return m_isFinished; }
+
+private:
+	void ApplyFrame(const RecordedFrame& frame);
+
+	SessionReader m_reader;
+	ReplayTiming m_timing;
+	RecordedFrame m_pendingFrame;
+	bool m_hasPendingFrame = false;
+	bool m_isFinished = false;
+	int64_t m_replayStartMicroSeconds = -1;
+	int64_t m_timeStampOffset = 0;
+	bool m_hasTimeStampOffset = false;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Immutable snapshots handed from one writer thread to one reader thread, e.g. a reloaded profile
+// to the mapping loop. The reader never blocks, allocates or frees: Acquire() is two atomic loads and
+// a store. The writer swaps the pointer and keeps the old snapshot until the reader's hazard pointer
+// shows it has moved on, then frees it on a later Publish() or Reclaim().
+template <typename T>
+class SnapshotSlot
+{
+public:
+	~SnapshotSlot()
+	{
+		delete m_current.load(std::memory_order_relaxed);
+	}
+
+	// Reader thread only. The snapshot stays valid until the reader's next Acquire(); nullptr if nothing
+	// was published yet.
+	const T* Acquire()
+	{
+		const T* snapshot = m_current.load(std::memory_order_acquire);
+		for (;;)
+		{
+			m_hazard.store(snapshot, std::memory_order_seq_cst);
+			const T* current = m_current.load(std::memory_order_seq_cst);
+			if (current == snapshot)
+			{
+				return snapshot;
+			}
+			snapshot = current;
+		}
+	}
+
+	// Writer thread only.
+	void Publish(std::unique_ptr<const T> snapshot)
+	{
+		const T* previous = m_current.exchange(snapshot.release(), std::memory_order_seq_cst);
+		if (previous != nullptr)
+		{
+			m_retired.emplace_back(previous);
+		}
+		m_version.fetch_add(1, std::memory_order_relaxed);
+		Reclaim();
+	}
+
+	// Writer thread only: frees the retired snapshots the reader no longer holds.
+	void Reclaim()
+	{
+		const T* inUse = m_hazard.load(std::memory_order_seq_cst);
+		for (size_t i = 0; i < m_retired.size();)
+		{
+			if (m_retired[i].get() != inUse)
+			{
+				m_retired[i] = std::move(m_retired.back());
+				m_retired.pop_back();
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	// Number of Publish() calls, readable from any thread.
+	uint32_t GetVersion() const { return m_version.load(std::memory_order_relaxed); }
+	size_t GetRetiredCount() const { return m_retired.size(); }
+
+private:
+	std::atomic<const T*> m_current{ nullptr };
+	std::atomic<const T*> m_hazard{ nullptr };
+	std::atomic<uint32_t> m_version{ 0 };
+	std::vector<std::unique_ptr<const T>> m_retired;
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+static constexpr size_t k_cacheLineSize = 64;
+
+struct SpscRingStats
+{
+	// producer side
+	uint64_t Pushed;
+	uint64_t Overruns;		// pushes dropped because the ring was full
+	uint64_t MaxDepthAtPush;
+	// consumer side
+	uint64_t Popped;
+	uint64_t EmptyPolls;	// pops that found nothing
+	uint64_t MaxDepthAtPop;
+	uint64_t Depth;
+};
+
+// Bounded lock-free single-producer/single-consumer ring.
+// TryPush must only be called from one thread and TryPop from one (other) thread.
+// Producer and consumer state live on separate cache lines so the two threads never
+// write to the same line; each side keeps a cached copy of the other side's index and
+// only reloads it when the ring looks full/empty.
+template <typename T, size_t Capacity>
+class SpscRing
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	bool TryPush(const T& item)
+	{
+		const uint64_t head = m_head.load(std::memory_order_relaxed);
+		if (head - m_cachedTail >= Capacity)
+		{
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if (head - m_cachedTail >= Capacity)
+			{
+				m_overruns.store(m_overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+
+		m_items[head & k_mask] = item;
+		m_head.store(head + 1, std::memory_order_release);
+
+		// m_cachedTail can be far behind, only refreshed when the ring looks full, so it would overstate
+		// the depth. The real tail is read for the stat only, a slightly stale value is fine.
+		const uint64_t depth = head + 1 - m_tail.load(std::memory_order_relaxed);
+		if (depth > m_maxDepthAtPush.load(std::memory_order_relaxed))
+		{
+			m_maxDepthAtPush.store(depth, std::memory_order_relaxed);
+		}
+		return true;
+	}
+
+	bool TryPop(T& item)
+	{
+		const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail == m_cachedHead)
+		{
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (tail == m_cachedHead)
+			{
+				m_emptyPolls.store(m_emptyPolls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+
+		const uint64_t depth = m_cachedHead - tail;
+		if (depth > m_maxDepthAtPop.load(std::memory_order_relaxed))
+		{
+			m_maxDepthAtPop.store(depth, std::memory_order_relaxed);
+		}
+
+		item = m_items[tail & k_mask];
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Approximate when called concurrently with push/pop.
+	size_t Size() const
+	{
+		const uint64_t tail = m_tail.load(std::memory_order_acquire);
+		const uint64_t head = m_head.load(std::memory_order_acquire);
+		return static_cast<size_t>(head - tail);
+	}
+
+	static constexpr size_t GetCapacity() { return Capacity; }
+
+	// Safe to call from any thread, values are a relaxed snapshot.
+	SpscRingStats GetStats() const
+	{
+		SpscRingStats stats;
+		stats.Popped = m_tail.load(std::memory_order_relaxed);
+		stats.Pushed = m_head.load(std::memory_order_relaxed);
+		stats.Overruns = m_overruns.load(std::memory_order_relaxed);
+		stats.MaxDepthAtPush = m_maxDepthAtPush.load(std::memory_order_relaxed);
+		stats.EmptyPolls = m_emptyPolls.load(std::memory_order_relaxed);
+		stats.MaxDepthAtPop = m_maxDepthAtPop.load(std::memory_order_relaxed);
+		stats.Depth = stats.Pushed >= stats.Popped ? stats.Pushed - stats.Popped : 0;
+		return stats;
+	}
+
+private:
+	static constexpr uint64_t k_mask = Capacity - 1;
+
+	// written by the producer
+	alignas(k_cacheLineSize) std::atomic<uint64_t> m_head{ 0 };
+	uint64_t m_cachedTail = 0;
+	std::atomic<uint64_t> m_overruns{ 0 };
+	std::atomic<uint64_t> m_maxDepthAtPush{ 0 };
+
+	// written by the consumer
+	alignas(k_cacheLineSize) std::atomic<uint64_t> m_tail{ 0 };
+	uint64_t m_cachedHead = 0;
+	std::atomic<uint64_t> m_emptyPolls{ 0 };
+	std::atomic<uint64_t> m_maxDepthAtPop{ 0 };
+
+	alignas(k_cacheLineSize) T m_items[Capacity];
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "HeadMouseMapping.h"
+
+#define ENABLE_PITCH 0
+
+// settings tuned for Squad game with 3200x2000 res and 1000 DPI mouse
+// change only the numbers, unless you know what you're doing
+// used when no --profile is given, profiles/squad.profile is the same mapping without a rebuild
+static constexpr float k_sens = 30.0f;
+#if ENABLE_PITCH
+static constexpr float k_ySensMult = 0.25f;
+#else
+static constexpr float k_ySensMult = 0.0f;
+#endif
+static constexpr float k_deadYawIRL = 7.5f;
+static constexpr float k_deadPitchIRL = 7.5f;
+// how far the cursor may go past the deadzone, in counts
+static constexpr float k_maxYawCounts = 650.0f;
+static constexpr float k_maxPitchCounts = 100.0f;
+static constexpr float k_maxYawIRL = k_maxYawCounts / k_sens + k_deadYawIRL;
+#if ENABLE_PITCH
+static constexpr float k_maxPitchIRL = k_maxPitchCounts / (k_sens * k_ySensMult) + k_deadPitchIRL;
+#else
+static constexpr float k_maxPitchIRL = 0.0f;
+#endif
+
+inline MappingSettings SquadMappingSettings()
+{
+	return { k_sens, k_ySensMult, k_deadYawIRL, k_deadPitchIRL, k_maxYawIRL, k_maxPitchIRL };
+}
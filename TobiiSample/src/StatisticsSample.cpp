@@ -1,4 +1,6 @@
 #include "tobii_gameintegration.h"
+#include "ApiBackend.h"
+#include "PacedScheduler.h"
 #include <iostream>
 #include "windows.h"
 #include <thread>
@@ -16,7 +18,11 @@ enum EyetrackingFeature
 
 void StatisticsSample()
 {
-    ITobiiGameIntegrationApi* api = GetApi("Statistics Sample Application");
+    ITobiiGameIntegrationApi* api = GetBackendApi("Statistics Sample Application");
+    if (api == nullptr)
+    {
+        return;
+    }
     IStatistics* statistics = api->GetStatistics();
 
     // Starting tracking is needed for statistics logging
@@ -40,6 +46,7 @@ void StatisticsSample()
 
     bool hackAtGazeEnabled = false; // Bind to the in-game settings
     bool dirtySettings = false;     // Set to true when settings are updated
+    PacedScheduler frameRate{ 60.0 };
     while (!GetAsyncKeyState(VK_ESCAPE))
     {
         api->Update();
@@ -65,7 +72,7 @@ void StatisticsSample()
             dirtySettings = false;
         }
         
-        Sleep(1000 / 60);
+        frameRate.WaitForNextTick();
     }
 
     api->Shutdown();
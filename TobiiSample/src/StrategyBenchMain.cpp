@@ -0,0 +1,140 @@
+// Runs every mapping strategy over the same head poses and compares cost and output: a recorded session
+// or a synthetic stream is read once, then mapped by each strategy in MyNewMain-sized batches.
+// The hold strategy's key is scripted as held for 2 s out of every 4 s of sample time.
+// Build it instead of MyNewMain.cpp, e.g. on Linux:
+//   g++ -std=c++20 -O2 -fpermissive -Ivendor/tobii/include src/StrategyBenchMain.cpp src/MappingEngine.cpp src/RateIntegrator.cpp
+//       src/StrategySettings.cpp src/HeadMouseMapping.cpp src/MappingKernel.cpp src/ResponseCurve.cpp src/ApiBackend.cpp src/OfflineApi.cpp src/SessionRecording.cpp
+//       src/SyntheticApi.cpp src/OpenTrackApi.cpp src/OpenTrackUdp.cpp -o strategy-bench
+// Usage: strategy-bench <session file> | synthetic:<settings> [--profile <file>]
+#include "ApiBackend.h"
+#include "Clock.h"
+#include "MappingEngine.h"
+#include "OfflineApi.h"
+#include "SquadTuning.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace TobiiGameIntegration;
+
+static constexpr int k_batchSize = 64;
+static constexpr int k_repeats = 20;
+static constexpr int64_t k_holdPeriodMicroSeconds = 4'000'000;
+
+struct StrategyResult
+{
+	double NanoSecondsPerPose = 0.0;
+	uint64_t Deltas = 0;
+	int64_t PathCounts = 0;			// sum of |dx| + |dy|
+	int64_t FinalDx = 0;
+	int64_t MaxAbsoluteDx = 0;		// furthest the cursor got from where it started, horizontally
+	uint64_t Reversals = 0;			// horizontal deltas that changed direction
+};
+
+static StrategyResult RunStrategy(const StrategySettings& strategy, const MappingSettings& mappingSettings, const ResponseCurves* curves,
+	const std::vector<HeadPose>& headPoses)
+{
+	StrategyResult result;
+	std::vector<MouseDelta> deltas(headPoses.size());
+	const int64_t start = headPoses.empty() ? 0 : headPoses.front().TimeStampMicroSeconds;
+	int64_t bestNanoSeconds = INT64_MAX;
+	for (int repeat = 0; repeat < k_repeats; repeat++)
+	{
+		std::unique_ptr<MappingEngine> engine = CreateMappingEngine(strategy, mappingSettings);
+		engine->SetCurves(curves);
+		size_t deltaCount = 0;
+		const int64_t begin = NowNanoSeconds();
+		for (size_t first = 0; first < headPoses.size(); first += k_batchSize)
+		{
+			const int count = static_cast<int>((std::min)(headPoses.size() - first, static_cast<size_t>(k_batchSize)));
+			engine->SetModifierHeld((headPoses[first].TimeStampMicroSeconds - start) % k_holdPeriodMicroSeconds >= k_holdPeriodMicroSeconds / 2);
+			deltaCount += engine->MapHeadPoses(&headPoses[first], count, &deltas[deltaCount]);
+		}
+		bestNanoSeconds = (std::min)(bestNanoSeconds, NowNanoSeconds() - begin);
+		result.Deltas = deltaCount;
+	}
+	result.NanoSecondsPerPose = headPoses.empty() ? 0.0 : static_cast<double>(bestNanoSeconds) / headPoses.size();
+
+	long lastDx = 0;
+	for (size_t i = 0; i < result.Deltas; i++)
+	{
+		result.PathCounts += std::abs(deltas[i].Dx) + std::abs(deltas[i].MinusDy);
+		result.FinalDx += deltas[i].Dx;
+		result.MaxAbsoluteDx = (std::max)(result.MaxAbsoluteDx, std::abs(result.FinalDx));
+		if (deltas[i].Dx != 0)
+		{
+			result.Reversals += lastDx != 0 && (deltas[i].Dx > 0) != (lastDx > 0);
+			lastDx = deltas[i].Dx;
+		}
+	}
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: " << argv[0] << " <session file> | synthetic:<settings> [--profile <file>]" << std::endl;
+		return 1;
+	}
+	const std::string source{ argv[1] };
+	StrategySettings strategy;
+	std::unique_ptr<ResponseCurves> curves;
+	if (argc > 3 && std::string{ argv[2] } == "--profile")
+	{
+		ResponseProfile profile;
+		std::string error;
+		if (!LoadResponseProfile(argv[3], profile, error))
+		{
+			std::cout << error << std::endl;
+			return 1;
+		}
+		if (profile.HasCurves)
+		{
+			curves = std::make_unique<ResponseCurves>(profile);
+		}
+		strategy = profile.Strategy;
+	}
+
+	const bool synthetic = source.rfind("synthetic", 0) == 0;
+	OfflineApi* api = dynamic_cast<OfflineApi*>(GetBackendApi("Strategy bench", (synthetic ? source : "replay-fast:" + source).c_str()));
+	if (api == nullptr)
+	{
+		return 1;
+	}
+	ExtendedViewSettings extendedViewSettings;
+	api->GetFeatures()->GetExtendedView()->GetSettings(extendedViewSettings);
+	MappingSettings mappingSettings = SquadMappingSettings();
+	mappingSettings.HeadPoseYawScale = extendedViewSettings.HeadTracking.YawRightDegrees.SensitivityScaling;
+	mappingSettings.HeadPosePitchScale = extendedViewSettings.HeadTracking.PitchUpDegrees.SensitivityScaling;
+
+	std::vector<HeadPose> headPoses;
+	while (!api->IsFinished())
+	{
+		api->Update();
+		const HeadPose* poses = nullptr;
+		const int count = api->GetStreamsProvider()->GetHeadPoses(poses);
+		headPoses.insert(headPoses.end(), poses, poses + count);
+	}
+	api->Shutdown();
+	if (headPoses.empty())
+	{
+		std::cout << "No head poses in " << source << std::endl;
+		return 1;
+	}
+	const double seconds = (headPoses.back().TimeStampMicroSeconds - headPoses.front().TimeStampMicroSeconds) / 1e6;
+	std::cout << headPoses.size() << " head poses over " << seconds << " s, best of " << k_repeats << " runs" << std::endl;
+
+	std::cout << "strategy     ns/pose    deltas      path   final dx  max |dx|  reversals" << std::endl;
+	for (int kind = 0; kind < static_cast<int>(MappingStrategyKind::Count); kind++)
+	{
+		strategy.Kind = static_cast<MappingStrategyKind>(kind);
+		const StrategyResult result = RunStrategy(strategy, mappingSettings, curves.get(), headPoses);
+		std::cout << std::left << std::setw(8) << GetStrategyName(strategy.Kind) << std::right << std::fixed << std::setprecision(1) <<
+			std::setw(12) << result.NanoSecondsPerPose << std::setw(10) << result.Deltas << std::setw(10) << result.PathCounts <<
+			std::setw(11) << result.FinalDx << std::setw(10) << result.MaxAbsoluteDx << std::setw(11) << result.Reversals << std::endl;
+	}
+}
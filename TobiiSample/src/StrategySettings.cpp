@@ -0,0 +1,56 @@
+#include "StrategySettings.h"
+
+const char* GetStrategyName(MappingStrategyKind kind)
+{
+	switch (kind)
+	{
+	case MappingStrategyKind::Rate:
+		return "rate";
+	case MappingStrategyKind::Follow:
+		return "follow";
+	case MappingStrategyKind::Hold:
+		return "hold";
+	default:
+		return "absolute";
+	}
+}
+
+bool ParseStrategyEntry(const std::string& key, const std::string& value, StrategySettings& settings)
+{
+	if (key == "mode")
+	{
+		for (int kind = 0; kind < static_cast<int>(MappingStrategyKind::Count); kind++)
+		{
+			if (value == GetStrategyName(static_cast<MappingStrategyKind>(kind)))
+			{
+				settings.Kind = static_cast<MappingStrategyKind>(kind);
+				return true;
+			}
+		}
+		return false;
+	}
+	if (key == "pitch")
+	{
+		settings.HoldPitch = value == "on";
+		return value == "on" || value == "off";
+	}
+
+	float* const target = key == "speed.yaw" ? &settings.SpeedYaw : key == "speed.pitch" ? &settings.SpeedPitch :
+		key == "deadzone" ? &settings.DeadRadiusDegrees : key == "maxspeed" ? &settings.MaxSpeed : key == "sens" ? &settings.Sens :
+		key == "ysensmult" ? &settings.YSensMult : key == "threshold" ? &settings.ThresholdCounts : key == "step" ? &settings.StepMilliSeconds :
+		key == "catchup" ? &settings.MaxCatchUpMilliSeconds : nullptr;
+	if (target == nullptr)
+	{
+		return false;
+	}
+	try
+	{
+		*target = std::stof(value);
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+	// Sens and YSensMult are divided by, and a step of zero would never end
+	return key == "sens" || key == "ysensmult" || key == "step" ? *target > 0.0f : *target >= 0.0f;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+
+// How head angles turn into mouse motion. Each one is the control model of one of the mains that used to
+// live side by side: MyNewMain.cpp, MyMain.cpp, MyMainOld.cpp and 3P.cpp (now profiles/*.profile).
+enum class MappingStrategyKind
+{
+	Absolute,	// MyNewMain: head angle -> cursor offset, with deadzone and clamp (or the profile's curves)
+	Rate,		// MyMain: head angle beyond a radial deadzone -> cursor speed
+	Follow,		// MyMainOld: head motion -> cursor motion, small steps ignored
+	Hold,		// 3P: head motion -> cursor motion only while a key is held, undone on release
+	Count
+};
+
+// The [strategy] section of a profile, see ParseStrategyEntry(). Defaults are the old mains' constants.
+struct StrategySettings
+{
+	MappingStrategyKind Kind = MappingStrategyKind::Absolute;
+
+	// Rate
+	float SpeedYaw = 200.0f;			// counts per second per degree beyond the deadzone
+	float SpeedPitch = 50.0f;
+	float DeadRadiusDegrees = 20.0f;	// of the combined yaw/pitch angle
+	float MaxSpeed = 10000.0f;			// counts per second per axis
+	float StepMilliSeconds = 1.0f;		// integration step, see RateIntegrator
+	float MaxCatchUpMilliSeconds = 100.0f;	// of a gap between poses, the rest is skipped
+
+	// Follow and Hold
+	float Sens = 15.0f;					// counts per degree
+	float YSensMult = 0.25f;
+	float ThresholdCounts = 10.0f;		// Follow: steps smaller than this are dropped, per axis
+	bool HoldPitch = false;				// Hold: 3P.cpp only turned horizontally
+};
+
+//   [strategy]
+//   mode = absolute | rate | follow | hold
+//   speed.yaw = 200, speed.pitch = 50, deadzone = 20, maxspeed = 10000     (rate)
+//   step = 1, catchup = 100                                                  (rate, milliseconds)
+//   sens = 15, ysensmult = 0.25                                              (follow, hold)
+//   threshold = 10                                                           (follow)
+//   pitch = on | off                                                         (hold)
+// Returns false for an unknown key or a bad value.
+bool ParseStrategyEntry(const std::string& key, const std::string& value, StrategySettings& settings);
+
+const char* GetStrategyName(MappingStrategyKind kind);
@@ -0,0 +1,303 @@
+// Parameter sweep over the SquadTuning.h constants (ParameterSweep.h): maps one recorded session with every
+// candidate of a grid or a random search, on a work-stealing thread pool, and ranks the candidates by
+// emitted events, counts emitted while the head is at rest and tracking error on deliberate turns.
+// Build it instead of MyNewMain.cpp, e.g. on Linux:
+//   g++ -std=c++20 -O2 -fpermissive -Ivendor/tobii/include src/SweepMain.cpp src/ParameterSweep.cpp src/WorkStealingPool.cpp
+//       src/SessionAnalytics.cpp src/SessionArchive.cpp src/MappingEngine.cpp src/RateIntegrator.cpp src/StrategySettings.cpp
+//       src/HeadMouseMapping.cpp src/MappingKernel.cpp src/ResponseCurve.cpp src/HeadPoseFilter.cpp src/OfflineApi.cpp
+//       src/SessionRecording.cpp src/SyntheticApi.cpp -o sweep
+// Usage: sweep <session file | archive | synthetic:<settings>> [options]
+// --grid <space> sets the ranges, e.g. sens=20:40:5,deadyaw=2:10:9 (see ParseSweepSpace()), every other
+// constant stays at its SquadTuning.h value. --random <n> draws n candidates from the ranges instead of the
+// grid, --seed <n> makes that repeatable.
+// --rank score|events|rest|turns orders the report; score weighs each objective against the current
+// SquadTuning.h values, --weights <events>,<rest>,<turns> (1,1,1 by default). --top <n> rows are shown.
+// --filter <chain> and --rest <degrees>@<seconds> as in AnalyticsMain; --turn <degrees per second>@<degrees>
+// sets what counts as a deliberate turn. --threads <n> limits the pool, all cores by default.
+#include "Clock.h"
+#include "ParameterSweep.h"
+#include "SquadTuning.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TobiiGameIntegration;
+
+static constexpr int k_objectiveCount = 3;
+
+enum class SweepRank
+{
+	Score,
+	Events,
+	Rest,
+	Turns
+};
+
+struct CandidateResult
+{
+	double Objectives[k_objectiveCount] = {};	// events per minute, rest counts per minute, turn error degrees
+	double Score = 0.0;
+	bool IsParetoOptimal = false;
+};
+
+// Every candidate that no other candidate beats on one objective without losing on another. Candidates
+// are taken in order of the first objective, so only the front found so far can dominate the next one.
+static void MarkParetoFront(std::vector<CandidateResult>& results)
+{
+	std::vector<size_t> order(results.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+	{
+		const CandidateResult& left = results[a];
+		const CandidateResult& right = results[b];
+		return std::lexicographical_compare(left.Objectives, left.Objectives + k_objectiveCount, right.Objectives, right.Objectives + k_objectiveCount);
+	});
+	std::vector<size_t> front;
+	for (size_t index : order)
+	{
+		const CandidateResult& candidate = results[index];
+		const bool isDominated = std::any_of(front.begin(), front.end(), [&](size_t member)
+		{
+			bool isBetterSomewhere = false;
+			for (int objective = 0; objective < k_objectiveCount; objective++)
+			{
+				if (results[member].Objectives[objective] > candidate.Objectives[objective])
+				{
+					return false;
+				}
+				isBetterSomewhere = isBetterSomewhere || results[member].Objectives[objective] < candidate.Objectives[objective];
+			}
+			return isBetterSomewhere;
+		});
+		if (!isDominated)
+		{
+			results[index].IsParetoOptimal = true;
+			front.push_back(index);
+		}
+	}
+}
+
+// Checks the sweep's mapping against HeadMouseMapper itself for one candidate
+static bool MatchesMapper(const SweepSession& session, const MappingSettings& settings, const SweepScore& score)
+{
+	std::vector<HeadPose> headPoses(session.Poses.Size());
+	for (size_t i = 0; i < headPoses.size(); i++)
+	{
+		headPoses[i].Rotation.YawDegrees = session.Poses.Yaw[i];
+		headPoses[i].Rotation.PitchDegrees = session.Poses.Pitch[i];
+		headPoses[i].TimeStampMicroSeconds = session.Poses.TimeStampMicroSeconds[i];
+	}
+	if (headPoses.empty())
+	{
+		return score.MouseEvents == 0;
+	}
+	HeadMouseMapper mapper{ settings };
+	mapper.ResyncHeadPose(headPoses[0]);
+	std::vector<MouseDelta> deltas(headPoses.size());
+	const int count = mapper.MapHeadPoses(headPoses.data(), static_cast<int>(headPoses.size()), deltas.data());
+	return static_cast<uint64_t>(count) == score.MouseEvents;
+}
+
+static void PrintCandidate(const char* label, const MappingSettings& settings, const CandidateResult& result)
+{
+	std::cout << std::left << std::setw(8) << label << std::right << std::fixed << std::setprecision(2) << std::setw(7) << settings.Sens <<
+		std::setw(6) << settings.YSensMult << std::setw(8) << settings.DeadYawIRL << std::setw(8) << settings.DeadPitchIRL <<
+		std::setw(8) << settings.MaxYawIRL << std::setw(8) << settings.MaxPitchIRL << std::setprecision(1) <<
+		std::setw(12) << result.Objectives[0] << std::setw(12) << result.Objectives[1] << std::setprecision(3) << std::setw(11) << result.Objectives[2] <<
+		std::setw(8) << result.Score << (result.IsParetoOptimal ? "  *" : "") << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: " << argv[0] << " <session file | archive | synthetic:<settings>> [--grid <space>] [--random <n>] [--seed <n>] [--rank score|events|rest|turns] [--weights <e>,<r>,<t>] [--top <n>] [--filter <chain>] [--rest <degrees>@<seconds>] [--turn <deg/s>@<degrees>] [--threads <n>]" << std::endl;
+		return 1;
+	}
+	const std::string source{ argv[1] };
+	SweepSpace space;
+	int randomCount = 0;
+	uint32_t seed = 1;
+	SweepRank rank = SweepRank::Score;
+	double weights[k_objectiveCount] = { 1.0, 1.0, 1.0 };
+	int top = 20;
+	HeadPoseFilter filter;
+	AnalyticsSettings restSettings;
+	TurnSettings turnSettings;
+	int threadCount = static_cast<int>((std::max)(std::thread::hardware_concurrency(), 1u));
+	for (int i = 2; i < argc; i++)
+	{
+		const std::string arg{ argv[i] };
+		std::string error;
+		if (arg == "--grid" && i + 1 < argc)
+		{
+			if (!ParseSweepSpace(argv[++i], space, error))
+			{
+				std::cout << error << std::endl;
+				return 1;
+			}
+		}
+		else if (arg == "--random" && i + 1 < argc)
+		{
+			randomCount = (std::max)(std::atoi(argv[++i]), 0);
+		}
+		else if (arg == "--seed" && i + 1 < argc)
+		{
+			seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--rank" && i + 1 < argc)
+		{
+			const std::string mode{ argv[++i] };
+			rank = mode == "events" ? SweepRank::Events : mode == "rest" ? SweepRank::Rest : mode == "turns" ? SweepRank::Turns : SweepRank::Score;
+		}
+		else if (arg == "--weights" && i + 1 < argc &&
+			std::sscanf(argv[++i], "%lf,%lf,%lf", &weights[0], &weights[1], &weights[2]) != k_objectiveCount)
+		{
+			std::cout << "Invalid --weights " << argv[i] << std::endl;
+			return 1;
+		}
+		else if (arg == "--top" && i + 1 < argc)
+		{
+			top = (std::max)(std::atoi(argv[++i]), 1);
+		}
+		else if (arg == "--filter" && i + 1 < argc)
+		{
+			if (!ParseFilterChain(argv[++i], filter, error))
+			{
+				std::cout << error << std::endl;
+				return 1;
+			}
+		}
+		else if (arg == "--rest" && i + 1 < argc &&
+			(std::sscanf(argv[++i], "%f@%f", &restSettings.RestRangeDegrees, &restSettings.RestWindowSeconds) != 2 ||
+			restSettings.RestRangeDegrees <= 0.0f || restSettings.RestWindowSeconds <= 0.0f))
+		{
+			std::cout << "Invalid --rest " << argv[i] << std::endl;
+			return 1;
+		}
+		else if (arg == "--turn" && i + 1 < argc &&
+			std::sscanf(argv[++i], "%f@%f", &turnSettings.MinSpeedDegreesPerSecond, &turnSettings.MinDegrees) != 2)
+		{
+			std::cout << "Invalid --turn " << argv[i] << std::endl;
+			return 1;
+		}
+		else if (arg == "--threads" && i + 1 < argc)
+		{
+			threadCount = (std::max)(std::atoi(argv[++i]), 1);
+		}
+	}
+
+	std::vector<HeadPose> headPoses;
+	std::string error;
+	if (!LoadSessionHeadPoses(source, headPoses, error))
+	{
+		std::cout << error << std::endl;
+		return 1;
+	}
+	int64_t begin = NowNanoSeconds();
+	SweepSession session;
+	PrepareSweepSession(headPoses, restSettings, turnSettings, filter, session);
+	const double prepareSeconds = (NowNanoSeconds() - begin) / 1e9;
+	std::cout << std::fixed << std::setprecision(1) << session.Poses.Size() << " head poses over " << session.Seconds / 60.0 << " min: at rest " <<
+		session.RestSeconds << " s, " << session.TurnCount << " turns over " << session.TurnSeconds << " s (prepared in " <<
+		std::setprecision(2) << prepareSeconds << " s)" << std::endl;
+
+	// The current constants first, as the reference for the score
+	ExtendedViewSettings extendedViewSettings;
+	MappingSettings baseSettings = SquadMappingSettings();
+	baseSettings.HeadPoseYawScale = extendedViewSettings.HeadTracking.YawRightDegrees.SensitivityScaling;
+	baseSettings.HeadPosePitchScale = extendedViewSettings.HeadTracking.PitchUpDegrees.SensitivityScaling;
+	std::vector<MappingSettings> candidates{ baseSettings };
+	if (randomCount > 0)
+	{
+		std::mt19937 random{ seed };
+		GetRandomCandidates(space, baseSettings, randomCount, random, candidates);
+	}
+	else
+	{
+		if (GetGridSize(space) > 10'000'000)
+		{
+			std::cout << "The grid has " << GetGridSize(space) << " candidates, use fewer steps or --random" << std::endl;
+			return 1;
+		}
+		GetGridCandidates(space, baseSettings, candidates);
+	}
+
+	const SimdLevel level = GetSupportedSimdLevel();
+	std::vector<SweepScore> scores(candidates.size());
+	WorkStealingPool pool{ threadCount };
+	begin = NowNanoSeconds();
+	// One task per group of candidates that share a pass over the session
+	const uint32_t groups = static_cast<uint32_t>((candidates.size() + k_candidatesPerPass - 1) / k_candidatesPerPass);
+	pool.ParallelFor(groups, [&](uint32_t group, int)
+	{
+		const size_t first = static_cast<size_t>(group) * k_candidatesPerPass;
+		const int count = static_cast<int>((std::min)(candidates.size() - first, static_cast<size_t>(k_candidatesPerPass)));
+		EvaluateCandidates(session, &candidates[first], count, &scores[first], level);
+	});
+	const double sweepSeconds = (NowNanoSeconds() - begin) / 1e9;
+	std::cout << candidates.size() << " candidates in " << sweepSeconds << " s on " << pool.GetThreadCount() << " threads (" <<
+		GetSimdLevelName(level) << ", " << std::setprecision(0) << (sweepSeconds > 0.0 ? candidates.size() * session.Poses.Size() / sweepSeconds / 1e6 : 0.0) <<
+		" M poses/s, " << pool.GetSteals() << " steals)" << std::endl;
+
+	std::vector<CandidateResult> results(candidates.size());
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		results[i].Objectives[0] = scores[i].GetEventsPerMinute(session);
+		results[i].Objectives[1] = scores[i].GetRestCountsPerMinute(session);
+		results[i].Objectives[2] = scores[i].GetTurnErrorDegrees();
+	}
+	for (CandidateResult& result : results)
+	{
+		for (int objective = 0; objective < k_objectiveCount; objective++)
+		{
+			// Relative to the current constants, or in the objective's own units where they score 0
+			const double reference = results[0].Objectives[objective];
+			result.Score += weights[objective] * result.Objectives[objective] / (reference > 0.0 ? reference : 1.0);
+		}
+	}
+	MarkParetoFront(results);
+
+	std::vector<size_t> order(results.size() - 1);
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		order[i] = i + 1;
+	}
+	const auto rankValue = [&](size_t index)
+	{
+		return rank == SweepRank::Score ? results[index].Score : results[index].Objectives[static_cast<int>(rank) - 1];
+	};
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return rankValue(a) < rankValue(b); });
+
+	std::cout << std::endl << "            sens ysens deadyaw deadpitch maxyaw maxpitch  events/min  rest c/min  turn err   score" << std::endl;
+	PrintCandidate("current", candidates[0], results[0]);
+	for (size_t i = 0; i < order.size() && i < static_cast<size_t>(top); i++)
+	{
+		PrintCandidate(("#" + std::to_string(i + 1)).c_str(), candidates[order[i]], results[order[i]]);
+	}
+	std::cout << "(* on the Pareto front, " << std::count_if(results.begin(), results.end(), [](const CandidateResult& result) { return result.IsParetoOptimal; }) <<
+		" candidates; turn err in degrees RMS)" << std::endl;
+
+	if (!order.empty())
+	{
+		const MappingSettings& best = candidates[order[0]];
+		if (!MatchesMapper(session, best, scores[order[0]]))
+		{
+			std::cout << "The sweep's mapping doesn't match HeadMouseMapper for #1" << std::endl;
+			return 1;
+		}
+		std::cout << std::endl << std::setprecision(2) << "#1 in SquadTuning.h: k_sens = " << best.Sens << "f, k_ySensMult = " << best.YSensMult <<
+			"f, k_deadYawIRL = " << best.DeadYawIRL << "f, k_deadPitchIRL = " << best.DeadPitchIRL << "f, k_maxYawIRL = " << best.MaxYawIRL <<
+			"f, k_maxPitchIRL = " << best.MaxPitchIRL << "f" << std::endl;
+	}
+	return 0;
+}
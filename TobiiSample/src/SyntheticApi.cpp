@@ -0,0 +1,222 @@
+#include "SyntheticApi.h"
+#include "Clock.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using namespace TobiiGameIntegration;
+
+static constexpr double k_pi = 3.14159265358979323846;
+
+static bool ParsePair(const std::string& value, float& first, float& second)
+{
+	const size_t at = value.find('@');
+	if (at == std::string::npos)
+	{
+		return false;
+	}
+	try
+	{
+		first = std::stof(value.substr(0, at));
+		second = std::stof(value.substr(at + 1));
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+	return true;
+}
+
+static bool ParseAxisEntry(const std::string& key, const std::string& value, SyntheticAxisMotion& motion)
+{
+	try
+	{
+		if (key == "sine")
+		{
+			return ParsePair(value, motion.SineAmplitudeDegrees, motion.SineFrequencyHz);
+		}
+		if (key == "step")
+		{
+			return ParsePair(value, motion.StepDegrees, motion.StepIntervalSeconds);
+		}
+		if (key == "jitter")
+		{
+			motion.JitterStdDevDegrees = std::stof(value);
+			return true;
+		}
+	}
+	catch (const std::exception&)
+	{
+	}
+	return false;
+}
+
+bool ParseSyntheticSettings(const std::string& spec, SyntheticSettings& settings, std::string& error)
+{
+	std::istringstream entries{ spec };
+	std::string entry;
+	while (std::getline(entries, entry, ','))
+	{
+		if (entry.empty())
+		{
+			continue;
+		}
+
+		const size_t equals = entry.find('=');
+		const std::string key = entry.substr(0, equals);
+		const std::string value = equals == std::string::npos ? "" : entry.substr(equals + 1);
+		const size_t dot = key.find('.');
+
+		bool ok = false;
+		if (dot != std::string::npos)
+		{
+			const std::string axis = key.substr(0, dot);
+			SyntheticAxisMotion* motion = axis == "yaw" ? &settings.Yaw : axis == "pitch" ? &settings.Pitch : axis == "roll" ? &settings.Roll : nullptr;
+			ok = motion != nullptr && ParseAxisEntry(key.substr(dot + 1), value, *motion);
+		}
+		else if (key == "dropout")
+		{
+			ok = ParsePair(value, settings.DropoutsPerSecond, settings.DropoutSeconds);
+		}
+		else
+		{
+			try
+			{
+				if (key == "rate")
+				{
+					settings.RateHz = std::stof(value);
+					ok = settings.RateHz > 0.0f;
+				}
+				else if (key == "fast")
+				{
+					settings.SamplesPerUpdate = std::stoi(value);
+					ok = settings.SamplesPerUpdate >= 0;
+				}
+				else if (key == "duration")
+				{
+					settings.DurationSeconds = std::stof(value);
+					ok = true;
+				}
+				else if (key == "seed")
+				{
+					settings.Seed = static_cast<uint32_t>(std::stoul(value));
+					ok = true;
+				}
+			}
+			catch (const std::exception&)
+			{
+			}
+		}
+
+		if (!ok)
+		{
+			error = "bad synthetic setting '" + entry + "'";
+			return false;
+		}
+	}
+	return true;
+}
+
+SyntheticApi::SyntheticApi(const SyntheticSettings& settings)
+	: OfflineApi("synthetic"), m_settings{ settings }, m_random{ settings.Seed },
+	m_samplePeriodMicroSeconds{ 1e6 / settings.RateHz }
+{
+	SetPresent(true);
+}
+
+void SyntheticApi::Update()
+{
+	BeginFrame();
+	if (m_isFinished)
+	{
+		return;
+	}
+
+	const int64_t now = NowMicroSeconds();
+	if (m_startMicroSeconds < 0)
+	{
+		m_startMicroSeconds = now;
+	}
+
+	int64_t generateUntil;
+	if (m_settings.SamplesPerUpdate > 0)
+	{
+		generateUntil = static_cast<int64_t>((m_sampleIndex + m_settings.SamplesPerUpdate - 1) * m_samplePeriodMicroSeconds);
+	}
+	else
+	{
+		// Don't try to catch up on more than a second of samples after a stall
+		generateUntil = now - m_startMicroSeconds;
+		const uint64_t maxBacklog = static_cast<uint64_t>(std::ceil(m_settings.RateHz));
+		const uint64_t due = static_cast<uint64_t>(generateUntil / m_samplePeriodMicroSeconds) + 1;
+		if (due > m_sampleIndex + maxBacklog)
+		{
+			m_sampleIndex = due - maxBacklog;
+		}
+	}
+
+	const int64_t durationMicroSeconds = static_cast<int64_t>(m_settings.DurationSeconds * 1e6);
+	while (true)
+	{
+		const int64_t sampleMicroSeconds = static_cast<int64_t>(m_sampleIndex * m_samplePeriodMicroSeconds);
+		if (sampleMicroSeconds > generateUntil)
+		{
+			break;
+		}
+		if (durationMicroSeconds > 0 && sampleMicroSeconds >= durationMicroSeconds)
+		{
+			m_isFinished = true;
+			break;
+		}
+		GenerateSample(sampleMicroSeconds);
+		m_sampleIndex++;
+	}
+}
+
+float SyntheticApi::Evaluate(const SyntheticAxisMotion& motion, double seconds)
+{
+	double value = motion.SineAmplitudeDegrees * std::sin(2.0 * k_pi * motion.SineFrequencyHz * seconds);
+	if (motion.StepIntervalSeconds > 0.0f)
+	{
+		const int64_t step = static_cast<int64_t>(seconds / motion.StepIntervalSeconds);
+		value += (step % 2 == 0) ? motion.StepDegrees : -motion.StepDegrees;
+	}
+	if (motion.JitterStdDevDegrees > 0.0f)
+	{
+		value += motion.JitterStdDevDegrees * m_normal(m_random);
+	}
+	return static_cast<float>(value);
+}
+
+void SyntheticApi::GenerateSample(int64_t sampleMicroSeconds)
+{
+	if (m_settings.DropoutsPerSecond > 0.0f && sampleMicroSeconds >= m_dropoutEndMicroSeconds &&
+		m_uniform(m_random) < m_settings.DropoutsPerSecond / m_settings.RateHz)
+	{
+		m_dropoutEndMicroSeconds = sampleMicroSeconds + static_cast<int64_t>(m_settings.DropoutSeconds * 1e6);
+	}
+	const bool isPresent = sampleMicroSeconds >= m_dropoutEndMicroSeconds;
+	SetPresent(isPresent);
+	if (!isPresent)
+	{
+		return;
+	}
+
+	const double seconds = sampleMicroSeconds * 1e-6;
+	HeadPose headPose;
+	headPose.TimeStampMicroSeconds = m_startMicroSeconds + sampleMicroSeconds;
+	headPose.Rotation.YawDegrees = Evaluate(m_settings.Yaw, seconds);
+	headPose.Rotation.PitchDegrees = Evaluate(m_settings.Pitch, seconds);
+	headPose.Rotation.RollDegrees = Evaluate(m_settings.Roll, seconds);
+	headPose.Position.Z = 600.0f;
+	AddHeadPose(headPose);
+
+	// Gaze follows the head across a +-45 x +-30 degree screen
+	GazePoint gazePoint;
+	gazePoint.TimeStampMicroSeconds = headPose.TimeStampMicroSeconds;
+	gazePoint.X = std::clamp(headPose.Rotation.YawDegrees / 45.0f, -1.0f, 1.0f);
+	gazePoint.Y = std::clamp(headPose.Rotation.PitchDegrees / 30.0f, -1.0f, 1.0f);
+	AddGazePoint(gazePoint);
+
+	m_samplesGenerated++;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "OfflineApi.h"
+#include <cstdint>
+#include <random>
+#include <string>
+
+// Motion model for one rotation axis, all terms are summed.
+struct SyntheticAxisMotion
+{
+	float SineAmplitudeDegrees = 0.0f;
+	float SineFrequencyHz = 0.0f;
+	float StepDegrees = 0.0f;			// alternates between +StepDegrees and -StepDegrees
+	float StepIntervalSeconds = 0.0f;
+	float JitterStdDevDegrees = 0.0f;	// Gaussian noise added to every sample
+};
+
+struct SyntheticSettings
+{
+	float RateHz = 90.0f;
+	// 0: samples follow the wall clock. >0: every Update() produces this many samples on a virtual clock.
+	int SamplesPerUpdate = 0;
+	// 0: endless, otherwise IsFinished() after this many seconds of samples
+	float DurationSeconds = 0.0f;
+	// chance per second of losing the user for DropoutSeconds (no samples, not present)
+	float DropoutsPerSecond = 0.0f;
+	float DropoutSeconds = 0.0f;
+	uint32_t Seed = 1;
+
+	SyntheticAxisMotion Yaw{ 20.0f, 0.25f, 0.0f, 0.0f, 0.05f };
+	SyntheticAxisMotion Pitch{ 5.0f, 0.1f, 0.0f, 0.0f, 0.05f };
+	SyntheticAxisMotion Roll;
+};
+
+// Parses "key=value,key=value" where keys are rate, fast (samples per Update), duration, seed,
+// dropout=<per second>@<seconds> and, per axis (yaw, pitch, roll):
+// <axis>.sine=<degrees>@<Hz>, <axis>.step=<degrees>@<seconds>, <axis>.jitter=<std dev degrees>.
+// Returns false and names the offending entry in error.
+bool ParseSyntheticSettings(const std::string& spec, SyntheticSettings& settings, std::string& error);
+
+// Generates head poses, gaze points and presence from SyntheticSettings at any rate,
+// for stress tests far beyond what a tracker produces.
+class SyntheticApi : public OfflineApi
+{
+public:
+	explicit SyntheticApi(const SyntheticSettings& settings);
+
+	void Update() override;
+	bool IsFinished() const override { return m_isFinished; }
+
+	uint64_t GetSamplesGenerated() const { return m_samplesGenerated; }
+
+private:
+	void GenerateSample(int64_t sampleMicroSeconds);
+	float Evaluate(const SyntheticAxisMotion& motion, double seconds);
+
+	SyntheticSettings m_settings;
+	std::mt19937 m_random;
+	std::normal_distribution<float> m_normal{ 0.0f, 1.0f };
+	std::uniform_real_distribution<float> m_uniform{ 0.0f, 1.0f };
+
+	int64_t m_startMicroSeconds = -1;
+	int64_t m_nextSampleMicroSeconds = 0;	// relative to m_startMicroSeconds
+	double m_samplePeriodMicroSeconds;
+	uint64_t m_sampleIndex = 0;
+	uint64_t m_samplesGenerated = 0;
+	int64_t m_dropoutEndMicroSeconds = -1;
+	bool m_isFinished = false;
+};
@@ -0,0 +1,116 @@
+#include "Telemetry.h"
+#include "PacedScheduler.h"
+#include "Trace.h"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include "windows.h"
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+void RenderTelemetry(std::ostream& out, const TelemetrySnapshot& snapshot)
+{
+	const TobiiGameIntegration::Transformation& trans = snapshot.Pose;
+	out << std::fixed << std::setprecision(1);
+	out << "Head Rot(deg) [Y: " << trans.Rotation.YawDegrees << ",P: " << trans.Rotation.PitchDegrees << ",R: " << trans.Rotation.RollDegrees << "] " <<
+		"Pos(mm) [X: " << trans.Position.X << ",Y: " << trans.Position.Y << ",Z: " << trans.Position.Z << "] " <<
+		"Out [X: " << std::setprecision(0) << snapshot.ActualYaw << ",Y: " << snapshot.ActualPitch << "] Deltas: " << snapshot.DeltasEmitted <<
+		" Queue: " << snapshot.QueueDepth << (snapshot.OutputActive ? "" : " (cursor visible)") << "          \r";
+}
+
+TelemetryRenderer::TelemetryRenderer(int rateHz)
+	: m_rateHz{ rateHz }
+{ }
+
+TelemetryRenderer::~TelemetryRenderer()
+{
+	Stop();
+}
+
+void TelemetryRenderer::Start()
+{
+	if (m_rateHz <= 0 || m_running)
+	{
+		return;
+	}
+	m_running = true;
+	m_thread = std::thread{ &TelemetryRenderer::Run, this };
+}
+
+void TelemetryRenderer::Stop()
+{
+	m_running = false;
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+void TelemetryRenderer::Publish(const TelemetrySnapshot& snapshot)
+{
+	if (m_rateHz > 0)
+	{
+		m_slot.Store(snapshot);
+	}
+	else if (m_rateHz == k_inline)
+	{
+		TRACE_ZONE("RenderTelemetry");
+		RenderTelemetry(std::cout, snapshot);
+		m_renderedCount.store(m_renderedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+}
+
+void TelemetryRenderer::Run()
+{
+#ifdef _WIN32
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__)
+	setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), 10);
+#endif
+
+	TRACE_THREAD("telemetry");
+	PacedScheduler pacing{ static_cast<double>(m_rateHz) };
+	uint32_t renderedSequence = 0;
+	TelemetrySnapshot snapshot;
+	while (m_running.load(std::memory_order_relaxed))
+	{
+		pacing.WaitForNextTick();
+		if (m_slot.GetSequence() == renderedSequence)
+		{
+			continue;
+		}
+		renderedSequence = m_slot.Load(snapshot);
+		TRACE_ZONE("RenderTelemetry");
+		RenderTelemetry(std::cout, snapshot);
+		std::cout.flush();
+		m_renderedCount.store(m_renderedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+}
+
+bool ParseTelemetryRate(const char* text, int& rateHz)
+{
+	const std::string value{ text };
+	if (value == "off")
+	{
+		rateHz = TelemetryRenderer::k_headless;
+		return true;
+	}
+	if (value == "inline")
+	{
+		rateHz = TelemetryRenderer::k_inline;
+		return true;
+	}
+	char* end = nullptr;
+	const long rate = std::strtol(value.c_str(), &end, 10);
+	if (end == value.c_str() || *end != '\0' || rate < 0 || rate > 1000)
+	{
+		return false;
+	}
+	rateHz = static_cast<int>(rate);
+	return true;
+}
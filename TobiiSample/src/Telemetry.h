@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Seqlock.h"
+#include "TobiiPlatform.h"
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+
+// What the mapping loop shows on the console, published once per batch.
+struct TelemetrySnapshot
+{
+	TobiiGameIntegration::Transformation Pose;		// latest raw head pose (the Extended View transform without USE_HEAD_POSE_BATCH), before prediction
+	int64_t PoseTimeStampMicroSeconds = 0;
+	uint32_t QueueDepth = 0;
+	bool OutputActive = false;						// false while the cursor is visible
+	float ActualYaw = 0.0f;							// cursor offset emitted so far, in counts
+	float ActualPitch = 0.0f;
+	uint64_t DeltasEmitted = 0;
+};
+
+// The status line, ending in \r so it overwrites itself.
+void RenderTelemetry(std::ostream& out, const TelemetrySnapshot& snapshot);
+
+// Publish() is cheap enough for the hot loop: it only stores the snapshot in a seqlock slot.
+// A low-priority thread renders the latest snapshot at RateHz and skips unchanged ones.
+//   rateHz > 0         asynchronous rendering
+//   k_headless (0)     no console output at all
+//   k_inline (-1)      render inside Publish(), the old behaviour, kept to measure what it costs
+class TelemetryRenderer
+{
+public:
+	static constexpr int k_headless = 0;
+	static constexpr int k_inline = -1;
+
+	explicit TelemetryRenderer(int rateHz);
+	~TelemetryRenderer();
+
+	void Start();
+	void Stop();
+
+	void Publish(const TelemetrySnapshot& snapshot);
+
+	int GetRateHz() const { return m_rateHz; }
+	uint64_t GetRenderedCount() const { return m_renderedCount.load(std::memory_order_relaxed); }
+
+private:
+	void Run();
+
+	int m_rateHz;
+	Seqlock<TelemetrySnapshot> m_slot;
+	std::thread m_thread;
+	std::atomic<bool> m_running{ false };
+	std::atomic<uint64_t> m_renderedCount{ 0 };
+};
+
+// "off" or "0" -> k_headless, "inline" -> k_inline, otherwise a rate in Hz. Returns false if invalid.
+bool ParseTelemetryRate(const char* text, int& rateHz);
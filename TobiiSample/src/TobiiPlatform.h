@@ -0,0 +1,10 @@
+#pragma once
+
+// Include this instead of tobii_gameintegration.h in code that must also build without the
+// Windows SDK (offline backends, replay and analysis tools).
+// Note: GCC rejects the `Rotation Rotation;` members in the Tobii header unless -fpermissive is given.
+#if !defined(_WIN32) && !defined(__cdecl)
+#define __cdecl
+#endif
+
+#include "tobii_gameintegration.h"
@@ -0,0 +1,170 @@
+#include "Trace.h"
+
+#if ENABLE_TRACING
+#include "Clock.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+static_assert((k_traceRingEvents & (k_traceRingEvents - 1)) == 0, "the ring index is masked");
+
+namespace
+{
+	// Relaxed atomic words rather than a plain struct, so a dump overlapping a write is not a data race
+	struct TraceSlot
+	{
+		std::atomic<uintptr_t> Name;
+		std::atomic<uint64_t> StartTicks;
+		std::atomic<uint64_t> EndTicks;
+	};
+
+	// Written by its own thread only. Begun runs ahead of Written while a slot is being filled, so a dump
+	// can tell which of the slots it copied may have been overwritten meanwhile.
+	struct TraceRing
+	{
+		std::string ThreadName;			// under the registry mutex
+		int ThreadId = 0;
+		std::atomic<uint64_t> Begun{ 0 };
+		std::atomic<uint64_t> Written{ 0 };
+		std::unique_ptr<TraceSlot[]> Slots = std::make_unique<TraceSlot[]>(k_traceRingEvents);
+	};
+
+	struct TraceRegistry
+	{
+		std::mutex Mutex;
+		std::vector<std::unique_ptr<TraceRing>> Rings;	// never freed, so a dump still sees threads that ended
+		// Pairs a trace clock reading with the steady clock, to convert ticks when writing
+		const uint64_t OriginTicks = ReadTraceClock();
+		const int64_t OriginNanoSeconds = NowNanoSeconds();
+	};
+
+	TraceRegistry& GetRegistry()
+	{
+		static TraceRegistry registry;
+		return registry;
+	}
+
+	thread_local TraceRing* t_ring = nullptr;
+
+	TraceRing* RegisterThread()
+	{
+		TraceRegistry& registry = GetRegistry();
+		auto ring = std::make_unique<TraceRing>();
+		std::lock_guard<std::mutex> lock{ registry.Mutex };
+		ring->ThreadId = static_cast<int>(registry.Rings.size()) + 1;
+		ring->ThreadName = "thread " + std::to_string(ring->ThreadId);
+		t_ring = ring.get();
+		registry.Rings.push_back(std::move(ring));
+		return t_ring;
+	}
+}
+
+void RecordTraceZone(const char* name, uint64_t startTicks, uint64_t endTicks)
+{
+	TraceRing* ring = t_ring != nullptr ? t_ring : RegisterThread();
+	const uint64_t index = ring->Written.load(std::memory_order_relaxed);
+	ring->Begun.store(index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	TraceSlot& slot = ring->Slots[index & (k_traceRingEvents - 1)];
+	slot.Name.store(reinterpret_cast<uintptr_t>(name), std::memory_order_relaxed);
+	slot.StartTicks.store(startTicks, std::memory_order_relaxed);
+	slot.EndTicks.store(endTicks, std::memory_order_relaxed);
+	ring->Written.store(index + 1, std::memory_order_release);
+}
+
+void SetTraceThreadName(const char* name)
+{
+	TraceRing* ring = t_ring != nullptr ? t_ring : RegisterThread();
+	std::lock_guard<std::mutex> lock{ GetRegistry().Mutex };
+	ring->ThreadName = name;
+}
+
+struct CopiedZone
+{
+	const char* Name;
+	uint64_t StartTicks;
+	uint64_t EndTicks;
+};
+
+static void CopyZones(const TraceRing& ring, std::vector<CopiedZone>& zones)
+{
+	zones.clear();
+	const uint64_t written = ring.Written.load(std::memory_order_acquire);
+	const uint64_t first = written > k_traceRingEvents ? written - k_traceRingEvents : 0;
+	for (uint64_t index = first; index < written; index++)
+	{
+		const TraceSlot& slot = ring.Slots[index & (k_traceRingEvents - 1)];
+		zones.push_back({ reinterpret_cast<const char*>(slot.Name.load(std::memory_order_relaxed)),
+			slot.StartTicks.load(std::memory_order_relaxed), slot.EndTicks.load(std::memory_order_relaxed) });
+	}
+	// The writer may have lapped the oldest slots while they were copied
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const uint64_t begun = ring.Begun.load(std::memory_order_relaxed);
+	if (begun > first + k_traceRingEvents)
+	{
+		const uint64_t overwritten = (std::min)(begun - first - k_traceRingEvents, static_cast<uint64_t>(zones.size()));
+		zones.erase(zones.begin(), zones.begin() + static_cast<ptrdiff_t>(overwritten));
+	}
+}
+
+bool WriteChromeTrace(const char* path, double seconds, std::string& error)
+{
+	std::ofstream file{ path, std::ios::trunc };
+	if (!file)
+	{
+		error = std::string{ "can't create " } + path;
+		return false;
+	}
+
+	TraceRegistry& registry = GetRegistry();
+	const uint64_t nowTicks = ReadTraceClock();
+	const int64_t nowNanoSeconds = NowNanoSeconds();
+	const double nanoSecondsPerTick = nowTicks > registry.OriginTicks ?
+		static_cast<double>(nowNanoSeconds - registry.OriginNanoSeconds) / static_cast<double>(nowTicks - registry.OriginTicks) : 1.0;
+	const double windowTicks = seconds * 1e9 / nanoSecondsPerTick;
+	const uint64_t cutoffTicks = seconds > 0.0 && windowTicks < static_cast<double>(nowTicks) ? nowTicks - static_cast<uint64_t>(windowTicks) : 0;
+	const auto toMicroSeconds = [&](uint64_t ticks)
+	{
+		return static_cast<double>(static_cast<int64_t>(ticks - registry.OriginTicks)) * nanoSecondsPerTick * 1e-3;
+	};
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+	file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"TobiiSample\"}}";
+	std::vector<CopiedZone> zones;
+	zones.reserve(k_traceRingEvents);
+	std::lock_guard<std::mutex> lock{ registry.Mutex };
+	for (const std::unique_ptr<TraceRing>& ring : registry.Rings)
+	{
+		file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->ThreadId << ",\"args\":{\"name\":\"" << ring->ThreadName << "\"}}";
+		CopyZones(*ring, zones);
+		for (const CopiedZone& zone : zones)
+		{
+			if (zone.EndTicks < cutoffTicks)
+			{
+				continue;
+			}
+			file << ",\n{\"name\":\"" << zone.Name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->ThreadId <<
+				",\"ts\":" << toMicroSeconds(zone.StartTicks) << ",\"dur\":" << toMicroSeconds(zone.EndTicks) - toMicroSeconds(zone.StartTicks) << "}";
+		}
+	}
+	file << "\n]}\n";
+	if (!file)
+	{
+		error = std::string{ "can't write " } + path;
+		return false;
+	}
+	return true;
+}
+#else
+bool WriteChromeTrace(const char*, double, std::string& error)
+{
+	error = "tracing is compiled out, build with ENABLE_TRACING 1 (see Trace.h)";
+	return false;
+}
+#endif
@@ -0,0 +1,70 @@
+#pragma once
+
+// Scoped tracing zones for the hot paths, to see how an iteration splits between Update(), mapping,
+// output and console rendering when players report stutter. Off by default: with ENABLE_TRACING 0 the
+// macros expand to nothing and no trace code is compiled into the loops. Set it to 1 here, or pass
+// /DENABLE_TRACING=1 (-DENABLE_TRACING=1), to record.
+#ifndef ENABLE_TRACING
+#define ENABLE_TRACING 0
+#endif
+
+#include <string>
+
+#if ENABLE_TRACING
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+// Invariant TSC: about 20 cycles to read, converted to the steady clock only when a trace is written
+inline uint64_t ReadTraceClock() { return __rdtsc(); }
+#else
+#include "Clock.h"
+inline uint64_t ReadTraceClock() { return static_cast<uint64_t>(NowNanoSeconds()); }
+#endif
+
+// Appends a finished zone to the calling thread's ring. Never waits; the ring is allocated when the
+// thread records its first zone or calls SetTraceThreadName(). name must be a string literal, only the
+// pointer is kept.
+void RecordTraceZone(const char* name, uint64_t startTicks, uint64_t endTicks);
+
+// Names the calling thread in the trace and allocates its ring up front, outside the hot loop.
+void SetTraceThreadName(const char* name);
+
+class TraceZone
+{
+public:
+	explicit TraceZone(const char* name)
+		: m_name{ name }, m_startTicks{ ReadTraceClock() }
+	{ }
+	~TraceZone() { RecordTraceZone(m_name, m_startTicks, ReadTraceClock()); }
+
+	TraceZone(const TraceZone&) = delete;
+	TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+	const char* m_name;
+	uint64_t m_startTicks;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+// Times the rest of the enclosing scope
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__){ name }
+#define TRACE_THREAD(name) SetTraceThreadName(name)
+#else
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_THREAD(name) ((void)0)
+#endif
+
+// Events each thread keeps, the oldest are overwritten. A 1 kHz loop records around ten zones per
+// iteration, so this holds the last ten seconds or more of every thread.
+static constexpr int k_traceRingEvents = 1 << 17;
+
+// Writes the zones of every thread that ended within the last `seconds` (all of them for 0) as
+// Chrome trace JSON, for chrome://tracing or ui.perfetto.dev. Threads keep recording meanwhile; zones
+// overwritten during the copy are left out. Fails when tracing is compiled out.
+bool WriteChromeTrace(const char* path, double seconds, std::string& error);
@@ -1,4 +1,6 @@
 #include "tobii_gameintegration.h"
+#include "ApiBackend.h"
+#include "PacedScheduler.h"
 #include <iostream>
 #include "windows.h"
 #include <thread>
@@ -9,7 +11,11 @@ HWND GetConsoleHwnd(void); // See SampleHelpFunctions.cpp
 
 void TrackerInfoSample()
 {
-    ITobiiGameIntegrationApi* api = GetApi("Tracker info sample");
+    ITobiiGameIntegrationApi* api = GetBackendApi("Tracker info sample");
+    if (api == nullptr)
+    {
+        return;
+    }
 
     api->GetTrackerController()->TrackWindow(GetConsoleHwnd());
     api->GetTrackerController()->UpdateTrackerInfos();
@@ -48,6 +54,7 @@ void TrackerInfoSample()
 
     std::cout << std::endl;
     std::cout << "Current tracker connection:" << std::endl;
+    PacedScheduler frameRate{ 60.0 };
     while (!GetAsyncKeyState(VK_ESCAPE))
     {
         api->Update();
@@ -62,7 +69,7 @@ void TrackerInfoSample()
             std::cout << "None                                                                       \r";
         }
 
-        Sleep(1000 / 60);
+        frameRate.WaitForNextTick();
     }
 
     api->Shutdown();
@@ -0,0 +1,153 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+static uint64_t PackRange(uint32_t begin, uint32_t end)
+{
+	return static_cast<uint64_t>(end) << 32 | begin;
+}
+
+static uint32_t RangeBegin(uint64_t range) { return static_cast<uint32_t>(range); }
+static uint32_t RangeEnd(uint64_t range) { return static_cast<uint32_t>(range >> 32); }
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+	: m_shares((std::max)(threadCount, 1))
+{
+	for (int worker = 1; worker < GetThreadCount(); worker++)
+	{
+		m_threads.emplace_back(&WorkStealingPool::WorkerMain, this, worker);
+	}
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		m_isStopping = true;
+	}
+	m_started.notify_all();
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+void WorkStealingPool::ParallelFor(uint32_t count, const std::function<void(uint32_t, int)>& body)
+{
+	const uint32_t workers = static_cast<uint32_t>(GetThreadCount());
+	for (uint32_t worker = 0; worker < workers; worker++)
+	{
+		const uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(count) * worker / workers);
+		const uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(count) * (worker + 1) / workers);
+		m_shares[worker].Range.store(PackRange(begin, end), std::memory_order_relaxed);
+	}
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		m_body = &body;
+		m_running = static_cast<int>(m_threads.size());
+		m_generation++;
+	}
+	m_started.notify_all();
+
+	RunShare(0);
+
+	std::unique_lock<std::mutex> lock{ m_mutex };
+	m_finished.wait(lock, [&]() { return m_running == 0; });
+	m_body = nullptr;
+}
+
+void WorkStealingPool::WorkerMain(int worker)
+{
+	uint64_t generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock{ m_mutex };
+			m_started.wait(lock, [&]() { return m_isStopping || m_generation != generation; });
+			if (m_isStopping)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		RunShare(worker);
+
+		bool isLast;
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+			isLast = --m_running == 0;
+		}
+		if (isLast)
+		{
+			m_finished.notify_one();
+		}
+	}
+}
+
+void WorkStealingPool::RunShare(int worker)
+{
+	const std::function<void(uint32_t, int)>& body = *m_body;
+	do
+	{
+		uint32_t index;
+		while (TakeOwn(worker, index))
+		{
+			body(index, worker);
+		}
+	} while (Steal(worker));
+}
+
+bool WorkStealingPool::TakeOwn(int worker, uint32_t& index)
+{
+	std::atomic<uint64_t>& share = m_shares[worker].Range;
+	uint64_t range = share.load(std::memory_order_acquire);
+	while (RangeBegin(range) < RangeEnd(range))
+	{
+		if (share.compare_exchange_weak(range, PackRange(RangeBegin(range) + 1, RangeEnd(range)), std::memory_order_acq_rel))
+		{
+			index = RangeBegin(range);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool WorkStealingPool::Steal(int worker)
+{
+	// Only this thread refills its own share and it is empty now, so thieves leave it alone until the store
+	while (true)
+	{
+		int victim = -1;
+		uint32_t mostLeft = 0;
+		for (int other = 0; other < GetThreadCount(); other++)
+		{
+			const uint64_t range = m_shares[other].Range.load(std::memory_order_relaxed);
+			const uint32_t left = RangeEnd(range) > RangeBegin(range) ? RangeEnd(range) - RangeBegin(range) : 0;
+			if (other != worker && left > mostLeft)
+			{
+				victim = other;
+				mostLeft = left;
+			}
+		}
+		if (victim < 0)
+		{
+			return false;
+		}
+
+		std::atomic<uint64_t>& share = m_shares[victim].Range;
+		uint64_t range = share.load(std::memory_order_acquire);
+		const uint32_t begin = RangeBegin(range), end = RangeEnd(range);
+		if (begin >= end)
+		{
+			continue;
+		}
+		// The back half, rounded up so the last index can be taken too
+		const uint32_t middle = begin + (end - begin) / 2;
+		if (share.compare_exchange_strong(range, PackRange(begin, middle), std::memory_order_acq_rel))
+		{
+			m_shares[worker].Range.store(PackRange(middle, end), std::memory_order_release);
+			m_steals.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+}
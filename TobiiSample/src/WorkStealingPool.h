@@ -0,0 +1,60 @@
+#pragma once
+
+#include "SpscRing.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads for running loops over independent indices, e.g. the candidates of a parameter
+// sweep. Every loop starts by giving each worker an equal contiguous share of the indices. A worker takes
+// indices from the front of its own share; when that runs dry it steals the back half of the biggest
+// share left, so threads that got slower candidates or less CPU time don't hold up the rest. A share is
+// one 64-bit word (begin, end) updated by compare-and-swap from both ends: no locks and no allocation
+// per index or per steal.
+class WorkStealingPool
+{
+public:
+	// threadCount includes the thread that calls ParallelFor(), so 1 runs everything inline
+	explicit WorkStealingPool(int threadCount);
+	~WorkStealingPool();
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	int GetThreadCount() const { return static_cast<int>(m_shares.size()); }
+
+	// Calls body(index, worker) once for every index in [0, count) and returns when all calls are done.
+	// worker is in [0, GetThreadCount()), for per-worker scratch space; the calling thread is worker 0.
+	// Used from one thread at a time.
+	void ParallelFor(uint32_t count, const std::function<void(uint32_t index, int worker)>& body);
+
+	// Successful steals over the pool's lifetime
+	uint64_t GetSteals() const { return m_steals.load(std::memory_order_relaxed); }
+
+private:
+	struct alignas(k_cacheLineSize) Share
+	{
+		std::atomic<uint64_t> Range{ 0 };	// begin in the low 32 bits, end in the high 32 bits
+	};
+
+	void WorkerMain(int worker);
+	void RunShare(int worker);
+	bool TakeOwn(int worker, uint32_t& index);
+	bool Steal(int worker);
+
+	std::vector<Share> m_shares;
+	std::vector<std::thread> m_threads;
+	const std::function<void(uint32_t, int)>* m_body = nullptr;
+	std::atomic<uint64_t> m_steals{ 0 };
+
+	std::mutex m_mutex;
+	std::condition_variable m_started;
+	std::condition_variable m_finished;
+	uint64_t m_generation = 0;		// under m_mutex, one per ParallelFor()
+	int m_running = 0;				// helper threads still inside the current loop
+	bool m_isStopping = false;
+};